@@ -0,0 +1,71 @@
+#pragma once
+
+#include "common.h"
+#include "destination_registry.h"
+#include <condition_variable>
+#include <map>
+#include <mutex>
+
+namespace data_bridge {
+
+/**
+ * @brief Backpressure Monitor - Samples the socket queues of all UDP destinations
+ *
+ * A consumer that falls behind does not make sendto() fail: datagrams pile
+ * up in its receive buffer and the kernel drops the overflow silently. For
+ * consumers on this host the monitor reads the consumer socket's receive
+ * queue and drop counter through sock_diag (as "ss -u -m" does); for every
+ * destination it also reads the bridge's own send queues (SIOCOUTQ). The
+ * fullest queue sets the destination's pressure level, which streams with a
+ * backpressure action use to throttle or shed before the kernel drops.
+ */
+class BackpressureMonitor {
+public:
+    BackpressureMonitor(const BridgeConfig& config, std::vector<std::shared_ptr<UdpDestination>> destinations);
+    ~BackpressureMonitor();
+
+    BackpressureMonitor(const BackpressureMonitor&) = delete;
+    BackpressureMonitor& operator=(const BackpressureMonitor&) = delete;
+
+    bool start();
+    void stop();
+
+private:
+    // Receive queue of the local UDP sockets, keyed by bound port
+    struct ConsumerSocket {
+        uint32_t address = 0;             // Bound address, network order, 0 for any
+        SocketQueue queue;
+        uint64_t drops = 0;
+    };
+    using ConsumerSockets = std::multimap<uint16_t, ConsumerSocket>;
+
+    void monitorLoop();
+    void sample();
+
+    // Dump all local UDP sockets with their memory usage, false if sock_diag is unavailable
+    bool readConsumerSockets(ConsumerSockets& sockets);
+
+    // Whether the destination address belongs to this host
+    bool isLocal(uint32_t address) const;
+
+    PressureLevel nextLevel(PressureLevel current, double occupancy) const;
+
+    // Interruptible sleep, returns false if stop was requested
+    bool waitFor(std::chrono::milliseconds delay);
+
+private:
+    std::chrono::milliseconds interval_;
+    double high_;
+    double critical_;
+    std::vector<std::shared_ptr<UdpDestination>> destinations_;
+    std::vector<uint32_t> local_addresses_;   // Network order
+    std::map<std::string, uint64_t> last_drops_;  // Consumer drop counter at the previous sample
+    int diag_socket_ = -1;
+
+    std::atomic<bool> running_{false};
+    std::thread monitor_thread_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+};
+
+} // namespace data_bridge
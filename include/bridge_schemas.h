@@ -0,0 +1,50 @@
+#pragma once
+
+#include "schema.h"
+
+// Schemas the bridge can transcode, one FIELD(protobuf number, type, name) per field.
+// Numbers of published fields never change; new fields take new numbers.
+
+// Tracked body pose, position in meters, orientation as a unit quaternion
+#define DATA_BRIDGE_POSE_FIELDS(FIELD) \
+    FIELD(1, UINT64, stamp_ns) \
+    FIELD(2, UINT32, frame_id) \
+    FIELD(3, DOUBLE, x) \
+    FIELD(4, DOUBLE, y) \
+    FIELD(5, DOUBLE, z) \
+    FIELD(6, FLOAT, qx) \
+    FIELD(7, FLOAT, qy) \
+    FIELD(8, FLOAT, qz) \
+    FIELD(9, FLOAT, qw)
+
+// Inertial measurement, m/s^2 and rad/s
+#define DATA_BRIDGE_IMU_FIELDS(FIELD) \
+    FIELD(1, UINT64, stamp_ns) \
+    FIELD(2, FLOAT, accel_x) \
+    FIELD(3, FLOAT, accel_y) \
+    FIELD(4, FLOAT, accel_z) \
+    FIELD(5, FLOAT, gyro_x) \
+    FIELD(6, FLOAT, gyro_y) \
+    FIELD(7, FLOAT, gyro_z) \
+    FIELD(8, FLOAT, temperature)
+
+#define DATA_BRIDGE_BATTERY_STATE_FIELDS(FIELD) \
+    FIELD(1, UINT64, stamp_ns) \
+    FIELD(2, FLOAT, voltage) \
+    FIELD(3, FLOAT, current) \
+    FIELD(4, FLOAT, percentage) \
+    FIELD(5, UINT32, cycle_count) \
+    FIELD(6, INT32, status) \
+    FIELD(7, BOOL, charging)
+
+// Struct name, schema name used in the configuration, fields
+#define DATA_BRIDGE_SCHEMAS(SCHEMA) \
+    SCHEMA(Pose, "pose", DATA_BRIDGE_POSE_FIELDS) \
+    SCHEMA(Imu, "imu", DATA_BRIDGE_IMU_FIELDS) \
+    SCHEMA(BatteryState, "battery_state", DATA_BRIDGE_BATTERY_STATE_FIELDS)
+
+namespace data_bridge {
+
+DATA_BRIDGE_SCHEMAS(DATA_BRIDGE_DEFINE_SCHEMA)
+
+} // namespace data_bridge
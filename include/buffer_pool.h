@@ -0,0 +1,113 @@
+#pragma once
+
+#include "common.h"
+#include <array>
+#include <mutex>
+
+namespace data_bridge {
+
+struct BufferPoolStats {
+    uint64_t allocations = 0;     // Buffers handed out by the size classes
+    uint64_t cache_hits = 0;      // Allocations served from a thread's free list
+    uint64_t remote_frees = 0;    // Buffers released by a thread other than their owner
+    uint64_t heap = 0;            // Larger than the biggest class, served by the heap
+    uint64_t in_use = 0;          // Pooled buffers currently referenced
+    uint64_t slabs = 0;           // Slabs mapped so far, never unmapped
+    uint64_t huge_slabs = 0;      // Slabs backed by explicit huge pages
+    uint64_t slab_bytes = 0;
+};
+
+class BufferPool;
+
+/**
+ * @brief Payload Buffer - Reference-counted handle to a pooled buffer
+ *
+ * Copying a handle shares the buffer (e.g. one received sample sent to
+ * several targets, or kept until a zero-copy send completes); the buffer
+ * goes back to the pool when the last handle is released, from any thread.
+ */
+class PayloadBuffer {
+public:
+    PayloadBuffer() = default;
+    PayloadBuffer(const PayloadBuffer& other);
+    PayloadBuffer(PayloadBuffer&& other) noexcept : block_(other.block_) { other.block_ = nullptr; }
+    PayloadBuffer& operator=(const PayloadBuffer& other);
+    PayloadBuffer& operator=(PayloadBuffer&& other) noexcept;
+    ~PayloadBuffer() { reset(); }
+
+    // Buffer of size bytes from the process-wide pool
+    static PayloadBuffer allocate(size_t size);
+
+    uint8_t* data() const;
+    size_t size() const;
+    size_t capacity() const;
+    ByteView view() const { return {data(), size()}; }
+
+    // Change the size within capacity, returns false if it does not fit
+    bool resize(size_t size);
+
+    // Drop this reference
+    void reset();
+
+    explicit operator bool() const { return block_ != nullptr; }
+
+private:
+    friend class BufferPool;
+    struct Block;
+
+    explicit PayloadBuffer(Block* block) : block_(block) {}
+
+    Block* block_ = nullptr;
+};
+
+/**
+ * @brief Buffer Pool - Size-classed payload buffers without malloc in steady state
+ *
+ * Buffers come in power-of-two classes from 256 B to 64 KiB, carved from
+ * 2 MiB slabs (explicit huge pages when available, else transparent huge
+ * pages). Every thread has its own free list per class, so allocation and
+ * release on the same thread take no lock. A buffer released by another
+ * thread is pushed onto its owner's lock-free return list, which the owner
+ * takes over in one exchange when its free list runs empty. Slabs are
+ * never returned to the OS, so RSS stays at the peak working set instead
+ * of fragmenting over long runs.
+ */
+class BufferPool {
+public:
+    static BufferPool& instance();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    // Try explicit huge pages for slabs mapped from now on (default on)
+    void setHugePages(bool enabled);
+
+    PayloadBuffer allocate(size_t size);
+
+    BufferPoolStats getStats() const;
+
+    // Largest size served from the pool
+    static size_t maxPooledSize();
+
+private:
+    friend class PayloadBuffer;
+    struct ThreadCache;
+
+    BufferPool() = default;
+
+    ThreadCache* localCache();
+    ThreadCache* acquireCache();
+    uint8_t* mapSlab();
+    static void release(PayloadBuffer::Block* block);
+
+private:
+    mutable std::mutex mutex_;                       // Guards caches_ and slab mapping
+    std::vector<std::unique_ptr<ThreadCache>> caches_;
+    std::atomic<bool> huge_pages_{true};
+    bool huge_pages_failed_ = false;                 // Logged once, then THP only
+    uint64_t slabs_ = 0;
+    uint64_t huge_slabs_ = 0;
+    std::atomic<uint64_t> heap_{0};
+};
+
+} // namespace data_bridge
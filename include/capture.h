@@ -0,0 +1,149 @@
+#pragma once
+
+#include "common.h"
+#include <functional>
+#include <string_view>
+
+namespace data_bridge {
+
+/*
+ * Capture file layout (little endian, one file per segment):
+ *
+ *   [CaptureSegmentHeader, padded to 4 KiB]
+ *   [CaptureRecordHeader][key][encoding][payload][pad to 8 bytes] ...
+ *
+ * Segments are preallocated to a multiple of 4 KiB and trimmed to the next
+ * 4 KiB boundary on close, so files stay O_DIRECT friendly. The header's
+ * used_bytes is updated after each record batch; a crashed capture is valid
+ * up to that offset.
+ */
+
+constexpr uint64_t kCaptureMagic = 0x3130504143425a5aULL;  // "ZZBCAP01"
+constexpr size_t kCaptureBlockSize = 4096;
+
+struct CaptureSegmentHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t segment_index;
+    uint64_t created_ns;              // System clock, ns since epoch
+    uint64_t used_bytes;              // Valid bytes including this header block
+};
+
+struct CaptureRecordHeader {
+    uint32_t record_size;             // Total size including header and padding
+    uint16_t key_size;
+    uint16_t encoding_size;
+    uint64_t receive_ns;              // System clock, ns since epoch
+    uint32_t payload_size;
+    uint32_t reserved;
+};
+
+// Decoded record, views point into the mapped segment
+struct CaptureRecord {
+    uint64_t receive_ns;
+    std::string_view key;
+    std::string_view encoding;
+    const uint8_t* payload;
+    size_t payload_size;
+};
+
+struct CaptureStats {
+    uint64_t captured = 0;            // Records written to disk
+    uint64_t dropped = 0;             // Records lost to a full ring or oversize
+    uint64_t segments = 0;            // Segment files opened
+};
+
+/**
+ * @brief Capture Writer - Appends received samples to memory-mapped segments
+ *
+ * The forward path only copies the record into a lock-free MPSC ring of
+ * preallocated slots and never blocks: a full ring drops the record and
+ * counts it. A background thread drains the ring into the mapped segment.
+ */
+class CaptureWriter {
+public:
+    explicit CaptureWriter(const BridgeConfig& config);
+    ~CaptureWriter();
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool start();
+    void stop();
+
+    // Enqueue one sample, safe from any thread. Returns false if dropped.
+    bool append(std::string_view key, std::string_view encoding,
+                const uint8_t* payload, size_t len, uint64_t receive_ns);
+
+    CaptureStats getStats() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::vector<uint8_t> record;  // Preallocated to slot capacity
+        size_t size = 0;
+    };
+
+    void writerLoop();
+    bool openSegment();
+    void closeSegment();
+    bool writeRecord(const uint8_t* record, size_t size);
+
+private:
+    std::string directory_;
+    size_t segment_size_;
+    size_t slot_capacity_;
+
+    // Bounded MPSC ring (sequence-numbered slots)
+    std::vector<Slot> slots_;
+    size_t slot_mask_;
+    std::atomic<uint64_t> enqueue_pos_{0};
+    uint64_t dequeue_pos_ = 0;
+
+    std::atomic<bool> running_{false};
+    std::thread writer_thread_;
+
+    // Current segment (writer thread only)
+    int fd_ = -1;
+    uint8_t* map_ = nullptr;
+    size_t offset_ = 0;
+    uint32_t segment_index_ = 0;
+    std::string session_prefix_;
+
+    std::atomic<uint64_t> captured_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> segments_{0};
+};
+
+/**
+ * @brief Capture Reader - Iterates the records of one segment file
+ */
+class CaptureReader {
+public:
+    CaptureReader() = default;
+    ~CaptureReader();
+
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    // Calls fn for each record in file order, stops early if fn returns false.
+    // Returns false if the segment is corrupt.
+    bool forEach(const std::function<bool(const CaptureRecord&)>& fn) const;
+
+private:
+    int fd_ = -1;
+    const uint8_t* map_ = nullptr;
+    size_t map_size_ = 0;
+    size_t used_ = 0;
+};
+
+// Encode one record into dst (must hold captureRecordSize bytes), returns its size
+size_t encodeCaptureRecord(uint8_t* dst, std::string_view key, std::string_view encoding,
+                           const uint8_t* payload, size_t len, uint64_t receive_ns);
+
+size_t captureRecordSize(size_t key_size, size_t encoding_size, size_t payload_size);
+
+} // namespace data_bridge
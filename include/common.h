@@ -16,6 +16,111 @@ enum class ProtocolType {
     GRPC
 };
 
+// Payload compression codec
+enum class CompressionType {
+    NONE,
+    LZ4,
+    ZSTD
+};
+
+// What a stream does while its consumer is under backpressure
+enum class BackpressureAction {
+    NONE,       // Send anyway, the kernel may drop
+    THROTTLE,   // Wait for the consumer, shed after backpressure_max_wait_us
+    SHED        // Drop at the bridge and count it
+};
+
+// Where a stream's per-publisher sequence numbers come from, for loss accounting
+enum class SequenceSource {
+    NONE,
+    SOURCE_INFO,        // Zenoh SourceInfo set by the publisher (advanced publishers always set it)
+    PAYLOAD_HEADER      // 16-byte header at the start of the decompressed payload, see SequenceHeader
+};
+
+// Checksum in a trailer at the end of the decompressed payload, over the bytes before it
+enum class IntegrityCheck {
+    NONE,
+    CRC32C,     // 4-byte little-endian CRC32C
+    XXH3        // 8-byte little-endian XXH3 64-bit
+};
+
+// How a stream takes samples from Zenoh
+enum class IngestMode {
+    CALLBACK,   // Zenoh calls the bridge once per sample
+    RING,       // Ring channel drained in batches, a full ring drops its oldest sample
+    FIFO        // FIFO channel drained in batches, a full FIFO blocks Zenoh's receive thread
+};
+
+// Transport to a local request/response service
+enum class ServiceTransport {
+    UDP,        // One datagram per request and per response
+    TCP,        // Length-prefixed frames on one connection
+    UNIX        // Same framing on a Unix stream socket
+};
+
+// How the replies to a poll query are consolidated (Zenoh consolidation modes)
+enum class PollConsolidation {
+    AUTO,
+    NONE,       // Every reply of every queryable
+    MONOTONIC,  // Replies per key in timestamp order, older ones dropped
+    LATEST      // Only the newest reply per key
+};
+
+// Wire format of a typed payload, see schema.h
+enum class PayloadFormat {
+    STRUCT,     // Packed little-endian struct, fields in schema order
+    PROTOBUF,   // Protobuf wire format, field numbers from the schema
+    CDR,        // Little-endian XCDR1 with encapsulation header (DDS / ROS 2)
+    JSON        // Flat object keyed by field name
+};
+
+// Scalar type of a payload field (schema fields and content filter rules)
+enum class FieldType : uint8_t {
+    BOOL,
+    INT32,
+    UINT32,
+    INT64,
+    UINT64,
+    FLOAT,
+    DOUBLE
+};
+
+// Comparison made by a content filter rule
+enum class FilterOp {
+    EQ,
+    NE,
+    LT,
+    LE,
+    GT,
+    GE,
+    MIN_DELTA,  // Changed by at least value since the last forwarded sample
+    MAX_AGE_MS  // Timestamp in ns since the Unix epoch, at most value ms old
+};
+
+// One predicate of a stream's content filter, a sample is forwarded only if all of them hold
+struct FilterRule {
+    std::string field;                     // Field of transcode_schema, or empty to read at offset
+    size_t offset = 0;                     // Byte offset in the decompressed payload (little-endian)
+    FieldType type = FieldType::UINT32;    // Type at offset
+    FilterOp op = FilterOp::GE;
+    double value = 0.0;                    // Operand, minimum change (MIN_DELTA) or age (MAX_AGE_MS)
+};
+
+// Non-owning view of payload bytes
+struct ByteView {
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+// One local consumer of a stream
+struct StreamTarget {
+    ProtocolType protocol = ProtocolType::UDP;
+    std::string local_host;
+    int local_port = 0;
+    std::string grpc_service;         // gRPC service name (only for gRPC)
+    std::string grpc_method;          // gRPC method name (only for gRPC)
+};
+
 // Configuration for a single data stream
 struct StreamConfig {
     std::string zenoh_topic;          // Zenoh topic to subscribe
@@ -24,17 +129,184 @@ struct StreamConfig {
     int local_port;                   // Local destination port
     std::string grpc_service;         // gRPC service name (only for gRPC)
     std::string grpc_method;          // gRPC method name (only for gRPC)
+    
+    // Further local consumers, each sample is received once and sent to all of them
+    std::vector<StreamTarget> extra_targets;
+    
+    // Compression (marked samples are decompressed before local forwarding)
+    CompressionType compression = CompressionType::NONE;
+    size_t compression_min_size = 256;     // Smaller payloads pass through untouched
+    int compression_level = 1;             // LZ4 acceleration / zstd level
+    std::string zstd_dictionary;           // Trained zstd dictionary file (optional)
+    
+    // Last-value cache (re-sent when the local consumer registers)
+    size_t cache_depth = 0;                // Samples kept, 0 disables the cache
+    size_t cache_max_payload = 65536;      // Larger samples are not cached
+    bool cache_queryable = false;          // Answer Zenoh queries on the topic from the cache
+    
+    // Conflation (forward only the newest sample per key to slow consumers)
+    double conflation_rate_hz = 0.0;       // Forwarding rate, 0 disables rate conflation
+    bool conflation_consumer_paced = false; // Forward on "READY <topic>" from the consumer instead
+    
+    // Forwarding worker the stream is pinned to, -1 lets any worker run it
+    int forwarding_worker = -1;
+    bool low_latency = false;              // Pinned worker busy-polls for this stream (needs forwarding_worker)
+    
+    // Pull ingestion (not with conflation or recoverable, which keep the callback)
+    IngestMode ingest = IngestMode::CALLBACK;
+    size_t ingest_capacity = 1024;         // Channel slots
+    size_t ingest_batch = 64;              // Most samples drained and sent per wakeup
+    int ingest_interval_us = 1000;         // Drain period, rounded to timer_tick_us
+    
+    // Gap, reorder and duplicate detection
+    SequenceSource sequence_source = SequenceSource::NONE;
+    
+    // Recovery of lost samples from the publishers' caches (Zenoh advanced publishers only)
+    bool recoverable = false;
+    size_t recovery_history = 0;           // Samples per publisher fetched when (re)subscribing, 0 disables
+    int recovery_query_period_ms = 0;      // Poll for a lost last sample, 0 relies on publisher heartbeats
+    int recovery_query_timeout_ms = 0;     // Timeout of history and recovery queries, 0 keeps the Zenoh default
+    
+    // Payload integrity, verified before anything reads the payload
+    IntegrityCheck integrity = IntegrityCheck::NONE;
+    bool integrity_strip = true;           // Forward the payload without its trailer
+    
+    // Subscribe only while a local consumer is registered (needs registration_port)
+    bool lazy = false;
+    
+    // Transcoding to the consumer's wire format, disabled while transcode_schema is empty
+    std::string transcode_schema;          // Compiled schema name (see bridge_schemas.h)
+    PayloadFormat transcode_from = PayloadFormat::PROTOBUF;
+    PayloadFormat transcode_to = PayloadFormat::STRUCT;
+    std::vector<std::string> transcode_fields;  // Fields sent, in schema order; empty sends all
+    
+    // Content filter, evaluated before transcoding and forwarding
+    std::vector<FilterRule> filters;
+    bool filter_duplicates = false;        // Drop payloads byte-identical to the last forwarded one
+    
+    // Backpressure from slow UDP consumers (see backpressure_interval_ms)
+    BackpressureAction backpressure = BackpressureAction::NONE;
+    int backpressure_priority = 0;         // 0 acts from high pressure, 1 only at critical, 2 never
+    int backpressure_max_wait_us = 0;      // Longest throttle wait per sample before shedding it, 0 for two sampling periods
+    
+    // Primary target (protocol, local_host, ...) followed by extra_targets
+    std::vector<StreamTarget> targets() const;
+};
+
+// Local service answering Zenoh queries on a key expression
+struct ServiceConfig {
+    std::string zenoh_key;                 // Key expression of the queryable
+    ServiceTransport transport = ServiceTransport::UDP;
+    std::string host = "127.0.0.1";        // UDP and TCP
+    int port = 0;
+    std::string unix_path;                 // UNIX
+    int timeout_ms = 1000;                 // Query answered with an error after this long
+    size_t window = 16;                    // Requests sent and not yet answered
+    size_t max_outstanding = 1024;         // Queued plus in flight, further queries are refused at once
+};
+
+// Local endpoint where polling consumers trigger a Zenoh query on a key expression
+struct PollConfig {
+    std::string zenoh_key;                 // Key expression queried
+    ServiceTransport transport = ServiceTransport::UDP;  // Socket consumers poll on
+    std::string host = "127.0.0.1";        // UDP and TCP bind address
+    int port = 0;
+    std::string unix_path;                 // UNIX
+    PollConsolidation consolidation = PollConsolidation::LATEST;
+    bool query_all = false;                // Ask every matching queryable, not only the nearest
+    int timeout_ms = 1000;                 // Query timeout
+    int coalesce_ms = 100;                 // Identical polls this long after a query finished share its replies
+};
+
+// CPU placement of one thread
+struct ThreadPlacement {
+    std::vector<int> cpus;            // Allowed CPUs, empty keeps the CPUs inherited from the creator
+    int realtime_priority = 0;        // SCHED_FIFO priority (1-99), 0 keeps SCHED_OTHER
+};
+
+// Socket options for one local destination, shared by all streams sending to it
+struct DestinationConfig {
+    std::string host;
+    int port = 0;
+    size_t shards = 1;                // Connected sockets, one picked per forwarding thread
+    int send_buffer = 0;              // SO_SNDBUF bytes, 0 keeps the system default
+    int priority = -1;                // SO_PRIORITY, -1 keeps the default
+    int dscp = -1;                    // DSCP written to IP_TOS (0-63), -1 keeps the default
 };
 
 // Global configuration
 struct BridgeConfig {
     // Zenoh settings
     std::string zenoh_mode = "client";
-    std::string zenoh_connect = "";   // Empty means peer mode
+    std::string zenoh_connect = "";   // Empty means peer mode, comma separated endpoints otherwise
+    bool zenoh_low_latency = false;   // Zenoh low-latency transport (QoS off, must match the router)
+
+    // Session supervision (only applies when zenoh_connect is set)
+    int health_check_interval_ms = 200;       // Router connectivity poll period
+    int disconnect_grace_ms = 1000;           // Outage tolerated before replacing the session
+    int reconnect_backoff_initial_ms = 100;   // First retry delay
+    int reconnect_backoff_max_ms = 5000;      // Retry delay cap
+    bool warm_standby = false;                // Keep a second session open for fast failover
+
+    // Local consumer registration ("HELLO <topic>" datagrams)
+    int registration_port = 0;                // UDP port, 0 disables registration
+    int consumer_timeout_ms = 5000;           // A consumer of a lazy stream is gone after this long without HELLO/ALIVE
+    int consumer_grace_ms = 30000;            // A lazy stream stays subscribed this long after its consumer left
+    std::string liveliness_prefix;            // Liveliness token "<prefix>/<zenoh_topic>" per subscribed stream, empty disables
     
+    // Capture (record received samples for bridge_replay)
+    std::string capture_dir = "";             // Empty disables capture
+    size_t capture_segment_mb = 64;           // Preallocated size of each segment file
+    size_t capture_ring_slots = 4096;         // Records buffered between forward path and writer
+    size_t capture_max_record_kb = 64;        // Larger records are dropped
+
+    // UDP egress backend
+    std::string egress_backend = "sendto";    // "sendto" or "io_uring" (falls back to sendto if unavailable)
+    int io_uring_engines = 1;                 // Submission threads, streams are spread round-robin
+    size_t io_uring_queue_depth = 256;        // Datagrams queued per engine
+    size_t io_uring_buffer_size = 65536;      // Largest datagram sent through the ring
+    size_t io_uring_zerocopy_threshold = 16384; // SEND_ZC from this size, 0 disables
+
+    // UDP sendto backend
+    bool udp_connect = true;                  // Connected sockets skip the per-packet route lookup
+    std::vector<DestinationConfig> destinations; // Per host:port socket options (optional)
+    bool udp_gso = true;                      // Send batches of equal-size datagrams as one GSO buffer
+    size_t udp_zerocopy_threshold = 0;        // MSG_ZEROCOPY from this size, 0 disables
+
+    // Backpressure monitoring of UDP destinations
+    int backpressure_interval_ms = 20;        // Socket queue sampling period, 0 disables
+    double backpressure_high = 0.5;           // Queue occupancy (fraction of the buffer) for high pressure
+    double backpressure_critical = 0.8;       // And for critical pressure
+
+    // Threading
+    ThreadPlacement housekeeping;             // Main thread, inherited by Zenoh and support threads
+    std::vector<ThreadPlacement> forwarding_workers; // Forwarding worker pool, empty forwards on the Zenoh callback
+    size_t forwarding_queue_depth = 1024;     // Samples queued per stream
+    int forwarding_spin_us = 50;              // Longest spin of an idle worker before it parks
+    int low_latency_idle_us = 1000;           // Busy-poll time of a low-latency worker before it parks
+
+    // Payload buffer pool
+    bool buffer_pool_hugepages = true;        // Try explicit huge pages for slabs, else transparent ones
+
+    // Timer wheel shared by all periodic stream work
+    int timer_tick_us = 1000;                 // Wheel resolution
+
+    // Shutdown and restart handoff
+    int drain_timeout_ms = 500;               // Queued samples forwarded on stop for at most this long
+    std::string handoff_path;                 // Unix socket a restarted bridge takes over sockets and caches through, empty disables
+
+    // Statistics
+    int stats_interval_sec = 10;              // Periodic stats report, 0 disables
+
     // Data streams to forward
     std::vector<StreamConfig> streams;
     
+    // Local services exposed as Zenoh queryables
+    std::vector<ServiceConfig> services;
+    
+    // Local poll endpoints answered by Zenoh queries
+    std::vector<PollConfig> polls;
+    
     // Load configuration from JSON file
     bool loadFromFile(const std::string& filepath);
     
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common.h"
+#include "buffer_pool.h"
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string_view>
+
+namespace data_bridge {
+
+struct ConflationStats {
+    uint64_t stored = 0;        // Samples handed to the conflater
+    uint64_t conflated = 0;     // Samples overwritten before they were forwarded
+    uint64_t forwarded = 0;     // Samples sent by flushes
+};
+
+/**
+ * @brief Conflater - Keeps only the newest unsent sample per key of a stream
+ *
+ * Samples are stored on the Zenoh callback and sent by flush(), either from
+ * a periodic timer (rate mode) or when the local consumer asks for more
+ * (consumer-paced mode). The newest sample of a key is held by reference
+ * to its pooled buffer, so storing neither copies nor allocates.
+ */
+class Conflater {
+public:
+    // Sends a batch of samples, returns how many were sent
+    using SendFunction = std::function<size_t(const ByteView* items, size_t count)>;
+
+    explicit Conflater(bool consumer_paced);
+
+    Conflater(const Conflater&) = delete;
+    Conflater& operator=(const Conflater&) = delete;
+
+    // Keep the sample as newest of its key, returns true if a flush is due now
+    bool store(std::string_view key, const PayloadBuffer& payload);
+
+    // Consumer-paced mode: allow the next flush to send
+    void grant();
+
+    // Send all pending samples as one batch, returns the number sent
+    size_t flush(const SendFunction& send);
+
+    ConflationStats getStats() const;
+
+private:
+    struct Pending {
+        PayloadBuffer payload;              // Released once sent
+        bool dirty = false;
+    };
+
+private:
+    bool consumer_paced_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Pending, std::less<>> pending_;
+    std::vector<ByteView> batch_;           // Reused across flushes
+    size_t dirty_count_ = 0;
+    bool credit_ = false;                   // Consumer asked for data not yet sent
+    ConflationStats stats_;
+};
+
+} // namespace data_bridge
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common.h"
+#include <functional>
+
+namespace data_bridge {
+
+// Control messages a local consumer can send
+enum class ConsumerMessage {
+    HELLO,      // "HELLO <zenoh_topic>": consumer (re)started
+    READY,      // "READY <zenoh_topic>": consumer-paced stream may send the next sample
+    ALIVE,      // "ALIVE <zenoh_topic>": consumer still running (keepalive, no re-send)
+    BYE         // "BYE <zenoh_topic>": consumer is shutting down
+};
+
+/**
+ * @brief Consumer Registry - Listens for local consumer control messages
+ *
+ * Local consumers announce themselves with a single UDP datagram
+ * "HELLO <zenoh_topic>" sent to the registration port, on start and after
+ * every restart. Consumer-paced streams additionally send "READY <topic>"
+ * whenever they want the next sample. Consumers of lazy streams repeat
+ * "ALIVE <topic>" well within consumer_timeout_ms and may send "BYE <topic>"
+ * on exit, so the stream is only subscribed while someone listens.
+ */
+class ConsumerRegistry {
+public:
+    // Called on the registry thread for every control message
+    using MessageCallback = std::function<void(ConsumerMessage message, const std::string& topic)>;
+
+    explicit ConsumerRegistry(int port);
+    ~ConsumerRegistry();
+
+    // inherited: socket a predecessor bridge bound to the port (restart handoff), -1 binds a new one
+    bool start(MessageCallback callback, int inherited = -1);
+    void stop();
+
+    // Bound socket, -1 if not started
+    int socket() const { return socket_; }
+
+private:
+    bool bindSocket();
+    void receiveLoop();
+
+private:
+    int port_;
+    int socket_{-1};
+    std::atomic<bool> running_{false};
+    std::thread receive_thread_;
+    MessageCallback callback_;
+};
+
+} // namespace data_bridge
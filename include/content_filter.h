@@ -0,0 +1,103 @@
+#pragma once
+
+#include "common.h"
+#include "schema.h"
+#include <atomic>
+
+namespace data_bridge {
+
+struct FilterStats {
+    uint64_t passed = 0;              // Samples forwarded
+    uint64_t filtered = 0;            // Dropped by a rule
+    uint64_t duplicates = 0;          // Dropped as byte-identical to the last forwarded payload
+};
+
+/**
+ * @brief Content Filter - Per-stream predicates evaluated before forwarding
+ *
+ * The rules of a stream are compiled once into flat instruction lists: a
+ * rule on a fixed offset, or on a field of a packed struct schema, reads
+ * the decompressed payload in place; a rule on a field of a protobuf, CDR
+ * or JSON schema runs on the values the transcoder decoded. Operands are
+ * converted to the field's type up front, so a sample costs one load and
+ * one compare per rule and nothing is parsed or allocated.
+ *
+ * Duplicates are detected by the XXH64 hash and size of the last forwarded
+ * payload; MIN_DELTA rules compare with the last forwarded value too. A
+ * sample updates that state only through commit(), once every check has
+ * passed.
+ *
+ * Not thread-safe: one stream runs on one thread at a time. Stats may be
+ * read from any thread.
+ */
+class ContentFilter {
+public:
+    // decoded: schema of the values passed to admitFields (the transcoder's), nullptr without a transcoder
+    ContentFilter(const StreamConfig& config, const SchemaDescriptor* decoded);
+
+    // Compile the rules, false if a field is unknown or cannot be read
+    bool init();
+
+    // Offset rules and duplicate check on the decompressed payload, false to drop it
+    bool admitPayload(ByteView payload);
+
+    // Rules on decoded schema fields, false to drop the sample
+    bool admitFields(const FieldValue* values);
+
+    // The sample is forwarded: remember it for the duplicate check and MIN_DELTA rules
+    void commit();
+
+    // Rules on decoded fields, admitFields has nothing to do without them
+    bool needsFields() const { return !field_program_.empty(); }
+
+    // "3 rules, duplicates dropped"
+    std::string describe() const;
+
+    FilterStats getStats() const;
+
+private:
+    // How an operand and a field value are compared
+    enum class Domain : uint8_t {
+        SIGNED,
+        UNSIGNED,
+        REAL
+    };
+
+    struct Instruction {
+        FilterOp op;
+        FieldType type;
+        Domain domain;
+        uint32_t location;            // Byte offset (payload program) or field index (field program)
+        FieldValue operand;           // In domain; MIN_DELTA threshold in d, MAX_AGE_MS age limit in ns in i
+        int slot = -1;                // MIN_DELTA: index into last_values_
+    };
+
+    bool compile(const FilterRule& rule);
+    bool evaluate(const Instruction& instruction, const FieldValue& value);
+
+private:
+    std::vector<FilterRule> rules_;
+    bool drop_duplicates_;
+    PayloadFormat input_format_;
+    std::string schema_name_;
+    const SchemaDescriptor* decoded_;
+
+    std::vector<Instruction> payload_program_;
+    std::vector<Instruction> field_program_;
+
+    // Last forwarded sample, and the one being checked
+    bool has_last_ = false;
+    uint64_t last_hash_ = 0;
+    size_t last_size_ = 0;
+    uint64_t pending_hash_ = 0;
+    size_t pending_size_ = 0;
+    std::vector<double> last_values_;
+    std::vector<double> pending_values_;
+    int64_t now_ns_ = 0;              // Read once per sample by the first MAX_AGE_MS rule
+
+    std::atomic<uint64_t> passed_{0};
+    std::atomic<uint64_t> filtered_{0};
+    std::atomic<uint64_t> duplicates_{0};
+};
+
+} // namespace data_bridge
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "common.h"
+#include "udp_sender.h"
+#include <map>
+
+namespace data_bridge {
+
+// Bytes waiting in a socket queue and the queue's limit
+struct SocketQueue {
+    uint64_t queued = 0;
+    uint64_t capacity = 0;
+};
+
+enum class PressureLevel {
+    NORMAL,
+    HIGH,
+    CRITICAL
+};
+
+// Backpressure of one destination, sampled by the BackpressureMonitor
+struct DestinationPressure {
+    PressureLevel level = PressureLevel::NORMAL;
+    double occupancy = 0.0;           // Fullest of the queues below, fraction of its capacity
+    SocketQueue send;                 // Bridge's sockets (SIOCOUTQ), summed over shards
+    SocketQueue receive;              // Consumer's socket, local consumers only
+    bool consumer_found = false;      // A local socket bound to the destination was seen
+    uint64_t consumer_drops = 0;      // Datagrams the consumer's socket dropped since monitoring started
+};
+
+/**
+ * @brief UDP Destination - Connected sockets to one local host:port
+ *
+ * Each shard is its own connected socket; a forwarding thread always uses
+ * the same shard, so threads sending to one consumer do not contend on a
+ * single socket lock.
+ */
+class UdpDestination {
+public:
+    UdpDestination(const DestinationConfig& config, const BridgeConfig& bridge_config);
+    ~UdpDestination();
+
+    UdpDestination(const UdpDestination&) = delete;
+    UdpDestination& operator=(const UdpDestination&) = delete;
+
+    // Create, configure and connect the shard sockets. Inherited sockets of a predecessor bridge
+    // (restart handoff) are used first, so the consumer keeps seeing the same source ports.
+    // With MSG_ZEROCOPY they are closed instead, see DestinationRegistry::handoffSockets().
+    bool open(std::vector<int> inherited = {});
+
+    // Sender of the calling thread's shard
+    UdpSender& sender();
+    size_t shardIndex() const;
+
+    const std::string& name() const { return name_; }
+    const sockaddr_in& address() const { return addr_; }
+    int primarySocket() const { return shards_.empty() ? -1 : shards_[0].fd; }
+    size_t shardCount() const { return shards_.size(); }
+    std::vector<int> sockets() const;
+    bool zeroCopy() const { return zerocopy_threshold_ > 0; }
+
+    // Summed over all shards
+    UdpSenderStats getStats() const;
+
+    // Bytes not yet handed to the device, summed over all shards
+    SocketQueue sendQueue() const;
+
+    // Latest sample, read on every send by streams with a backpressure action
+    PressureLevel pressureLevel() const { return pressure_level_.load(std::memory_order_relaxed); }
+    DestinationPressure getPressure() const;
+    void setPressure(const DestinationPressure& pressure);
+
+private:
+    struct Shard {
+        int fd = -1;
+        std::unique_ptr<UdpSender> sender;
+    };
+
+    // Apply the configured socket options, false if one is rejected
+    bool configureSocket(int fd);
+
+private:
+    DestinationConfig config_;
+    bool connect_;
+    bool gso_;
+    size_t zerocopy_threshold_;
+    std::string name_;                    // "host:port"
+    sockaddr_in addr_{};
+    std::vector<Shard> shards_;
+
+    std::atomic<PressureLevel> pressure_level_{PressureLevel::NORMAL};
+    mutable std::mutex pressure_mutex_;   // Guards pressure_
+    DestinationPressure pressure_;
+};
+
+/**
+ * @brief Destination Registry - One UdpDestination per host:port
+ *
+ * Streams forwarding to the same consumer share its sockets. Options come
+ * from the matching BridgeConfig::destinations entry, defaults otherwise.
+ */
+class DestinationRegistry {
+public:
+    explicit DestinationRegistry(const BridgeConfig& config);
+
+    // Existing destination for host:port, or a newly opened one (nullptr on error).
+    // inherited sockets are handed to UdpDestination::open().
+    std::shared_ptr<UdpDestination> acquire(const std::string& host, int port, std::vector<int> inherited = {});
+
+    // Snapshot of all destinations, for statistics
+    std::vector<std::shared_ptr<UdpDestination>> all() const;
+
+    // Sockets a restarted bridge may take over, by "udp:<host>:<port>". Zerocopy destinations are
+    // left out: the kernel's completion counter of a socket goes with it, and both bridges would
+    // reap each other's completions from its error queue.
+    std::map<std::string, std::vector<int>> handoffSockets() const;
+
+    // Release the registry's references, sockets close with the last stream
+    void clear();
+
+private:
+    BridgeConfig config_;
+    std::map<std::string, std::shared_ptr<UdpDestination>> destinations_;
+};
+
+} // namespace data_bridge
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "common.h"
+#include "buffer_pool.h"
+#include <functional>
+
+namespace data_bridge {
+
+// One received sample waiting to be forwarded
+struct ForwardTask {
+    void* stream = nullptr;                   // Owner's stream, opaque to the executor
+    PayloadBuffer payload;                    // As received, still compressed
+    CompressionType codec = CompressionType::NONE;
+    int64_t enqueue_ns = 0;                   // Steady clock, set by post()
+    bool drain = false;                       // Pull the stream's channel instead, payload is empty
+};
+
+struct ForwardingWorkerStats {
+    bool busy_poll = false;                   // Dedicated to low-latency streams
+    uint64_t forwarded = 0;                   // Tasks run on the worker
+    uint64_t steals = 0;                      // Streams taken from another worker's run queue
+    uint64_t parks = 0;                       // Times the worker went to sleep
+    uint64_t max_delay_ns = 0;                // Longest time a task waited in its stream queue
+    uint64_t p999_delay_ns = 0;               // 99.9th percentile of that wait (about 25% resolution)
+    int64_t spin_ns = 0;                      // Current adaptive spin before parking
+    uint64_t spin_time_ns = 0;                // Total time spent spinning without work
+    uint64_t park_time_ns = 0;                // Total time spent parked
+};
+
+struct ForwardingExecutorStats {
+    std::vector<ForwardingWorkerStats> workers;
+    uint64_t waits = 0;                       // Posts that found their stream queue full and waited
+};
+
+/**
+ * @brief Forwarding Executor - Fixed worker pool forwarding many streams in order
+ *
+ * Every stream has its own task queue and is owned by at most one worker at
+ * a time, so its samples are forwarded in FIFO order. A stream with queued
+ * tasks is scheduled once: into the shared injection queue, or into the
+ * queue of its pinned worker. A worker runs a stream for a bounded number of
+ * tasks, then puts it at the back of its own run queue, so its streams take
+ * turns; idle workers steal whole streams from the other run queues. Idle
+ * workers spin for an adaptive time (longer while work keeps arriving right
+ * after they park) before parking.
+ *
+ * A busy-poll worker is dedicated to the low-latency streams pinned to it:
+ * it takes no other streams and spins on its queue for a fixed idle period
+ * before parking, so a sample that arrives while it is polling is picked up
+ * without a wakeup.
+ *
+ * A full stream queue makes post() wait for the stream's worker rather than
+ * drop or reorder samples.
+ */
+class ForwardingExecutor {
+public:
+    using Handler = std::function<void(ForwardTask& task)>;
+
+    ForwardingExecutor(const std::vector<ThreadPlacement>& workers, size_t queue_depth,
+                       std::chrono::microseconds max_spin, std::chrono::microseconds busy_poll_idle,
+                       Handler handler);
+    ~ForwardingExecutor();
+
+    ForwardingExecutor(const ForwardingExecutor&) = delete;
+    ForwardingExecutor& operator=(const ForwardingExecutor&) = delete;
+
+    // Register a stream before start(). pinned_worker -1 lets any worker run it,
+    // otherwise only that worker does; busy_poll makes that worker a dedicated
+    // busy-poll worker. Returns the id for post().
+    int addStream(int pinned_worker, bool busy_poll = false);
+
+    bool start();
+
+    // Wait until every queued task has been forwarded, false if the deadline passed first
+    bool drain(std::chrono::steady_clock::time_point deadline);
+
+    // Forwards what is already queued, then stops. With discard, tasks still queued are dropped.
+    void stop(bool discard = false);
+
+    // Queue a task for a stream, safe from any thread. False once stopped.
+    bool post(int stream, ForwardTask&& task);
+
+    size_t workerCount() const { return workers_.size(); }
+    const ThreadPlacement& placement(size_t worker) const;
+
+    ForwardingExecutorStats getStats() const;
+
+private:
+    struct StreamQueue;
+    struct Worker;
+    struct Injection;
+
+    void run(Worker& worker);
+    StreamQueue* findWork(Worker& worker);
+    void runStream(Worker& worker, StreamQueue& stream);
+    void schedule(StreamQueue& stream, Worker* current);
+    bool hasWork(const Worker& worker) const;
+    void idle(Worker& worker);
+    int64_t park(Worker& worker);
+    void wake(Worker& worker);
+
+private:
+    size_t queue_depth_;
+    int64_t max_spin_ns_;
+    int64_t busy_poll_ns_;
+    Handler handler_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::unique_ptr<StreamQueue>> streams_;
+    std::unique_ptr<Injection> injection_;     // Newly scheduled unpinned streams
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> discard_{false};
+    std::atomic<uint64_t> waits_{0};
+};
+
+} // namespace data_bridge
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "common.h"
+#include "last_value_cache.h"
+#include <functional>
+#include <map>
+
+namespace data_bridge {
+
+// State of one stream passed to a successor
+struct HandoffStream {
+    std::string topic;
+    int64_t consumer_ns = 0;                  // Lazy streams: time left before the consumer expires, 0 if none
+    std::vector<CachedSample> samples;        // Last value cache, oldest first
+};
+
+// What a running bridge passes to its successor. Sockets are borrowed, they are duplicated into the successor.
+struct HandoffOffer {
+    std::map<std::string, std::vector<int>> sockets;   // "udp:<host>:<port>", "registration", "poll:<endpoint>"
+    std::vector<HandoffStream> streams;
+};
+
+/**
+ * @brief Handoff - Passes sockets and cached samples to a restarted bridge
+ *
+ * A bridge with handoff_path set listens on that Unix socket. A new bridge
+ * started with the same path connects to it before opening anything and
+ * receives the running bridge's sockets (SCM_RIGHTS) and the contents of its
+ * last value caches. It then subscribes with those sockets and reports
+ * ready; the old bridge stops its subscribers, forwards what it has queued
+ * through the shared sockets, confirms and exits. Consumers see no gap: for
+ * the short overlap both bridges forward, so a sample may arrive twice but
+ * none is lost.
+ *
+ * Frames are [type:1][length:4][body], little-endian; socket frames carry
+ * their descriptors as ancillary data.
+ */
+class Handoff {
+public:
+    // Gathers the offer, called on the handoff thread
+    using OfferFunction = std::function<HandoffOffer()>;
+    // Stops intake and forwards what is queued, called once the successor is ready
+    using ReleaseFunction = std::function<void()>;
+
+    explicit Handoff(const std::string& path);
+    ~Handoff();
+
+    Handoff(const Handoff&) = delete;
+    Handoff& operator=(const Handoff&) = delete;
+
+    // Successor: receive the offer of a bridge listening on the path. Also true if none is,
+    // the bridge then opens its own sockets (tookOver() false). False if the handover failed.
+    bool receive();
+
+    bool tookOver() const { return took_over_; }
+
+    // Received sockets of a name, ownership passes to the caller. Empty if none.
+    std::vector<int> takeSockets(const std::string& name);
+
+    const std::vector<HandoffStream>& streams() const { return streams_; }
+
+    // Successor: report ready and wait for the predecessor to drain, at most timeout_ms.
+    // Received sockets nobody took are closed.
+    bool complete(int timeout_ms);
+
+    // Listen for a successor, a previous bridge's socket file is replaced
+    bool listen(OfferFunction offer, ReleaseFunction release);
+
+    void stop();
+
+private:
+    void listenLoop();
+
+    // Send the offer, wait for the successor and release. False if it did not take over.
+    bool serve(int connection);
+
+    void closeConnection();
+
+private:
+    std::string path_;
+    int connection_ = -1;                     // Successor: to the predecessor
+    bool took_over_ = false;
+    std::map<std::string, std::vector<int>> sockets_;
+    std::vector<HandoffStream> streams_;
+
+    int listen_fd_ = -1;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> handed_over_{false};    // The socket file belongs to the successor now
+    std::thread listen_thread_;
+    OfferFunction offer_;
+    ReleaseFunction release_;
+};
+
+} // namespace data_bridge
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace data_bridge {
+
+// XXH64 of a byte range, identical to the reference implementation
+uint64_t xxhash64(const void* data, size_t len, uint64_t seed = 0);
+
+// CRC32C (Castagnoli, as in iSCSI and ext4), with SSE4.2 or ARMv8 CRC instructions when the CPU has them
+uint32_t crc32c(const void* data, size_t len);
+
+// XXH3 64-bit (no seed, default secret), identical to the reference XXH3_64bits; inputs
+// above 240 bytes use AVX2 or SSE2 when the CPU has them
+uint64_t xxh3_64(const void* data, size_t len);
+
+// Same results without CPU-specific instructions, for tests and benchmarks
+uint32_t crc32cPortable(const void* data, size_t len);
+uint64_t xxh3_64Portable(const void* data, size_t len);
+
+// Implementation picked at startup: "sse4.2", "armv8-crc", "avx2", "sse2" or "portable"
+const char* crc32cImplementation();
+const char* xxh3Implementation();
+
+} // namespace data_bridge
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "common.h"
+
+namespace data_bridge {
+
+/**
+ * @brief Payload integrity trailers
+ *
+ * The publisher writes a checksum of the payload into its last bytes
+ * (4 for CRC32C, 8 for XXH3, little-endian); the bridge checks it before
+ * anything else reads the payload. Both checksums use the CPU's CRC or
+ * SIMD instructions when it has them (see hash.h), so the check can stay
+ * on for large frames.
+ */
+class Integrity {
+public:
+    // Trailer bytes of a check, 0 for NONE
+    static size_t trailerSize(IntegrityCheck check);
+
+    // Checksum of the bytes before the trailer into the last trailerSize() bytes, false if too short.
+    // NONE writes nothing and always passes verify().
+    static bool writeTrailer(IntegrityCheck check, uint8_t* data, size_t len);
+
+    // Check the trailer, body_size is the payload size without it. False if too short or mismatched.
+    static bool verify(IntegrityCheck check, ByteView payload, size_t& body_size);
+
+    // Parse a check name ("none", "crc32c", "xxh3")
+    static bool parseCheck(const std::string& name, IntegrityCheck& check);
+
+    static const char* checkName(IntegrityCheck check);
+
+    // "crc32c (sse4.2)"
+    static std::string describe(IntegrityCheck check);
+};
+
+} // namespace data_bridge
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace data_bridge {
+
+/**
+ * @brief JSON Value - Parsed JSON document, for configuration files
+ *
+ * A strict RFC 8259 recursive-descent parser without dependencies. Numbers
+ * are kept as double; object members keep their document order, a key that
+ * appears twice is an error.
+ */
+class JsonValue {
+public:
+    enum class Type {
+        NUL,
+        BOOL,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    // Parse a whole document, false with a message naming the line on error
+    static bool parse(const std::string& text, JsonValue& value, std::string& error);
+
+    // "null", "boolean", "number", "string", "array" or "object"
+    static const char* typeName(Type type);
+
+    Type type() const { return type_; }
+    bool asBool() const { return bool_; }
+    double asNumber() const { return number_; }
+    const std::string& asString() const { return string_; }
+
+    // Array elements or object member values
+    size_t size() const { return items_.size(); }
+    const JsonValue& at(size_t index) const { return items_[index]; }
+
+    // Object member key, in document order
+    const std::string& key(size_t index) const { return keys_[index]; }
+
+    // Object member, nullptr if absent
+    const JsonValue* find(const std::string& key) const;
+
+private:
+    class Parser;
+
+    Type type_ = Type::NUL;
+    bool bool_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<std::string> keys_;       // Objects only
+    std::vector<JsonValue> items_;
+};
+
+} // namespace data_bridge
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "common.h"
+#include <string_view>
+
+namespace data_bridge {
+
+// Copy of one cached sample, handed out to readers
+struct CachedSample {
+    std::string key;
+    std::string encoding;
+    std::vector<uint8_t> payload;
+    uint64_t receive_ns = 0;
+};
+
+/**
+ * @brief Last Value Cache - Keeps the newest N samples of a stream
+ *
+ * Each slot is protected by a seqlock: the writer (the stream's Zenoh
+ * callback) never waits on readers, readers retry if a slot changed under
+ * them. Slots are preallocated to max_payload so storing does not allocate.
+ */
+class LastValueCache {
+public:
+    LastValueCache(size_t depth, size_t max_payload);
+
+    LastValueCache(const LastValueCache&) = delete;
+    LastValueCache& operator=(const LastValueCache&) = delete;
+
+    // Store a sample, returns false if it does not fit a slot
+    bool store(std::string_view key, std::string_view encoding,
+               const uint8_t* payload, size_t len, uint64_t receive_ns);
+
+    // Consistent copy of the cached samples, oldest first
+    std::vector<CachedSample> snapshot() const;
+
+    bool empty() const { return head_.load(std::memory_order_acquire) == 0; }
+
+private:
+    struct Slot {
+        std::atomic<uint32_t> sequence{0};   // Odd while a write is in progress
+        uint64_t receive_ns = 0;
+        uint32_t key_size = 0;
+        uint32_t encoding_size = 0;
+        uint32_t payload_size = 0;
+        std::unique_ptr<uint8_t[]> data;     // key | encoding | payload
+    };
+
+    // Copy one slot, false if it was overwritten during the read
+    bool readSlot(const Slot& slot, CachedSample& out) const;
+
+private:
+    size_t depth_;
+    size_t capacity_;                        // Bytes per slot
+    std::vector<Slot> slots_;
+    std::atomic<uint64_t> head_{0};          // Total samples stored
+    std::atomic_flag write_lock_ = ATOMIC_FLAG_INIT;
+};
+
+} // namespace data_bridge
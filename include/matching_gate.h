@@ -0,0 +1,77 @@
+#pragma once
+
+#include "common.h"
+#include <zenoh.hxx>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+
+namespace data_bridge {
+
+/**
+ * @brief Matching Gate - Whether anyone subscribes to what a producer publishes
+ *
+ * Attached to a Zenoh publisher, the gate follows its matching status. A
+ * producer checks matched() before reading, transforming and compressing the
+ * next sample and skips that work while no subscriber matches; wait() parks
+ * it until the first subscriber appears, which the matching listener
+ * signals right away.
+ */
+class MatchingGate {
+public:
+    MatchingGate() = default;
+    ~MatchingGate();
+
+    MatchingGate(const MatchingGate&) = delete;
+    MatchingGate& operator=(const MatchingGate&) = delete;
+
+    // Follow a publisher (plain or advanced), which must outlive the gate's use.
+    // False if matching is unavailable, the gate then stays open.
+    template <class Publisher>
+    bool attach(const Publisher& publisher);
+
+    bool matched() const { return matched_.load(std::memory_order_acquire); }
+
+    // Wait until a subscriber matches, release() is called or timeout passes, true if matched
+    bool wait(std::chrono::milliseconds timeout);
+
+    // Wake current and future waiters, e.g. for shutdown
+    void release();
+
+    // Times the status changed to matched
+    uint64_t matches() const { return matches_.load(std::memory_order_relaxed); }
+
+private:
+    void update(bool matching);
+
+private:
+    std::atomic<bool> matched_{true};     // Open until the publisher reports otherwise
+    std::atomic<bool> released_{false};
+    std::atomic<uint64_t> matches_{0};
+    std::optional<zenoh::MatchingListener<void>> listener_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+};
+
+template <class Publisher>
+bool MatchingGate::attach(const Publisher& publisher) {
+    try {
+        zenoh::ZResult result = Z_OK;
+        listener_.emplace(publisher.declare_matching_listener(
+            [this](const zenoh::MatchingStatus& status) { update(status.matching); },
+            []() {}, &result));
+        if (result != Z_OK) {
+            listener_.reset();
+            return false;
+        }
+        // The listener only reports changes
+        update(publisher.get_matching_status().matching);
+    } catch (const std::exception& e) {
+        std::cerr << "[MatchingGate] Matching status unavailable: " << e.what() << std::endl;
+        listener_.reset();
+        return false;
+    }
+    return true;
+}
+
+} // namespace data_bridge
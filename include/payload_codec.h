@@ -0,0 +1,75 @@
+#pragma once
+
+#include "common.h"
+#include "buffer_pool.h"
+#include <zenoh.hxx>
+#include <optional>
+
+namespace data_bridge {
+
+/**
+ * @brief Payload Codec - Per-stream compression transform stage
+ *
+ * Compressed samples carry their codec in the Zenoh encoding schema
+ * ("zenoh/bytes;lz4" or "zenoh/bytes;zstd"), payloads below the stream
+ * threshold are sent untouched with no marker. Compression contexts and
+ * output buffers are thread-local and reused, decompressed payloads go into
+ * pooled buffers, so the steady state does not allocate per message.
+ * Returned views stay valid until the next call on the same thread.
+ *
+ * LZ4 payloads are prefixed with the original size (4 bytes, little endian),
+ * zstd frames carry it themselves.
+ */
+class PayloadCodec {
+public:
+    explicit PayloadCodec(const StreamConfig& config);
+    ~PayloadCodec();
+
+    PayloadCodec(const PayloadCodec&) = delete;
+    PayloadCodec& operator=(const PayloadCodec&) = delete;
+
+    // Load the zstd dictionary configured for the stream (no-op without one)
+    bool init();
+
+    // Compress if the stream has a codec and the payload reaches the threshold.
+    // On pass-through, out == input and encoding is left unset.
+    bool compress(ByteView input, ByteView& out, std::optional<zenoh::Encoding>& encoding);
+
+    // Decompress according to the sample encoding, pass-through if unmarked
+    bool decompress(const zenoh::Encoding& encoding, ByteView input, ByteView& out);
+
+    // Same into a pooled buffer the caller can keep, codec from fromEncoding().
+    // Unmarked input is shared, not copied.
+    bool decompress(CompressionType codec, const PayloadBuffer& input, PayloadBuffer& out);
+
+    CompressionType type() const { return type_; }
+
+    // Parse a codec name ("none", "lz4", "zstd")
+    static bool parseType(const std::string& name, CompressionType& type);
+
+    // Whether support for the codec was compiled in
+    static bool isAvailable(CompressionType type);
+
+    // Codec marked in the encoding, NONE if unmarked
+    static CompressionType fromEncoding(const zenoh::Encoding& encoding);
+
+    static const zenoh::Encoding& encodingFor(CompressionType type);
+
+private:
+    bool compressLZ4(ByteView input, ByteView& out);
+    bool decompressLZ4(ByteView input, PayloadBuffer& out);
+    bool compressZSTD(ByteView input, ByteView& out);
+    bool decompressZSTD(ByteView input, PayloadBuffer& out);
+
+private:
+    CompressionType type_;
+    size_t min_size_;
+    int level_;
+    std::string dictionary_path_;
+
+    // Digested dictionaries are immutable and shared by all threads
+    void* zstd_cdict_ = nullptr;
+    void* zstd_ddict_ = nullptr;
+};
+
+} // namespace data_bridge
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "common.h"
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <sys/socket.h>
+
+namespace data_bridge {
+
+// Kind byte of a frame sent back to a polling consumer
+enum class PollReplyKind : uint8_t {
+    SAMPLE = 0,     // One reply sample
+    ERROR = 1,      // One error reply, payload is the error text
+    END = 2         // No more frames for this request
+};
+
+struct PollStats {
+    uint64_t requests = 0;            // Polls received from local consumers
+    uint64_t queries = 0;             // Queries sent upstream
+    uint64_t coalesced = 0;           // Polls served by another poll's query
+    uint64_t replies = 0;             // Reply frames sent
+    uint64_t unavailable = 0;         // Queries that could not be sent (no session)
+    uint64_t send_failures = 0;       // Frames a consumer did not take, its connection is closed
+};
+
+/**
+ * @brief Poll Server - Answers local polls with one shared upstream query
+ *
+ * Local consumers send a poll on a UDP, TCP or Unix stream socket:
+ *
+ *     [u64 request id, little-endian][query parameters]
+ *
+ * and get back, for that request id, every reply followed by an end frame:
+ *
+ *     [u64 request id][u8 PollReplyKind][payload]
+ *
+ * Stream sockets prefix both with their u32 length. Polls with the same
+ * parameters are single-flight: while one query is running, or within
+ * coalesce_ms after it finished, later polls receive its replies instead of
+ * starting another query. The query itself is started through a callback, so
+ * the Zenoh querier stays with its session.
+ */
+class PollServer {
+public:
+    // Start the upstream query of a flight, false if it could not be sent. Called on the server thread.
+    using QueryFunction = std::function<bool(const std::string& parameters, uint64_t flight)>;
+
+    explicit PollServer(const PollConfig& config);
+    ~PollServer();
+
+    PollServer(const PollServer&) = delete;
+    PollServer& operator=(const PollServer&) = delete;
+
+    // inherited: listener of a predecessor bridge (restart handoff), -1 opens a new one
+    bool start(QueryFunction query, int inherited = -1);
+    void stop();
+
+    // Listening (or UDP) socket, -1 if not started
+    int listener() const { return listen_fd_; }
+
+    // A successor bridge serves the listener now: stop() leaves the Unix socket file in place
+    void handOver() { handed_over_ = true; }
+
+    // Reply of a flight's query, from any thread
+    void deliver(uint64_t flight, PollReplyKind kind, std::vector<uint8_t> payload);
+
+    // The flight's query finished, from any thread
+    void complete(uint64_t flight);
+
+    PollStats getStats() const;
+
+    // "udp://host:port", "tcp://host:port" or "unix://path"
+    std::string describe() const;
+
+private:
+    // Where a poll came from: a UDP address, or a stream connection
+    struct Requester {
+        uint64_t connection = 0;              // 0 for UDP
+        sockaddr_storage address{};
+        socklen_t address_len = 0;
+        uint64_t request_id = 0;
+    };
+
+    struct Reply {
+        PollReplyKind kind;
+        std::vector<uint8_t> payload;
+    };
+
+    struct Flight {
+        std::string parameters;
+        std::vector<Requester> waiters;
+        std::vector<Reply> replies;           // Kept for polls joining later
+        bool done = false;
+        int64_t expires_ns = 0;               // Steady clock: done, forgotten after coalesce_ms; else force-completed
+    };
+
+    struct Connection {
+        int fd = -1;
+        std::vector<uint8_t> input;           // Bytes of incomplete polls
+    };
+
+    void serverLoop();
+    bool openListener();
+    void acceptConnections();
+
+    // Read the polls of a connection into polls, false once it is closed
+    bool readConnection(uint64_t id, Connection& connection,
+                        std::vector<std::pair<Requester, std::string>>& polls);
+    void receiveDatagrams();
+    void onPoll(const Requester& requester, std::string parameters);
+
+    // Drop finished flights after the window, complete stuck ones
+    void expireFlights();
+
+    // With mutex_ held
+    void finishLocked(uint64_t flight);
+    void sendLocked(const Requester& requester, PollReplyKind kind, const uint8_t* data, size_t len);
+    void closeLocked(uint64_t connection);
+
+private:
+    PollConfig config_;
+    bool stream_;                             // TCP or Unix framing
+    int listen_fd_ = -1;
+    std::atomic<bool> handed_over_{false};
+    std::atomic<bool> running_{false};
+    std::thread server_thread_;
+    QueryFunction query_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, Flight> flights_;
+    std::map<std::string, uint64_t> by_parameters_;    // Flight that new polls with these parameters join
+    std::unordered_map<uint64_t, Connection> connections_;
+    uint64_t next_flight_ = 1;
+    uint64_t next_connection_ = 1;
+    std::vector<uint8_t> frame_;              // Scratch buffer of sendLocked
+
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> queries_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<uint64_t> replies_{0};
+    std::atomic<uint64_t> unavailable_{0};
+    std::atomic<uint64_t> send_failures_{0};
+};
+
+} // namespace data_bridge
@@ -1,6 +1,25 @@
 #pragma once
 
 #include "common.h"
+#include "session_supervisor.h"
+#include "payload_codec.h"
+#include "transcoder.h"
+#include "content_filter.h"
+#include "integrity.h"
+#include "capture.h"
+#include "last_value_cache.h"
+#include "consumer_registry.h"
+#include "conflation.h"
+#include "timer_wheel.h"
+#include "uring_egress.h"
+#include "destination_registry.h"
+#include "backpressure.h"
+#include "sequence_tracker.h"
+#include "service_client.h"
+#include "poll_server.h"
+#include "forwarding_executor.h"
+#include "handoff.h"
+#include "thread_placement.h"
 #include <zenoh.hxx>
 #include <sys/socket.h>
 #include <netinet/in.h>
@@ -26,46 +45,281 @@ public:
     
     // Check if running
     bool isRunning() const { return running_; }
+    
+    // Readable (eventfd) once the bridge wants to be stopped: a restarted bridge took over
+    int shutdownFd() const { return shutdown_fd_; }
+    
+    // Print session health and stream statistics
+    void printStats(std::ostream& os) const;
 
 private:
+    // One local consumer of a stream, failures are isolated per target
+    struct TargetHandler {
+        StreamTarget config;
+        std::shared_ptr<UdpDestination> destination;   // UDP only, shared with other streams to the same host:port
+        UringEgress* egress = nullptr;                 // Set when the io_uring backend serves this target
+        std::vector<int> egress_handles;               // Per destination shard
+        bool nonblocking = false;                      // Drop instead of waiting on a full socket buffer
+        BackpressureAction backpressure = BackpressureAction::NONE;
+        int backpressure_priority = 0;
+        int64_t backpressure_max_wait_ns = 0;
+        std::atomic<uint64_t> sent{0};
+        std::atomic<uint64_t> failed{0};
+        std::atomic<uint64_t> skipped{0};              // Samples not sent while suspended
+        std::atomic<uint64_t> shed{0};                 // Samples dropped under backpressure
+        std::atomic<uint64_t> throttled{0};            // Samples that waited for the consumer
+        std::atomic<int> consecutive_failures{0};
+        std::atomic<int64_t> suspended_until_ns{0};    // Steady clock
+    };
+    
     // Single stream handler
     struct StreamHandler {
         StreamConfig config;
         std::unique_ptr<zenoh::Subscriber<void>> subscriber;
-        int udp_socket = -1;
-        struct sockaddr_in udp_addr;
+        std::unique_ptr<zenoh::ext::AdvancedSubscriber<void>> advanced_subscriber;  // Recoverable streams instead
+        std::unique_ptr<zenoh::Subscriber<zenoh::channels::RingHandler<zenoh::Sample>>> ring_subscriber;  // Pull streams
+        std::unique_ptr<zenoh::Subscriber<zenoh::channels::FifoHandler<zenoh::Sample>>> fifo_subscriber;
+        std::vector<std::unique_ptr<TargetHandler>> targets;
+        std::unique_ptr<PayloadCodec> codec;
+        std::unique_ptr<Transcoder> transcoder;        // Set when transcode_schema is configured
+        std::unique_ptr<ContentFilter> filter;         // Set when filters or filter_duplicates are configured
+        std::unique_ptr<LastValueCache> cache;
+        std::unique_ptr<zenoh::Queryable<void>> queryable;
+        std::atomic<uint64_t> cache_primes{0};
+        std::atomic<uint64_t> cache_queries{0};
+        std::unique_ptr<Conflater> conflater;
+        std::unique_ptr<SequenceTracker> sequence;     // Set when sequence_source is configured
+        std::atomic<uint64_t> unsequenced{0};          // Samples without a sequence number
+        std::atomic<uint64_t> verified{0};             // Samples whose integrity trailer matched
+        std::atomic<uint64_t> integrity_failures{0};   // Trailer missing or mismatched, dropped
+        std::atomic<uint64_t> decompress_failures{0};
+        std::atomic<uint64_t> transcode_failures{0};   // Samples that did not match the schema, dropped
+        std::atomic<uint64_t> forward_failures{0};     // Samples at least one target did not get
+        std::atomic<uint64_t> unrecovered{0};          // Samples Zenoh reported lost for good (recoverable streams)
+        int forward_id = -1;                           // Executor stream, forwards on the Zenoh callback if -1
+        std::mutex pull_mutex;                         // One drain at a time, and none while re-declaring
+        std::atomic<bool> drain_pending{false};        // Drain task posted and not started yet
+        std::vector<PayloadBuffer> pull_batch;         // Guarded by pull_mutex
+        std::vector<ByteView> pull_views;
+        std::atomic<uint64_t> drains{0};
+        std::atomic<uint64_t> drained{0};
+        std::atomic<uint64_t> full_drains{0};          // Drains that hit ingest_batch
+        std::unique_ptr<zenoh::LivelinessToken> token; // Announces the subscription (liveliness_prefix set)
+        std::mutex activation_mutex;                   // Taken inside the supervisor lock, never around it
+        bool consumer_active = false;                  // Lazy streams: a consumer is registered, guarded by activation_mutex
+        bool declared = false;                         // Subscribed on the current session, guarded by activation_mutex
+        std::atomic<int64_t> release_at_ns{0};         // Lazy streams: steady clock time the subscription is dropped
+        std::atomic<uint64_t> activations{0};
+        std::atomic<uint64_t> deactivations{0};
         // TODO: Add gRPC client stub for gRPC protocol
-        
-        ~StreamHandler();
+    };
+    
+    // Local service answering Zenoh queries
+    struct ServiceHandler {
+        ServiceConfig config;
+        std::unique_ptr<ServiceClient> client;
+        std::unique_ptr<zenoh::Queryable<void>> queryable;
+        std::atomic<uint64_t> queries{0};
+        std::atomic<uint64_t> reply_failures{0};       // Replies Zenoh did not accept
+    };
+    
+    // Local pollers answered through a Zenoh querier
+    struct PollHandler {
+        PollConfig config;
+        std::unique_ptr<PollServer> server;
+        std::unique_ptr<zenoh::Querier> querier;       // Guarded by the supervisor lock
+        std::atomic<uint64_t> query_failures{0};       // Queries Zenoh did not accept
     };
     
     // Initialize a single stream
     bool initStream(StreamHandler& handler);
     
+    // Initialize one local target of a stream
+    bool initTarget(TargetHandler& target);
+    
+    // Hand UDP targets to io_uring engines (egress_backend = "io_uring")
+    void initEgress();
+    
+    // Register streams with the forwarding executor and start its workers
+    void initExecutor();
+    
+    // Declare the Zenoh subscriber (and cache queryable) of a stream on the given session
+    bool declareStream(StreamHandler& handler, zenoh::Session& session);
+    
+    // Declare an advanced subscriber that recovers lost samples (recoverable streams)
+    template <class OnSample, class OnDrop>
+    void declareRecoverable(StreamHandler& handler, zenoh::Session& session, OnSample& on_sample, OnDrop& on_drop);
+    
+    // Undeclare the subscriber, queryable and liveliness token of a stream, pull channels are drained first
+    void undeclareStream(StreamHandler& handler);
+    
+    // Re-declare all streams after the supervisor switched sessions
+    void redeclareStreams(zenoh::Session& session);
+    
+    // Start the client of a local service
+    bool initService(ServiceHandler& service);
+    
+    // Declare the queryable of a local service on the given session
+    bool declareService(ServiceHandler& service, zenoh::Session& session);
+    
+    // Re-declare all service queryables after the supervisor switched sessions
+    void redeclareServices(zenoh::Session& session);
+    
+    // Pass a Zenoh query to the local service, replied to once the service answers
+    void onServiceQuery(ServiceHandler& service, const zenoh::Query& query);
+    
+    // Start the server of a local poll endpoint
+    bool initPoll(PollHandler& poll);
+    
+    // Declare the querier of a poll endpoint on the given session
+    bool declarePoll(PollHandler& poll, zenoh::Session& session);
+    
+    // Re-declare all poll queriers after the supervisor switched sessions
+    void redeclarePolls(zenoh::Session& session);
+    
+    // Send the query of a poll flight, its replies go back to the poll server
+    bool startPollQuery(PollHandler& poll, const std::string& parameters, uint64_t flight);
+    
+    // Subscribe a lazy stream once a consumer registers
+    void activateStream(StreamHandler& handler);
+    
+    // Undeclare lazy streams whose consumer left more than consumer_grace_ms ago
+    void expireConsumers();
+    
+    // Re-send the cached samples of a stream to its local consumer
+    void primeStream(StreamHandler& handler);
+    
+    // Send the conflated samples of a stream to its local consumer
+    void flushStream(StreamHandler& handler);
+    
+    // Handle a control message from a local consumer
+    void onConsumerMessage(ConsumerMessage message, const std::string& topic);
+    
+    // Answer a Zenoh query from the stream cache
+    void onCacheQuery(StreamHandler& handler, const zenoh::Query& query);
+    
     // Close a single stream
     void closeStream(StreamHandler& handler);
     
+    // Stop taking in samples, queries and polls, then forward what is queued within drain_timeout_ms.
+    // Runs once, on stop() or when a successor took over.
+    void retire();
+    
+    // Sockets and caches passed to a restarted bridge (handoff_path set)
+    HandoffOffer offerHandoff();
+    
+    // The successor forwards now: retire and ask to be stopped
+    void handOver();
+    
+    // Caches and lazy stream consumers received from the previous bridge
+    void adoptHandoff();
+    
+    // Sockets of a name received from the previous bridge, empty without a handoff
+    std::vector<int> inheritedSockets(const std::string& name);
+    int inheritedSocket(const std::string& name);
+    
     // Zenoh callback for receiving data
-    void onDataReceived(const StreamConfig& config, const zenoh::Sample& sample);
+    void onDataReceived(StreamHandler& handler, const zenoh::Sample& sample);
+    
+    // Copy a received sample into bytes, capture, cache and check its sequence number.
+    // Returns false for a duplicate on a recoverable stream, which is dropped.
+    bool receiveSample(StreamHandler& handler, const zenoh::Sample& sample, PayloadBuffer& bytes);
+    
+    // Drain a pull stream on a forwarding worker, or right here without one
+    void requestDrain(StreamHandler& handler);
+    
+    // Forward one batch from a pull stream's channel, returns the samples taken
+    size_t drainStream(StreamHandler& handler);
+    
+    // Same with pull_mutex held
+    template <class Channel>
+    size_t drainChannel(StreamHandler& handler, const Channel& channel);
+    
+    // Check a decompressed payload's integrity trailer and strip it (integrity_strip).
+    // Returns false if it does not match, the sample is then dropped.
+    bool verifyPayload(StreamHandler& handler, PayloadBuffer& data);
+    
+    // Record the sequence number in a decompressed payload's header (PAYLOAD_HEADER streams).
+    // Returns false for a duplicate on a recoverable stream, which is dropped.
+    bool trackPayloadSequence(StreamHandler& handler, const PayloadBuffer& data);
+    
+    // Filter a decompressed sample and convert it to the consumer's format in place.
+    // Returns false if it is filtered out or does not match the schema, it is then dropped.
+    bool prepareSample(StreamHandler& handler, PayloadBuffer& data);
+    
+    // Decompress a received sample and forward it to the stream's targets
+    void forwardSample(StreamHandler& handler, CompressionType codec, const PayloadBuffer& bytes);
+    
+    // Forward data to every target of the stream, owner (optional) keeps data alive for zero-copy sends.
+    // Returns false if any target failed.
+    bool forwardData(StreamHandler& handler, const uint8_t* data, size_t len,
+                     const PayloadBuffer& owner = PayloadBuffer());
     
-    // Forward data based on protocol type
-    bool forwardData(StreamHandler& handler, const uint8_t* data, size_t len);
+    // Forward several samples at once, returns the most any target received
+    size_t forwardBatch(StreamHandler& handler, const ByteView* items, size_t count);
+    
+    // Forward to one target based on its protocol
+    bool forwardToTarget(StreamHandler& handler, TargetHandler& target, const uint8_t* data, size_t len,
+                         const PayloadBuffer& owner);
+    
+    // Skip targets suspended after repeated failures
+    bool isSuspended(TargetHandler& target) const;
+    
+    // Apply the stream's backpressure action, false if the sample is shed
+    bool admit(TargetHandler& target);
+    
+    // Update failure accounting, suspends a target that keeps failing while another one works
+    void recordResult(StreamHandler& handler, TargetHandler& target, bool success, uint64_t count = 1);
     
     // UDP specific forwarding
-    bool forwardViaUDP(StreamHandler& handler, const uint8_t* data, size_t len);
+    bool forwardViaUDP(TargetHandler& target, const uint8_t* data, size_t len,
+                       const PayloadBuffer& owner);
     
     // gRPC specific forwarding
-    bool forwardViaGRPC(StreamHandler& handler, const uint8_t* data, size_t len);
+    bool forwardViaGRPC(TargetHandler& target, const uint8_t* data, size_t len);
 
 private:
     BridgeConfig config_;
     std::atomic<bool> running_{false};
     
-    // Zenoh session (will be initialized in start())
-    zenoh::Session session_;
+    // Zenoh session, owned and kept connected by the supervisor
+    SessionSupervisor supervisor_;
     
     // Stream handlers
     std::vector<std::unique_ptr<StreamHandler>> handlers_;
+    
+    // Local services exposed as queryables
+    std::vector<std::unique_ptr<ServiceHandler>> services_;
+    
+    // Local poll endpoints forwarded as Zenoh queries
+    std::vector<std::unique_ptr<PollHandler>> polls_;
+    
+    // Local UDP destinations, deduplicated across streams
+    DestinationRegistry destinations_;
+    
+    // Optional capture of received samples (capture_dir set)
+    std::unique_ptr<CaptureWriter> capture_;
+    
+    // Optional local consumer registration (registration_port set)
+    std::unique_ptr<ConsumerRegistry> registry_;
+    
+    // Samples destination socket queues (backpressure_interval_ms set)
+    std::unique_ptr<BackpressureMonitor> backpressure_;
+    
+    // Drives rate conflation of all streams (created when any stream uses it)
+    std::unique_ptr<TimerWheel> timer_wheel_;
+    
+    // io_uring egress engines, each owns a group of UDP streams
+    std::vector<std::unique_ptr<UringEgress>> egress_;
+    
+    // Forwarding worker pool (forwarding_workers set)
+    std::unique_ptr<ForwardingExecutor> executor_;
+    
+    // Restart handoff (handoff_path set)
+    std::unique_ptr<Handoff> handoff_;
+    std::atomic<bool> retired_{false};
+    bool drained_ = true;                              // The last retire() forwarded everything in time
+    int shutdown_fd_ = -1;
 };
 
 } // namespace data_bridge
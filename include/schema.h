@@ -0,0 +1,138 @@
+#pragma once
+
+#include "common.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace data_bridge {
+
+// Packed schema structs are a little-endian wire format, read and written in place
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "schema structs need a little-endian host");
+
+template <FieldType> struct FieldStorage;
+template <> struct FieldStorage<FieldType::BOOL> { using type = bool; };
+template <> struct FieldStorage<FieldType::INT32> { using type = int32_t; };
+template <> struct FieldStorage<FieldType::UINT32> { using type = uint32_t; };
+template <> struct FieldStorage<FieldType::INT64> { using type = int64_t; };
+template <> struct FieldStorage<FieldType::UINT64> { using type = uint64_t; };
+template <> struct FieldStorage<FieldType::FLOAT> { using type = float; };
+template <> struct FieldStorage<FieldType::DOUBLE> { using type = double; };
+
+// One decoded field: INT32/INT64 in i, UINT32/UINT64/BOOL in u, FLOAT/DOUBLE in d
+union FieldValue {
+    int64_t i;
+    uint64_t u;
+    double d;
+};
+
+struct SchemaField {
+    const char* name;
+    FieldType type;
+    uint32_t number;                  // Protobuf field number
+    uint32_t offset;                  // In the packed struct
+    uint32_t size;
+};
+
+struct SchemaDescriptor {
+    const char* name;
+    const SchemaField* fields;        // In declaration order
+    size_t field_count;
+    size_t struct_size;
+};
+
+// Most fields in one schema, transcoding keeps one value per field on the stack
+constexpr size_t kMaxSchemaFields = 64;
+
+// Protobuf field numbers above this are reserved
+constexpr uint32_t kMaxFieldNumber = (1u << 29) - 1;
+
+constexpr bool schemaNamesEqual(const char* a, const char* b) {
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+// Field numbers in range and unique, names unique
+constexpr bool schemaFieldsValid(const SchemaField* fields, size_t count) {
+    if (count == 0 || count > kMaxSchemaFields) {
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        if (fields[i].number == 0 || fields[i].number > kMaxFieldNumber) {
+            return false;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (fields[i].number == fields[j].number || schemaNamesEqual(fields[i].name, fields[j].name)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Field from its little-endian bytes (struct layout)
+FieldValue loadFieldValue(FieldType type, const uint8_t* data);
+
+// Little-endian bytes of a field, returns its size
+size_t storeFieldValue(FieldType type, const FieldValue& value, uint8_t* out);
+
+// Size of a field in struct layout
+constexpr size_t fieldTypeSize(FieldType type) {
+    switch (type) {
+        case FieldType::BOOL: return 1;
+        case FieldType::INT32:
+        case FieldType::UINT32:
+        case FieldType::FLOAT: return 4;
+        default: return 8;
+    }
+}
+
+// Specialized for every schema struct by DATA_BRIDGE_DEFINE_SCHEMA
+template <class T> struct SchemaTraits;
+
+// View a packed struct payload in place, nullptr if its size does not match the schema
+template <class T>
+const T* schemaView(ByteView bytes) {
+    static_assert(alignof(T) == 1, "schema structs are packed");
+    return bytes.size == sizeof(T) ? reinterpret_cast<const T*>(bytes.data) : nullptr;
+}
+
+// Schema compiled into the bridge, nullptr if unknown
+const SchemaDescriptor* findSchema(const std::string& name);
+
+// Names of all compiled schemas, comma separated (for error messages)
+std::string schemaNames();
+
+} // namespace data_bridge
+
+/*
+ * Schema IDL: a schema is a list of FIELD(number, TYPE, name) entries, see
+ * bridge_schemas.h. DATA_BRIDGE_DEFINE_SCHEMA(Name, "label", FIELDS), used
+ * inside namespace data_bridge, expands the list into the packed struct
+ * data_bridge::schemas::Name and a SchemaTraits<schemas::Name>
+ * specialization holding its constexpr descriptor. Field numbers and names
+ * are checked at compile time.
+ */
+#define DATA_BRIDGE_SCHEMA_MEMBER(number, kind, name) \
+    ::data_bridge::FieldStorage<::data_bridge::FieldType::kind>::type name;
+
+#define DATA_BRIDGE_SCHEMA_FIELD(number, kind, name) \
+    {#name, ::data_bridge::FieldType::kind, number, static_cast<uint32_t>(offsetof(Type, name)), \
+     static_cast<uint32_t>(sizeof(Type::name))},
+
+#define DATA_BRIDGE_DEFINE_SCHEMA(Name, label, FIELDS) \
+    namespace schemas { \
+    struct __attribute__((packed)) Name { \
+        FIELDS(DATA_BRIDGE_SCHEMA_MEMBER) \
+    }; \
+    } \
+    template <> struct SchemaTraits<schemas::Name> { \
+        using Type = schemas::Name; \
+        static constexpr SchemaField fields[] = { FIELDS(DATA_BRIDGE_SCHEMA_FIELD) }; \
+        static constexpr size_t field_count = sizeof(fields) / sizeof(fields[0]); \
+        static_assert(schemaFieldsValid(fields, field_count), \
+                      "schema " label ": field numbers and names must be unique"); \
+        static constexpr SchemaDescriptor descriptor{label, fields, field_count, sizeof(Type)}; \
+    };
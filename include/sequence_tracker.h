@@ -0,0 +1,89 @@
+#pragma once
+
+#include "common.h"
+#include <array>
+#include <mutex>
+#include <unordered_map>
+
+namespace data_bridge {
+
+// Optional header at the start of a (decompressed) payload carrying its sequence number
+struct SequenceHeader {
+    uint64_t publisher = 0;           // Any id unique per publisher, little-endian on the wire
+    uint64_t sequence = 0;            // Incremented by one per sample
+};
+
+struct SequenceStats {
+    uint64_t publishers = 0;          // Publishers seen
+    uint64_t received = 0;            // Samples carrying a sequence number
+    uint64_t lost = 0;                // Sequence numbers skipped and not (yet) seen
+    uint64_t reordered = 0;           // Arrived after a later sequence number, filled a gap
+    uint64_t duplicates = 0;          // Sequence number already seen
+    uint64_t stale = 0;               // Further behind than the window, cannot tell whether seen
+    uint64_t resets = 0;              // Restarted counting from lower numbers (publisher restart)
+
+    // Share of expected samples that never arrived
+    double lossRate() const {
+        uint64_t expected = received - duplicates - stale + lost;
+        return expected > 0 ? static_cast<double>(lost) / static_cast<double>(expected) : 0.0;
+    }
+};
+
+/**
+ * @brief Sequence Tracker - Gap, reorder and duplicate detection per publisher
+ *
+ * Each publisher keeps a sliding bitmap of the last kWindow sequence numbers
+ * below its highest one. A jump ahead counts the skipped numbers as lost; a
+ * number arriving late inside the window is marked in the bitmap and taken
+ * off the lost count, so every sample costs O(1) whatever the loss pattern.
+ * A number further back than the window is stale and reported as seen; only
+ * kRestartRun consecutive stale numbers restart the window there, as from a
+ * publisher that restarted under the same id.
+ */
+class SequenceTracker {
+public:
+    static constexpr size_t kWindow = 1024;
+    static constexpr uint32_t kRestartRun = 16;
+
+    // Publisher id from a Zenoh SourceInfo (zid and entity id)
+    static uint64_t publisherId(const uint8_t* zid, size_t zid_size, uint32_t eid);
+
+    // Read the header at the start of a payload, false if it is too short
+    static bool readHeader(const uint8_t* data, size_t len, SequenceHeader& header);
+
+    // Write the header at the start of a payload, false if it is too short
+    static bool writeHeader(const SequenceHeader& header, uint8_t* data, size_t len);
+
+    // Record a 64-bit sequence number, false if it was already seen or is stale
+    bool observe(uint64_t publisher, uint64_t sequence);
+
+    // Record a 32-bit sequence number that wraps around (Zenoh SourceInfo)
+    bool observeWrapping(uint64_t publisher, uint32_t sequence);
+
+    SequenceStats getStats() const;
+
+private:
+    struct Window {
+        uint64_t first = 0;                            // First number since the (re)start, nothing below was skipped
+        uint64_t highest = 0;
+        std::array<uint64_t, kWindow / 64> seen{};    // Bit (sequence % kWindow) for highest - kWindow < sequence <= highest
+        uint64_t stale_next = 0;                       // Number continuing the current run of stale ones
+        uint32_t stale_run = 0;
+    };
+
+    // Window of a publisher, opened with sequence on first use (created set), nullptr past the limit
+    Window* findWindow(uint64_t publisher, uint64_t sequence, bool& created);
+    bool observeLocked(Window& window, uint64_t sequence);
+    void restart(Window& window, uint64_t sequence);
+
+    static bool testBit(const Window& window, uint64_t sequence);
+    static void setBit(Window& window, uint64_t sequence);
+    static void clearBit(Window& window, uint64_t sequence);
+
+private:
+    mutable std::mutex mutex_;        // Zenoh may deliver one subscriber's samples from several threads
+    std::unordered_map<uint64_t, Window> windows_;
+    SequenceStats stats_;
+};
+
+} // namespace data_bridge
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "common.h"
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+namespace data_bridge {
+
+// Outcome of one request to a local service
+enum class ServiceResult {
+    OK,
+    TIMEOUT,            // No response within timeout_ms
+    DISCONNECTED        // Connection lost, or the client stopped, before the response
+};
+
+const char* serviceResultName(ServiceResult result);
+
+struct ServiceStats {
+    uint64_t requests = 0;            // Accepted by submit
+    uint64_t responses = 0;
+    uint64_t timeouts = 0;
+    uint64_t disconnected = 0;
+    uint64_t rejected = 0;            // Refused at max_outstanding
+    uint64_t late = 0;                // Responses after their request timed out
+    uint64_t connects = 0;            // Stream sockets only
+    size_t outstanding = 0;           // Queued plus in flight
+};
+
+/**
+ * @brief Service Client - Pipelined requests to one local service
+ *
+ * Every request carries a 64-bit id that the service copies into its
+ * response, so up to `window` requests are on the wire at once and the
+ * responses may come back in any order. UDP sends one request or response
+ * per datagram:
+ *
+ *     [u64 request id, little-endian][payload]
+ *
+ * TCP and Unix stream sockets prefix the same bytes with their u32 length.
+ * Requests beyond the window wait in submit order. Each request is answered
+ * timeout_ms after submit at the latest, sent or not, and submit refuses new
+ * ones while max_outstanding are pending. One I/O thread owns the socket,
+ * reconnects stream sockets and runs every callback.
+ */
+class ServiceClient {
+public:
+    // Called exactly once per accepted request, on the I/O thread. data is the response payload (OK only).
+    using ReplyCallback = std::function<void(ServiceResult result, const uint8_t* data, size_t len)>;
+
+    explicit ServiceClient(const ServiceConfig& config);
+    ~ServiceClient();
+
+    ServiceClient(const ServiceClient&) = delete;
+    ServiceClient& operator=(const ServiceClient&) = delete;
+
+    bool start();
+
+    // Stop the I/O thread, pending requests are answered with DISCONNECTED
+    void stop();
+
+    // Queue a request, false if max_outstanding requests are pending (the callback is not called)
+    bool submit(const uint8_t* data, size_t len, ReplyCallback callback);
+
+    ServiceStats getStats() const;
+
+    // "udp://host:port", "tcp://host:port" or "unix://path"
+    std::string describe() const;
+
+private:
+    struct Request {
+        uint64_t id = 0;
+        int64_t deadline_ns = 0;              // Steady clock
+        std::vector<uint8_t> frame;           // As sent, released once on the wire
+        ReplyCallback callback;
+    };
+
+    void ioLoop();
+    // Start connecting, false if it failed right away. TCP completes in finishConnect() once writable.
+    bool connectService();
+    void finishConnect();
+    void connectFailed(int error);
+    void connected();
+    void disconnect(const char* reason);
+
+    // Move waiting requests into the window and write them, false on a connection error
+    bool sendRequests();
+    bool flushOutput();
+
+    // Read and dispatch responses, false on a connection error
+    bool receiveResponses();
+    void dispatch(const uint8_t* data, size_t len);
+
+    void expire(int64_t now_ns);
+    int pollTimeoutMs(int64_t now_ns) const;
+    void finish(Request& request, ServiceResult result, const uint8_t* data = nullptr, size_t len = 0);
+
+private:
+    ServiceConfig config_;
+    bool stream_;                             // TCP or Unix framing
+    std::atomic<bool> running_{false};
+    std::thread io_thread_;
+    int wakeup_fd_ = -1;
+
+    // Submitted and not yet taken by the I/O thread
+    std::mutex submit_mutex_;
+    std::deque<Request> submitted_;
+    std::atomic<size_t> outstanding_{0};
+    std::atomic<uint64_t> next_id_{1};
+
+    // I/O thread only
+    int socket_ = -1;
+    int64_t reconnect_at_ns_ = 0;
+    bool connecting_ = false;                              // TCP connect in progress on socket_
+    int64_t connect_deadline_ns_ = 0;
+    bool connect_failed_ = false;                          // Reported once until the next success
+    std::deque<Request> waiting_;                          // Outside the window, in submit order
+    std::unordered_map<uint64_t, Request> in_flight_;
+    std::deque<std::pair<int64_t, uint64_t>> deadlines_;   // Of in_flight_, in send order
+    std::vector<uint8_t> output_;                          // Stream sockets: frames not fully written
+    size_t output_offset_ = 0;
+    std::vector<uint8_t> input_;                           // Stream sockets: bytes of incomplete responses
+    std::vector<uint8_t> datagram_;
+
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> responses_{0};
+    std::atomic<uint64_t> timeouts_{0};
+    std::atomic<uint64_t> disconnected_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> late_{0};
+    std::atomic<uint64_t> connects_{0};
+};
+
+} // namespace data_bridge
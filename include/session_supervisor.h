@@ -0,0 +1,112 @@
+#pragma once
+
+#include "common.h"
+#include <zenoh.hxx>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <random>
+
+namespace data_bridge {
+
+// Snapshot of session health counters
+struct SupervisorStats {
+    bool connected = false;
+    uint64_t disconnects = 0;         // Number of detected router losses
+    uint64_t reconnects = 0;          // Number of recoveries (in-session or via new session)
+    uint64_t failovers = 0;           // Recoveries that swapped to a new/standby session
+    uint64_t total_downtime_ms = 0;   // Accumulated downtime, including the current outage
+    uint64_t last_downtime_ms = 0;    // Duration of the most recent completed outage
+};
+
+/**
+ * @brief Session Supervisor - Owns the Zenoh session and keeps it connected
+ *
+ * Polls router connectivity and, when the router stays unreachable, opens a
+ * replacement session with exponential backoff plus jitter (or promotes the
+ * warm standby session if one is enabled). Declarations made on the old
+ * session are re-created through the reconnect callback.
+ */
+class SessionSupervisor {
+public:
+    // Called with the new session after a failover, under the supervisor lock
+    using ReconnectCallback = std::function<void(zenoh::Session&)>;
+
+    explicit SessionSupervisor(const BridgeConfig& config);
+    ~SessionSupervisor();
+
+    // Open the session and start the health monitor.
+    // Returns false only if the monitor could not be started; an unreachable
+    // router is retried in the background.
+    bool start();
+
+    // Stop the monitor and close all sessions
+    void stop();
+
+    void setReconnectCallback(ReconnectCallback callback);
+
+    // Run fn with the active session. Returns false if no session is open.
+    template <typename F>
+    bool withSession(F&& fn) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!primary_) {
+            return false;
+        }
+        fn(*primary_);
+        return true;
+    }
+
+    bool isConnected() const { return connected_; }
+
+    SupervisorStats getStats() const;
+
+private:
+    void monitorLoop();
+
+    // True if the session currently reaches a router (always true in peer mode)
+    bool hasConnectivity(const zenoh::Session& session) const;
+
+    // Open a new session, returns nullptr on failure
+    std::unique_ptr<zenoh::Session> openSession() const;
+
+    // Swap in a new primary session and re-declare on it
+    void promote(std::unique_ptr<zenoh::Session> session);
+
+    void markDown();
+    void markUp(bool failover);
+
+    // Time since the connection was last marked down (or since start), reads down_since_ under stats_mutex_
+    std::chrono::steady_clock::duration downFor() const;
+
+    // Next backoff delay with equal jitter, doubles the base delay each call
+    std::chrono::milliseconds nextBackoff();
+
+    // Interruptible sleep, returns false if stop was requested
+    bool waitFor(std::chrono::milliseconds delay);
+
+private:
+    BridgeConfig config_;
+    bool supervised_;                 // Router supervision applies (zenoh_connect is set)
+
+    mutable std::mutex mutex_;        // Guards primary_, standby_ and callback_
+    std::unique_ptr<zenoh::Session> primary_;
+    std::unique_ptr<zenoh::Session> standby_;
+    ReconnectCallback callback_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<bool> connected_{false};
+    std::thread monitor_thread_;
+    std::mutex wait_mutex_;
+    std::condition_variable wait_cv_;
+
+    // Backoff state (monitor thread only)
+    std::chrono::milliseconds backoff_;
+    std::mt19937 rng_;
+
+    // Health counters, stats_mutex_ guards stats_ and down_since_
+    mutable std::mutex stats_mutex_;
+    SupervisorStats stats_;
+    std::chrono::steady_clock::time_point down_since_;
+};
+
+} // namespace data_bridge
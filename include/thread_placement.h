@@ -0,0 +1,79 @@
+#pragma once
+
+#include "common.h"
+#include <mutex>
+#include <ctime>
+#include <pthread.h>
+#include <sys/types.h>
+
+namespace data_bridge {
+
+// Pin the calling thread to its CPUs and set its scheduling class. If the
+// CPUs share one NUMA node, memory the thread touches first is preferred
+// from that node. Returns false if any part could not be applied.
+bool applyThreadPlacement(const ThreadPlacement& placement, const std::string& name);
+
+// NUMA node of a CPU, -1 if unknown
+int numaNodeOfCpu(int cpu);
+
+// Short description for logs, e.g. "cpus 2,3 FIFO 80"
+std::string describePlacement(const ThreadPlacement& placement);
+
+struct ThreadUsage {
+    std::string name;
+    pid_t tid = 0;
+    int cpu = -1;                         // CPU the thread last ran on
+    int realtime_priority = 0;            // SCHED_FIFO priority, 0 for SCHED_OTHER
+    double cpu_percent = 0.0;             // Since the previous sample
+    uint64_t involuntary_switches = 0;    // Preemptions since the previous sample
+};
+
+/**
+ * @brief Thread Monitor - Per-thread CPU utilization of the bridge's threads
+ *
+ * Threads register themselves (see ThreadRegistration); sample() reports
+ * each one's CPU time and involuntary context switches since the previous
+ * sample. Preemptions of a pinned forwarding thread are what show up as
+ * worst-case latency, so they are reported next to utilization.
+ */
+class ThreadMonitor {
+public:
+    static ThreadMonitor& instance();
+
+    ThreadMonitor(const ThreadMonitor&) = delete;
+    ThreadMonitor& operator=(const ThreadMonitor&) = delete;
+
+    void add(const std::string& name);
+    void remove();
+
+    std::vector<ThreadUsage> sample();
+
+private:
+    struct Entry {
+        std::string name;
+        pthread_t thread;
+        pid_t tid = 0;
+        clockid_t clock;
+        uint64_t last_cpu_ns = 0;
+        uint64_t last_wall_ns = 0;
+        uint64_t last_switches = 0;
+    };
+
+    ThreadMonitor() = default;
+
+private:
+    std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+// Names the calling thread and keeps it registered with the monitor while in scope
+class ThreadRegistration {
+public:
+    explicit ThreadRegistration(const std::string& name);
+    ~ThreadRegistration();
+
+    ThreadRegistration(const ThreadRegistration&) = delete;
+    ThreadRegistration& operator=(const ThreadRegistration&) = delete;
+};
+
+} // namespace data_bridge
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "common.h"
+#include <functional>
+#include <mutex>
+#include <unordered_set>
+
+namespace data_bridge {
+
+/**
+ * @brief Timer Wheel - Hashed timing wheel driving all bridge timers on one thread
+ *
+ * Timers are rounded up to whole ticks. Scheduling and cancelling are O(1);
+ * each tick only visits one slot, so hundreds of periodic stream timers cost
+ * a single thread instead of one per stream. Callbacks run on the wheel
+ * thread and should be short.
+ */
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t;
+
+    explicit TimerWheel(std::chrono::microseconds tick, size_t slots = 512);
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    bool start();
+    void stop();
+
+    // Run callback every period until cancelled
+    TimerId schedulePeriodic(std::chrono::microseconds period, Callback callback);
+
+    // Run callback once after delay
+    TimerId scheduleOnce(std::chrono::microseconds delay, Callback callback);
+
+    void cancel(TimerId id);
+
+private:
+    struct Timer {
+        TimerId id;
+        uint64_t rounds;              // Full wheel turns left before firing
+        uint64_t period_ticks;        // 0 for one-shot timers
+        std::shared_ptr<Callback> callback;
+    };
+
+    void run();
+    void advance();
+    TimerId schedule(std::chrono::microseconds delay, bool periodic, Callback callback);
+    void insertLocked(Timer timer, uint64_t delay_ticks);
+    uint64_t toTicks(std::chrono::microseconds delay) const;
+
+private:
+    std::chrono::microseconds tick_;
+    std::vector<std::vector<Timer>> slots_;
+
+    std::mutex mutex_;                // Guards slots_, active_, current_tick_
+    std::unordered_set<TimerId> active_;
+    uint64_t current_tick_ = 0;
+    TimerId next_id_ = 1;
+
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+};
+
+} // namespace data_bridge
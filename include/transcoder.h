@@ -0,0 +1,83 @@
+#pragma once
+
+#include "common.h"
+#include "schema.h"
+#include "buffer_pool.h"
+
+namespace data_bridge {
+
+/**
+ * @brief Transcoder - Per-stream conversion between typed payload formats
+ *
+ * Converts samples from the publisher's wire format to the one the local
+ * consumer reads, driven by a schema compiled into the bridge (see
+ * bridge_schemas.h): packed struct, protobuf, CDR or JSON. Every field is
+ * decoded into one scalar slot on the stack and encoded straight into a
+ * pooled buffer, so the steady state does not allocate. With
+ * transcode_fields set only those fields are written, a projected struct
+ * or CDR payload packs them in schema order.
+ *
+ * Fields are scalars. Protobuf and JSON fields that are absent read as
+ * zero and unknown ones are skipped; protobuf output omits zero fields,
+ * as proto3 does.
+ */
+class Transcoder {
+public:
+    explicit Transcoder(const StreamConfig& config);
+
+    // Resolve the schema and projected fields, false if the configuration does not match them
+    bool init();
+
+    // Convert one payload into a pooled buffer, false if it does not match the schema
+    bool transcode(ByteView input, PayloadBuffer& out) const;
+
+    // Largest output of one payload
+    size_t maxOutputSize() const { return max_output_; }
+
+    // "pose: protobuf -> struct, 3 of 9 fields"
+    std::string describe() const;
+
+    // Parse a format name ("struct", "protobuf", "cdr", "json")
+    static bool parseFormat(const std::string& name, PayloadFormat& format);
+
+    static const char* formatName(PayloadFormat format);
+
+    // Decode one payload into one value per schema field (indexed like schema()->fields),
+    // every field is read even when only a projection is written
+    bool decode(ByteView input, FieldValue* values) const;
+
+    // Encode decoded values into a pooled buffer
+    bool encode(const FieldValue* values, PayloadBuffer& out) const;
+
+    const SchemaDescriptor* schema() const { return schema_; }
+
+private:
+    bool decodeStruct(ByteView input, FieldValue* values) const;
+    bool decodeProtobuf(ByteView input, FieldValue* values) const;
+    bool decodeCdr(ByteView input, FieldValue* values) const;
+    bool decodeJson(ByteView input, FieldValue* values) const;
+
+    // Encoders write at most max_output_ bytes and return the size
+    size_t encodeFormat(const FieldValue* values, uint8_t* out) const;
+    size_t encodeStruct(const FieldValue* values, uint8_t* out) const;
+    size_t encodeProtobuf(const FieldValue* values, uint8_t* out) const;
+    size_t encodeCdr(const FieldValue* values, uint8_t* out) const;
+    size_t encodeJson(const FieldValue* values, uint8_t* out) const;
+
+    // Field index by protobuf number or by name, -1 if unknown. hint is where the search starts,
+    // fields usually arrive in schema order.
+    int findField(uint32_t number, size_t& hint) const;
+    int findField(const char* name, size_t len, size_t& hint) const;
+
+private:
+    std::string schema_name_;
+    PayloadFormat from_;
+    PayloadFormat to_;
+    std::vector<std::string> field_names_;
+
+    const SchemaDescriptor* schema_ = nullptr;
+    std::vector<uint16_t> selected_;          // Fields written, in schema order
+    size_t max_output_ = 0;
+};
+
+} // namespace data_bridge
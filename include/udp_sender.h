@@ -0,0 +1,86 @@
+#pragma once
+
+#include "common.h"
+#include "buffer_pool.h"
+#include <mutex>
+#include <netinet/in.h>
+
+namespace data_bridge {
+
+struct UdpSenderStats {
+    uint64_t gso_batches = 0;         // sendmsg calls carrying several GSO segments
+    uint64_t gso_datagrams = 0;       // Datagrams sent inside GSO batches
+    uint64_t zerocopy_sends = 0;      // MSG_ZEROCOPY sends
+    uint64_t zerocopy_copied = 0;     // Completions where the kernel copied anyway
+    uint64_t zerocopy_fallbacks = 0;  // Eligible sends that used the copy path
+};
+
+/**
+ * @brief UDP Sender - Batched and zero-copy sends to one destination
+ *
+ * On a connected socket no address is passed per send, so the kernel
+ * skips the route lookup. sendBatch() hands runs of equal-size datagrams to the kernel as one UDP
+ * GSO buffer (UDP_SEGMENT) and the rest as one sendmmsg. sendZeroCopy()
+ * sends large payloads with MSG_ZEROCOPY and keeps the owner alive until
+ * the error-queue completion arrives. Completions are reaped without
+ * blocking on later sends; when too many are outstanding the payload is
+ * copied instead, so the forward path never waits on the kernel.
+ */
+class UdpSender {
+public:
+    UdpSender(int fd, const sockaddr_in& addr, bool connected, bool gso, size_t zerocopy_threshold);
+
+    UdpSender(const UdpSender&) = delete;
+    UdpSender& operator=(const UdpSender&) = delete;
+
+    // Whether a payload of this size should be handed over with an owner
+    bool wantsZeroCopy(size_t len) const {
+        return zerocopy_threshold_ > 0 && len >= zerocopy_threshold_;
+    }
+
+    // Plain send, returns bytes sent or -1 with errno set
+    ssize_t send(const uint8_t* data, size_t len, int flags = 0);
+
+    // Send without copying, owner is released once the kernel is done with data.
+    // Returns false if the caller should send the payload normally.
+    bool sendZeroCopy(const uint8_t* data, size_t len, const PayloadBuffer& owner);
+
+    // Send several datagrams, returns how many were sent
+    size_t sendBatch(const ByteView* items, size_t count, int flags = 0);
+
+    UdpSenderStats getStats() const;
+
+private:
+    struct PendingZeroCopy {
+        uint32_t id;                          // Kernel zerocopy sequence number
+        PayloadBuffer owner;
+    };
+
+    // Drain zerocopy notifications from the error queue, never blocks
+    void reapCompletions();
+
+    // Equal-size run as one GSO buffer, returns datagrams sent
+    size_t sendSegments(const ByteView* items, size_t count, int flags);
+
+    // Mixed sizes with one sendmmsg, returns datagrams sent
+    size_t sendMultiple(const ByteView* items, size_t count, int flags);
+
+private:
+    int fd_;
+    sockaddr_in addr_;
+    sockaddr_in* name_;                       // nullptr on a connected socket
+    std::atomic<bool> gso_;
+    size_t zerocopy_threshold_;
+
+    std::mutex zerocopy_mutex_;               // Orders sends with their sequence numbers
+    std::vector<PendingZeroCopy> pending_;    // Reserved up front, never reallocates
+    uint32_t next_zerocopy_id_ = 0;
+
+    std::atomic<uint64_t> gso_batches_{0};
+    std::atomic<uint64_t> gso_datagrams_{0};
+    std::atomic<uint64_t> zerocopy_sends_{0};
+    std::atomic<uint64_t> zerocopy_copied_{0};
+    std::atomic<uint64_t> zerocopy_fallbacks_{0};
+};
+
+} // namespace data_bridge
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "common.h"
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+
+namespace data_bridge {
+
+struct EgressStats {
+    uint64_t submitted = 0;       // Datagrams accepted into the ring
+    uint64_t completed = 0;       // Sends the kernel completed successfully
+    uint64_t failed = 0;          // Sends completed with an error
+    uint64_t zerocopy = 0;        // Sends issued as SEND_ZC
+    uint64_t rejected = 0;        // Ring full or oversize, caller sent it itself
+    uint64_t batches = 0;         // io_uring_enter calls that submitted work
+    int last_error = 0;           // errno of the last failed send
+};
+
+/**
+ * @brief io_uring Egress - Batches UDP sends of a stream group on one thread
+ *
+ * Forwarding threads copy the datagram into a preallocated slot of a
+ * lock-free MPSC ring and return; a submission thread turns queued slots
+ * into SENDMSG (or SEND_ZC above the zero-copy threshold, where the kernel
+ * has it) requests on
+ * registered sockets and buffers, and submits them with one syscall per
+ * batch. Errors are accounted when the completion arrives. A slot is only
+ * reused after its completion, so payloads stay valid while in flight.
+ */
+class UringEgress {
+public:
+    UringEgress(size_t queue_depth, size_t buffer_size, size_t zerocopy_threshold);
+    ~UringEgress();
+
+    UringEgress(const UringEgress&) = delete;
+    UringEgress& operator=(const UringEgress&) = delete;
+
+    // Whether the running kernel supports io_uring
+    static bool isAvailable();
+
+    // Register a socket before start(), returns its handle for send() or -1
+    int registerSocket(int fd);
+
+    bool start();
+
+    // Sends everything queued so far, send() must not be called concurrently
+    void stop();
+
+    // Queue one datagram, safe from any thread. Returns false if the caller
+    // has to send it itself (ring full, payload too large, not running).
+    bool send(int handle, const sockaddr_in& addr, const uint8_t* data, size_t len);
+
+    EgressStats getStats() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        uint64_t position = 0;        // Ring position while in flight
+        int handle = -1;
+        size_t size = 0;
+        sockaddr_in addr{};
+        msghdr msg{};
+        iovec iov{};
+        uint8_t* buffer = nullptr;    // Part of the registered buffer region
+    };
+
+    struct Ring;                      // Kernel ring mappings
+
+    void submitLoop();
+    unsigned queuePending();
+    void reapCompletions();
+    // Queue the eventfd read, false if the submission queue stays full (retried next round)
+    bool armWakeup();
+    void release(Slot& slot);
+
+private:
+    size_t buffer_size_;
+    size_t zerocopy_threshold_;       // 0 disables SEND_ZC
+    bool send_zc_ = false;            // Threshold set and SEND_ZC supported by the kernel
+    std::vector<int> sockets_;
+
+    // Bounded MPSC ring, slot buffers live in buffer_region_
+    std::vector<Slot> slots_;
+    size_t slot_mask_;
+    std::atomic<uint64_t> enqueue_pos_{0};
+    uint64_t dequeue_pos_ = 0;
+    uint8_t* buffer_region_ = nullptr;
+    size_t buffer_region_size_ = 0;
+    bool fixed_buffers_ = false;
+
+    std::unique_ptr<Ring> ring_;
+    int wakeup_fd_ = -1;
+    uint64_t wakeup_value_ = 0;
+    std::atomic<bool> wakeup_pending_{false};
+    bool wakeup_armed_ = false;       // Submission thread only
+    size_t inflight_ = 0;             // Submission thread only
+
+    std::atomic<bool> running_{false};
+    std::thread submit_thread_;
+
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> failed_{0};
+    std::atomic<uint64_t> zerocopy_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> batches_{0};
+    std::atomic<int> last_error_{0};
+};
+
+} // namespace data_bridge
@@ -0,0 +1,243 @@
+#include "backpressure.h"
+#include "thread_placement.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ifaddrs.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <linux/inet_diag.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/sock_diag.h>
+
+namespace data_bridge {
+
+namespace {
+
+// A level is left only once occupancy falls this far below its threshold
+constexpr double kHysteresis = 0.1;
+
+double occupancyOf(const SocketQueue& queue) {
+    return queue.capacity > 0 ? static_cast<double>(queue.queued) / static_cast<double>(queue.capacity) : 0.0;
+}
+
+const char* levelName(PressureLevel level) {
+    switch (level) {
+        case PressureLevel::HIGH: return "high";
+        case PressureLevel::CRITICAL: return "critical";
+        default: return "normal";
+    }
+}
+
+} // namespace
+
+BackpressureMonitor::BackpressureMonitor(const BridgeConfig& config,
+                                         std::vector<std::shared_ptr<UdpDestination>> destinations)
+    : interval_(std::max(config.backpressure_interval_ms, 1)),
+      high_(config.backpressure_high),
+      critical_(std::max(config.backpressure_critical, config.backpressure_high)),
+      destinations_(std::move(destinations)) {
+}
+
+BackpressureMonitor::~BackpressureMonitor() {
+    stop();
+}
+
+bool BackpressureMonitor::start() {
+    if (running_) {
+        return false;
+    }
+
+    // Without sock_diag only the bridge's own send queues are visible
+    diag_socket_ = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_SOCK_DIAG);
+    if (diag_socket_ < 0) {
+        std::cerr << "[BackpressureMonitor] sock_diag unavailable (" << strerror(errno)
+                  << "), consumer queues are not monitored" << std::endl;
+    }
+
+    ifaddrs* interfaces = nullptr;
+    if (getifaddrs(&interfaces) == 0) {
+        for (ifaddrs* entry = interfaces; entry; entry = entry->ifa_next) {
+            if (entry->ifa_addr && entry->ifa_addr->sa_family == AF_INET) {
+                local_addresses_.push_back(reinterpret_cast<sockaddr_in*>(entry->ifa_addr)->sin_addr.s_addr);
+            }
+        }
+        freeifaddrs(interfaces);
+    }
+
+    running_ = true;
+    try {
+        monitor_thread_ = std::thread(&BackpressureMonitor::monitorLoop, this);
+    } catch (const std::exception& e) {
+        std::cerr << "[BackpressureMonitor] Failed to start monitor: " << e.what() << std::endl;
+        running_ = false;
+        return false;
+    }
+
+    std::cout << "[BackpressureMonitor] Sampling " << destinations_.size() << " destinations every "
+              << interval_.count() << " ms" << std::endl;
+    return true;
+}
+
+void BackpressureMonitor::stop() {
+    if (running_.exchange(false)) {
+        {
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+        }
+        wait_cv_.notify_all();
+        if (monitor_thread_.joinable()) {
+            monitor_thread_.join();
+        }
+    }
+
+    if (diag_socket_ >= 0) {
+        close(diag_socket_);
+        diag_socket_ = -1;
+    }
+}
+
+void BackpressureMonitor::monitorLoop() {
+    ThreadRegistration registration("backpressure");
+
+    do {
+        sample();
+    } while (waitFor(interval_));
+}
+
+void BackpressureMonitor::sample() {
+    ConsumerSockets consumers;
+    bool have_consumers = readConsumerSockets(consumers);
+
+    for (auto& destination : destinations_) {
+        DestinationPressure pressure = destination->getPressure();
+        pressure.send = destination->sendQueue();
+        pressure.receive = SocketQueue();
+        pressure.consumer_found = false;
+
+        const sockaddr_in& address = destination->address();
+        if (have_consumers && isLocal(address.sin_addr.s_addr)) {
+            uint64_t drops = 0;
+            auto range = consumers.equal_range(ntohs(address.sin_port));
+            for (auto it = range.first; it != range.second; ++it) {
+                const ConsumerSocket& consumer = it->second;
+                if (consumer.address != INADDR_ANY && consumer.address != address.sin_addr.s_addr) {
+                    continue;
+                }
+                pressure.consumer_found = true;
+                pressure.receive.queued += consumer.queue.queued;
+                pressure.receive.capacity += consumer.queue.capacity;
+                drops += consumer.drops;
+            }
+
+            // The counter restarts with the consumer's socket
+            if (pressure.consumer_found) {
+                auto last = last_drops_.find(destination->name());
+                if (last != last_drops_.end()) {
+                    pressure.consumer_drops += drops >= last->second ? drops - last->second : drops;
+                }
+                last_drops_[destination->name()] = drops;
+            }
+        }
+
+        pressure.occupancy = std::max(occupancyOf(pressure.send), occupancyOf(pressure.receive));
+        PressureLevel level = nextLevel(pressure.level, pressure.occupancy);
+        if (level != pressure.level) {
+            std::cout << "[BackpressureMonitor] " << destination->name() << ": pressure " << levelName(level)
+                      << " (queue " << static_cast<int>(pressure.occupancy * 100.0) << "% full)" << std::endl;
+        }
+        pressure.level = level;
+        destination->setPressure(pressure);
+    }
+}
+
+bool BackpressureMonitor::readConsumerSockets(ConsumerSockets& sockets) {
+    if (diag_socket_ < 0) {
+        return false;
+    }
+
+    struct {
+        nlmsghdr header;
+        inet_diag_req_v2 request;
+    } message{};
+    message.header.nlmsg_len = sizeof(message);
+    message.header.nlmsg_type = SOCK_DIAG_BY_FAMILY;
+    message.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    message.request.sdiag_family = AF_INET;
+    message.request.sdiag_protocol = IPPROTO_UDP;
+    message.request.idiag_states = ~0U;
+    message.request.idiag_ext = 1 << (INET_DIAG_SKMEMINFO - 1);
+
+    if (send(diag_socket_, &message, sizeof(message), 0) < 0) {
+        std::cerr << "[BackpressureMonitor] sock_diag request failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    alignas(nlmsghdr) char buffer[32768];
+    for (;;) {
+        ssize_t received = recv(diag_socket_, buffer, sizeof(buffer), 0);
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+
+        int remaining = static_cast<int>(received);
+        for (auto* header = reinterpret_cast<nlmsghdr*>(buffer); NLMSG_OK(header, remaining);
+             header = NLMSG_NEXT(header, remaining)) {
+            if (header->nlmsg_type == NLMSG_DONE) {
+                return true;
+            }
+            if (header->nlmsg_type == NLMSG_ERROR) {
+                return false;
+            }
+
+            auto* diag = static_cast<inet_diag_msg*>(NLMSG_DATA(header));
+            ConsumerSocket consumer;
+            consumer.address = diag->id.idiag_src[0];
+
+            int attributes = static_cast<int>(header->nlmsg_len - NLMSG_LENGTH(sizeof(*diag)));
+            for (auto* attribute = reinterpret_cast<rtattr*>(diag + 1); RTA_OK(attribute, attributes);
+                 attribute = RTA_NEXT(attribute, attributes)) {
+                if (attribute->rta_type == INET_DIAG_SKMEMINFO &&
+                    RTA_PAYLOAD(attribute) >= sizeof(uint32_t) * (SK_MEMINFO_DROPS + 1)) {
+                    auto* meminfo = static_cast<const uint32_t*>(RTA_DATA(attribute));
+                    consumer.queue.queued = meminfo[SK_MEMINFO_RMEM_ALLOC];
+                    consumer.queue.capacity = meminfo[SK_MEMINFO_RCVBUF];
+                    consumer.drops = meminfo[SK_MEMINFO_DROPS];
+                }
+            }
+            sockets.emplace(ntohs(diag->id.idiag_sport), consumer);
+        }
+    }
+}
+
+bool BackpressureMonitor::isLocal(uint32_t address) const {
+    if ((ntohl(address) >> 24) == 127) {
+        return true;
+    }
+    return std::find(local_addresses_.begin(), local_addresses_.end(), address) != local_addresses_.end();
+}
+
+PressureLevel BackpressureMonitor::nextLevel(PressureLevel current, double occupancy) const {
+    if (occupancy >= critical_ ||
+        (current == PressureLevel::CRITICAL && occupancy >= critical_ - kHysteresis)) {
+        return PressureLevel::CRITICAL;
+    }
+    if (occupancy >= high_ ||
+        (current != PressureLevel::NORMAL && occupancy >= high_ - kHysteresis)) {
+        return PressureLevel::HIGH;
+    }
+    return PressureLevel::NORMAL;
+}
+
+bool BackpressureMonitor::waitFor(std::chrono::milliseconds delay) {
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    wait_cv_.wait_for(lock, delay, [this]() { return !running_; });
+    return running_;
+}
+
+} // namespace data_bridge
@@ -0,0 +1,274 @@
+#include "capture.h"
+#include "payload_codec.h"
+#include "matching_gate.h"
+#include <zenoh.hxx>
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+#include <map>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+std::atomic<bool> g_running{true};
+
+void signalHandler(int signum) {
+    std::cout << "\n[Main] Interrupt signal (" << signum << ") received" << std::endl;
+    g_running = false;
+}
+
+void printUsage(const char* prog_name) {
+    std::cout << "Usage: " << prog_name << " [options] <capture.zcap>..." << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --speed <factor>  Replay speed, 1 = original timing, max = no pacing (default: 1)" << std::endl;
+    std::cout << "  --udp <host:port> Send payloads straight to a local UDP consumer instead of Zenoh" << std::endl;
+    std::cout << "  --key <prefix>    Only replay records whose key starts with prefix" << std::endl;
+    std::cout << "  --dict <file>     zstd dictionary for decompressing in --udp mode" << std::endl;
+    std::cout << "  --block           Wait on a congested Zenoh link instead of dropping samples" << std::endl;
+    std::cout << "  --matched-only    Skip records of keys nobody subscribes to" << std::endl;
+    std::cout << "  -c <config>       Zenoh config file" << std::endl;
+    std::cout << "  -h                Show this help message" << std::endl;
+    std::cout << "\nExamples:" << std::endl;
+    std::cout << "  # Re-publish a capture into Zenoh at original timing" << std::endl;
+    std::cout << "  " << prog_name << " capture/capture-20250101-120000-*.zcap" << std::endl;
+    std::cout << "\n  # Feed a local consumer directly, 10x faster" << std::endl;
+    std::cout << "  " << prog_name << " --speed 10 --udp 127.0.0.1:8888 capture/*.zcap" << std::endl;
+}
+
+// Destination for replayed records
+class ReplaySink {
+public:
+    virtual ~ReplaySink() = default;
+    virtual bool send(const data_bridge::CaptureRecord& record) = 0;
+
+    // Records not sent because nobody subscribed
+    virtual uint64_t skipped() const { return 0; }
+};
+
+// Re-publishes records into Zenoh with their original key and encoding
+class ZenohSink : public ReplaySink {
+public:
+    ZenohSink(zenoh::Session& session, bool block, bool matched_only)
+        : session_(session), block_(block), matched_only_(matched_only) {}
+
+    bool send(const data_bridge::CaptureRecord& record) override {
+        std::string key(record.key);
+        auto it = publishers_.find(key);
+        if (it == publishers_.end()) {
+            // BLOCK pushes Zenoh's congestion back into the replay loop, DROP sheds inside Zenoh
+            zenoh::Session::PublisherOptions publisher_options;
+            if (block_) {
+                publisher_options.congestion_control = zenoh::CongestionControl::Z_CONGESTION_CONTROL_BLOCK;
+            }
+            it = publishers_.emplace(key, KeyPublisher{session_.declare_publisher(zenoh::KeyExpr(key),
+                                                                                  std::move(publisher_options)),
+                                                       nullptr}).first;
+            if (matched_only_) {
+                it->second.gate = std::make_unique<data_bridge::MatchingGate>();
+                it->second.gate->attach(it->second.publisher);
+            }
+        }
+
+        // No copy and no put while nobody listens on this key
+        if (it->second.gate && !it->second.gate->matched()) {
+            skipped_++;
+            return true;
+        }
+
+        zenoh::Publisher::PutOptions options;
+        options.encoding = zenoh::Encoding(record.encoding);
+        it->second.publisher.put(
+            zenoh::Bytes(std::vector<uint8_t>(record.payload, record.payload + record.payload_size)),
+            std::move(options));
+        return true;
+    }
+
+    uint64_t skipped() const override { return skipped_; }
+
+private:
+    struct KeyPublisher {
+        zenoh::Publisher publisher;
+        std::unique_ptr<data_bridge::MatchingGate> gate;   // Declared after, so undeclared before the publisher
+    };
+
+    zenoh::Session& session_;
+    bool block_;
+    bool matched_only_;
+    uint64_t skipped_ = 0;
+    std::map<std::string, KeyPublisher> publishers_;
+};
+
+// Sends decompressed payloads to a UDP consumer, as the bridge would
+class UdpSink : public ReplaySink {
+public:
+    UdpSink(int socket, const sockaddr_in& addr, data_bridge::PayloadCodec& codec)
+        : socket_(socket), addr_(addr), codec_(codec) {}
+
+    bool send(const data_bridge::CaptureRecord& record) override {
+        data_bridge::ByteView data;
+        if (!codec_.decompress(zenoh::Encoding(record.encoding), {record.payload, record.payload_size}, data)) {
+            return false;
+        }
+        ssize_t sent = sendto(socket_, data.data, data.size, 0,
+                              reinterpret_cast<const sockaddr*>(&addr_), sizeof(addr_));
+        return sent == static_cast<ssize_t>(data.size);
+    }
+
+private:
+    int socket_;
+    sockaddr_in addr_;
+    data_bridge::PayloadCodec& codec_;
+};
+
+int main(int argc, char* argv[]) {
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+
+    double speed = 1.0;
+    std::string udp_target;
+    std::string key_prefix;
+    std::string zenoh_config_file;
+    bool block = false;
+    bool matched_only = false;
+    data_bridge::StreamConfig codec_config;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--speed" && i + 1 < argc) {
+            std::string value = argv[++i];
+            speed = (value == "max") ? 0.0 : std::stod(value);
+        } else if (arg == "--udp" && i + 1 < argc) {
+            udp_target = argv[++i];
+        } else if (arg == "--key" && i + 1 < argc) {
+            key_prefix = argv[++i];
+        } else if (arg == "--dict" && i + 1 < argc) {
+            codec_config.zstd_dictionary = argv[++i];
+        } else if (arg == "--block") {
+            block = true;
+        } else if (arg == "--matched-only") {
+            matched_only = true;
+        } else if (arg == "-c" && i + 1 < argc) {
+            zenoh_config_file = argv[++i];
+        } else if (!arg.empty() && arg[0] == '-') {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        } else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    // Segment names sort in capture order
+    std::sort(files.begin(), files.end());
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Zenoh Bridge Capture Replay" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    try {
+        std::unique_ptr<zenoh::Session> session;
+        std::unique_ptr<ReplaySink> sink;
+        data_bridge::PayloadCodec codec(codec_config);
+        int udp_socket = -1;
+
+        if (!udp_target.empty()) {
+            auto colon = udp_target.rfind(':');
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            if (colon == std::string::npos ||
+                inet_pton(AF_INET, udp_target.substr(0, colon).c_str(), &addr.sin_addr) <= 0) {
+                std::cerr << "Invalid UDP target: " << udp_target << std::endl;
+                return 1;
+            }
+            addr.sin_port = htons(std::stoi(udp_target.substr(colon + 1)));
+
+            if (!codec.init()) {
+                return 1;
+            }
+            udp_socket = socket(AF_INET, SOCK_DGRAM, 0);
+            if (udp_socket < 0) {
+                std::cerr << "Failed to create UDP socket: " << strerror(errno) << std::endl;
+                return 1;
+            }
+            sink = std::make_unique<UdpSink>(udp_socket, addr, codec);
+            std::cout << "[Replay] Target: UDP " << udp_target << std::endl;
+        } else {
+            zenoh::Config config = zenoh_config_file.empty()
+                ? zenoh::Config::create_default()
+                : zenoh::Config::from_file(zenoh_config_file);
+            session = std::make_unique<zenoh::Session>(zenoh::Session::open(std::move(config)));
+            sink = std::make_unique<ZenohSink>(*session, block, matched_only);
+            std::cout << "[Replay] Target: Zenoh" << (block ? " (congestion control: block)" : "")
+                      << (matched_only ? " (matched keys only)" : "") << std::endl;
+        }
+        std::cout << "[Replay] Speed: " << (speed > 0.0 ? std::to_string(speed) + "x" : "max") << std::endl;
+
+        uint64_t replayed = 0;
+        uint64_t failed = 0;
+        uint64_t bytes = 0;
+        uint64_t first_ns = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        for (const auto& file : files) {
+            data_bridge::CaptureReader reader;
+            if (!reader.open(file)) {
+                continue;
+            }
+            std::cout << "[Replay] " << file << std::endl;
+
+            reader.forEach([&](const data_bridge::CaptureRecord& record) {
+                if (!g_running) {
+                    return false;
+                }
+                if (!key_prefix.empty() && record.key.substr(0, key_prefix.size()) != key_prefix) {
+                    return true;
+                }
+
+                // Pace against the original receive timestamps
+                if (first_ns == 0) {
+                    first_ns = record.receive_ns;
+                }
+                if (speed > 0.0 && record.receive_ns > first_ns) {
+                    auto offset = std::chrono::nanoseconds(
+                        static_cast<int64_t>((record.receive_ns - first_ns) / speed));
+                    std::this_thread::sleep_until(start + offset);
+                }
+
+                if (sink->send(record)) {
+                    replayed++;
+                    bytes += record.payload_size;
+                } else {
+                    failed++;
+                }
+                return true;
+            });
+        }
+
+        auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "\n[Replay] Replayed " << replayed << " records (" << bytes << " bytes) in "
+                  << elapsed << " s, " << failed << " failed";
+        if (sink->skipped() > 0) {
+            std::cout << ", " << sink->skipped() << " skipped (no subscribers)";
+        }
+        std::cout << std::endl;
+
+        if (udp_socket >= 0) {
+            close(udp_socket);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[Main] Exception: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
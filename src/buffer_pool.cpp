@@ -0,0 +1,327 @@
+#include "buffer_pool.h"
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+
+namespace data_bridge {
+
+namespace {
+
+constexpr size_t kMinClassSize = 256;
+constexpr size_t kClassCount = 9;                  // 256 B .. 64 KiB
+constexpr uint32_t kHeapClass = kClassCount;
+constexpr size_t kHeaderSize = 64;                 // Keeps payloads cache-line aligned
+constexpr size_t kSlabSize = 2 * 1024 * 1024;      // One huge page
+
+// Cache of the calling thread, null before its first allocation and after exit
+thread_local void* t_cache = nullptr;
+thread_local bool t_exited = false;
+
+size_t classSize(size_t size_class) {
+    return kMinClassSize << size_class;
+}
+
+size_t classFor(size_t size) {
+    size_t size_class = 0;
+    while (classSize(size_class) < size) {
+        size_class++;
+    }
+    return size_class;
+}
+
+// Counters written only by the owning thread, read by getStats()
+void bump(std::atomic<uint64_t>& counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+} // namespace
+
+struct PayloadBuffer::Block {
+    std::atomic<uint32_t> refs{1};
+    uint32_t size_class = 0;
+    size_t size = 0;
+    size_t capacity = 0;
+    void* owner = nullptr;                         // ThreadCache that carved it, null for heap blocks
+    Block* next = nullptr;                         // Free or return list link
+
+    uint8_t* data() { return reinterpret_cast<uint8_t*>(this) + kHeaderSize; }
+};
+
+struct BufferPool::ThreadCache {
+    std::array<PayloadBuffer::Block*, kClassCount> free{};     // Owner thread only
+    std::atomic<PayloadBuffer::Block*> returned{nullptr};      // Pushed by other threads
+    uint8_t* chunk = nullptr;                                  // Uncarved rest of the current slab
+    size_t chunk_left = 0;
+    std::atomic<bool> in_use{false};
+
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> cache_hits{0};
+    std::atomic<uint64_t> local_frees{0};
+    std::atomic<uint64_t> remote_frees{0};
+};
+
+PayloadBuffer::PayloadBuffer(const PayloadBuffer& other)
+    : block_(other.block_) {
+    if (block_) {
+        block_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PayloadBuffer& PayloadBuffer::operator=(const PayloadBuffer& other) {
+    if (this != &other) {
+        if (other.block_) {
+            other.block_->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+        reset();
+        block_ = other.block_;
+    }
+    return *this;
+}
+
+PayloadBuffer& PayloadBuffer::operator=(PayloadBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        block_ = other.block_;
+        other.block_ = nullptr;
+    }
+    return *this;
+}
+
+PayloadBuffer PayloadBuffer::allocate(size_t size) {
+    return BufferPool::instance().allocate(size);
+}
+
+uint8_t* PayloadBuffer::data() const {
+    return block_ ? block_->data() : nullptr;
+}
+
+size_t PayloadBuffer::size() const {
+    return block_ ? block_->size : 0;
+}
+
+size_t PayloadBuffer::capacity() const {
+    return block_ ? block_->capacity : 0;
+}
+
+bool PayloadBuffer::resize(size_t size) {
+    if (!block_ || size > block_->capacity) {
+        return false;
+    }
+    block_->size = size;
+    return true;
+}
+
+void PayloadBuffer::reset() {
+    if (block_ && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        BufferPool::release(block_);
+    }
+    block_ = nullptr;
+}
+
+BufferPool& BufferPool::instance() {
+    // Never destroyed, buffers may still be released during static destruction
+    static BufferPool* pool = new BufferPool();
+    return *pool;
+}
+
+void BufferPool::setHugePages(bool enabled) {
+    huge_pages_.store(enabled, std::memory_order_relaxed);
+}
+
+size_t BufferPool::maxPooledSize() {
+    return classSize(kClassCount - 1);
+}
+
+PayloadBuffer BufferPool::allocate(size_t size) {
+    static_assert(sizeof(PayloadBuffer::Block) <= kHeaderSize, "block header exceeds its reserved space");
+
+    ThreadCache* cache = size <= maxPooledSize() ? localCache() : nullptr;
+
+    PayloadBuffer::Block* block = nullptr;
+    if (cache) {
+        size_t size_class = classFor(size);
+
+        // Take back what other threads released before carving new memory
+        if (!cache->free[size_class]) {
+            PayloadBuffer::Block* returned = cache->returned.exchange(nullptr, std::memory_order_acquire);
+            while (returned) {
+                PayloadBuffer::Block* next = returned->next;
+                returned->next = cache->free[returned->size_class];
+                cache->free[returned->size_class] = returned;
+                returned = next;
+            }
+        }
+
+        block = cache->free[size_class];
+        if (block) {
+            cache->free[size_class] = block->next;
+            bump(cache->cache_hits);
+        } else {
+            size_t stride = kHeaderSize + classSize(size_class);
+            if (cache->chunk_left < stride) {
+                cache->chunk = mapSlab();
+                cache->chunk_left = cache->chunk ? kSlabSize : 0;
+            }
+            if (cache->chunk) {
+                block = new (cache->chunk) PayloadBuffer::Block();
+                block->size_class = static_cast<uint32_t>(size_class);
+                block->capacity = classSize(size_class);
+                block->owner = cache;
+                cache->chunk += stride;
+                cache->chunk_left -= stride;
+            }
+        }
+    }
+
+    if (block) {
+        block->refs.store(1, std::memory_order_relaxed);
+        block->next = nullptr;
+        bump(cache->allocations);
+    } else {
+        // Oversize payloads, an exiting thread or no memory for a slab
+        void* memory = ::operator new(kHeaderSize + size);
+        block = new (memory) PayloadBuffer::Block();
+        block->size_class = kHeapClass;
+        block->capacity = size;
+        heap_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    block->size = size;
+    return PayloadBuffer(block);
+}
+
+void BufferPool::release(PayloadBuffer::Block* block) {
+    if (block->size_class == kHeapClass) {
+        block->~Block();
+        ::operator delete(block);
+        return;
+    }
+
+    auto* owner = static_cast<ThreadCache*>(block->owner);
+    if (owner == t_cache) {
+        block->next = owner->free[block->size_class];
+        owner->free[block->size_class] = block;
+        bump(owner->local_frees);
+        return;
+    }
+
+    // Returned to the owner without a lock, it collects the whole list at once
+    PayloadBuffer::Block* head = owner->returned.load(std::memory_order_relaxed);
+    do {
+        block->next = head;
+    } while (!owner->returned.compare_exchange_weak(head, block, std::memory_order_release,
+                                                     std::memory_order_relaxed));
+    owner->remote_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+BufferPool::ThreadCache* BufferPool::localCache() {
+    if (t_cache) {
+        return static_cast<ThreadCache*>(t_cache);
+    }
+    if (t_exited) {
+        return nullptr;
+    }
+
+    // Hands the cache and its free buffers to the next thread once this one exits
+    struct Holder {
+        ThreadCache* cache = nullptr;
+
+        ~Holder() {
+            t_cache = nullptr;
+            t_exited = true;
+            if (cache) {
+                cache->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+    thread_local Holder holder;
+
+    holder.cache = acquireCache();
+    t_cache = holder.cache;
+    return holder.cache;
+}
+
+BufferPool::ThreadCache* BufferPool::acquireCache() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& cache : caches_) {
+        bool expected = false;
+        if (cache->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+            return cache.get();
+        }
+    }
+
+    caches_.push_back(std::make_unique<ThreadCache>());
+    caches_.back()->in_use.store(true, std::memory_order_relaxed);
+    return caches_.back().get();
+}
+
+uint8_t* BufferPool::mapSlab() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    void* slab = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (huge_pages_.load(std::memory_order_relaxed) && !huge_pages_failed_) {
+        slab = mmap(nullptr, kSlabSize, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (slab == MAP_FAILED) {
+            std::cout << "[BufferPool] No huge pages reserved (" << strerror(errno)
+                      << "), using transparent huge pages" << std::endl;
+            huge_pages_failed_ = true;
+        } else {
+            huge_slabs_++;
+        }
+    }
+#endif
+
+    if (slab == MAP_FAILED) {
+        // Map twice the size so the slab can start on a huge page boundary
+        void* region = mmap(nullptr, 2 * kSlabSize, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (region == MAP_FAILED) {
+            std::cerr << "[BufferPool] Failed to map slab: " << strerror(errno) << std::endl;
+            return nullptr;
+        }
+
+        uintptr_t begin = reinterpret_cast<uintptr_t>(region);
+        uintptr_t start = (begin + kSlabSize - 1) & ~(kSlabSize - 1);
+        if (start > begin) {
+            munmap(region, start - begin);
+        }
+        if (start + kSlabSize < begin + 2 * kSlabSize) {
+            munmap(reinterpret_cast<void*>(start + kSlabSize), begin + kSlabSize - start);
+        }
+        slab = reinterpret_cast<void*>(start);
+#ifdef MADV_HUGEPAGE
+        madvise(slab, kSlabSize, MADV_HUGEPAGE);
+#endif
+    }
+
+    slabs_++;
+    return static_cast<uint8_t*>(slab);
+}
+
+BufferPoolStats BufferPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    BufferPoolStats stats;
+    uint64_t frees = 0;
+    for (const auto& cache : caches_) {
+        stats.allocations += cache->allocations.load(std::memory_order_relaxed);
+        stats.cache_hits += cache->cache_hits.load(std::memory_order_relaxed);
+        stats.remote_frees += cache->remote_frees.load(std::memory_order_relaxed);
+        frees += cache->local_frees.load(std::memory_order_relaxed);
+    }
+    frees += stats.remote_frees;
+
+    // Counters are read one by one, frees can briefly run ahead
+    stats.in_use = stats.allocations > frees ? stats.allocations - frees : 0;
+    stats.heap = heap_.load(std::memory_order_relaxed);
+    stats.slabs = slabs_;
+    stats.huge_slabs = huge_slabs_;
+    stats.slab_bytes = slabs_ * kSlabSize;
+    return stats;
+}
+
+} // namespace data_bridge
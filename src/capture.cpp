@@ -0,0 +1,371 @@
+#include "capture.h"
+#include "thread_placement.h"
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace data_bridge {
+
+namespace {
+
+constexpr uint32_t kCaptureVersion = 1;
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+size_t roundUpPow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+size_t captureRecordSize(size_t key_size, size_t encoding_size, size_t payload_size) {
+    return alignUp(sizeof(CaptureRecordHeader) + key_size + encoding_size + payload_size, 8);
+}
+
+size_t encodeCaptureRecord(uint8_t* dst, std::string_view key, std::string_view encoding,
+                           const uint8_t* payload, size_t len, uint64_t receive_ns) {
+    CaptureRecordHeader header{};
+    header.record_size = static_cast<uint32_t>(captureRecordSize(key.size(), encoding.size(), len));
+    header.key_size = static_cast<uint16_t>(key.size());
+    header.encoding_size = static_cast<uint16_t>(encoding.size());
+    header.receive_ns = receive_ns;
+    header.payload_size = static_cast<uint32_t>(len);
+
+    uint8_t* p = dst;
+    std::memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    std::memcpy(p, key.data(), key.size());
+    p += key.size();
+    std::memcpy(p, encoding.data(), encoding.size());
+    p += encoding.size();
+    std::memcpy(p, payload, len);
+    p += len;
+    std::memset(p, 0, dst + header.record_size - p);
+
+    return header.record_size;
+}
+
+// ---------------------------------------------------------------------------
+// CaptureWriter
+// ---------------------------------------------------------------------------
+
+CaptureWriter::CaptureWriter(const BridgeConfig& config)
+    : directory_(config.capture_dir),
+      segment_size_(alignUp(std::max<size_t>(config.capture_segment_mb, 1) * 1024 * 1024, kCaptureBlockSize)),
+      slot_capacity_(config.capture_max_record_kb * 1024),
+      slots_(roundUpPow2(std::max<size_t>(config.capture_ring_slots, 2))),
+      slot_mask_(slots_.size() - 1) {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+        slots_[i].record.resize(slot_capacity_);
+    }
+}
+
+CaptureWriter::~CaptureWriter() {
+    stop();
+}
+
+bool CaptureWriter::start() {
+    if (running_) {
+        std::cerr << "[CaptureWriter] Already running" << std::endl;
+        return false;
+    }
+
+    if (mkdir(directory_.c_str(), 0755) < 0 && errno != EEXIST) {
+        std::cerr << "[CaptureWriter] Failed to create " << directory_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Segment files of one run share a timestamp prefix
+    std::time_t now = std::time(nullptr);
+    std::tm local{};
+    localtime_r(&now, &local);
+    std::ostringstream prefix;
+    prefix << "capture-" << std::put_time(&local, "%Y%m%d-%H%M%S");
+    session_prefix_ = prefix.str();
+    segment_index_ = 0;
+
+    if (!openSegment()) {
+        return false;
+    }
+
+    running_ = true;
+    writer_thread_ = std::thread(&CaptureWriter::writerLoop, this);
+
+    std::cout << "[CaptureWriter] Capturing to " << directory_ << "/" << session_prefix_ << "-*.zcap"
+              << " (" << slots_.size() << " ring slots)" << std::endl;
+    return true;
+}
+
+void CaptureWriter::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // The writer drains everything already enqueued before exiting
+    if (writer_thread_.joinable()) {
+        writer_thread_.join();
+    }
+    closeSegment();
+
+    std::cout << "[CaptureWriter] Stopped: " << captured_.load() << " records, "
+              << dropped_.load() << " dropped" << std::endl;
+}
+
+bool CaptureWriter::append(std::string_view key, std::string_view encoding,
+                           const uint8_t* payload, size_t len, uint64_t receive_ns) {
+    if (captureRecordSize(key.size(), encoding.size(), len) > slot_capacity_ ||
+        key.size() > UINT16_MAX || encoding.size() > UINT16_MAX) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Claim a slot, never wait for the writer
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots_[pos & slot_mask_];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->size = encodeCaptureRecord(slot->record.data(), key, encoding, payload, len, receive_ns);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+CaptureStats CaptureWriter::getStats() const {
+    CaptureStats stats;
+    stats.captured = captured_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.segments = segments_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void CaptureWriter::writerLoop() {
+    ThreadRegistration registration("capture");
+
+    for (;;) {
+        bool stopping = !running_;
+        size_t batch = 0;
+
+        for (;;) {
+            Slot& slot = slots_[dequeue_pos_ & slot_mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+                break;
+            }
+            if (writeRecord(slot.record.data(), slot.size)) {
+                batch++;
+            }
+            slot.sequence.store(dequeue_pos_ + slots_.size(), std::memory_order_release);
+            dequeue_pos_++;
+        }
+
+        if (batch > 0 && map_) {
+            // Publish the new end of data, a crash keeps everything before it
+            reinterpret_cast<CaptureSegmentHeader*>(map_)->used_bytes = offset_;
+        } else if (stopping) {
+            break;
+        } else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+}
+
+bool CaptureWriter::openSegment() {
+    std::ostringstream path;
+    path << directory_ << "/" << session_prefix_ << "-" << std::setw(4) << std::setfill('0')
+         << segment_index_ << ".zcap";
+
+    fd_ = ::open(path.str().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "[CaptureWriter] Failed to open " << path.str() << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Preallocate so appends never extend the file
+    int err = posix_fallocate(fd_, 0, segment_size_);
+    if (err != 0) {
+        std::cerr << "[CaptureWriter] Failed to preallocate segment: " << strerror(err) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+
+    void* map = mmap(nullptr, segment_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "[CaptureWriter] Failed to map segment: " << strerror(errno) << std::endl;
+        ::close(fd_);
+        fd_ = -1;
+        return false;
+    }
+    map_ = static_cast<uint8_t*>(map);
+    madvise(map_, segment_size_, MADV_SEQUENTIAL);
+
+    CaptureSegmentHeader header{};
+    header.magic = kCaptureMagic;
+    header.version = kCaptureVersion;
+    header.segment_index = segment_index_;
+    header.created_ns = nowNs();
+    header.used_bytes = kCaptureBlockSize;
+    std::memcpy(map_, &header, sizeof(header));
+
+    offset_ = kCaptureBlockSize;
+    segment_index_++;
+    segments_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void CaptureWriter::closeSegment() {
+    if (!map_) {
+        return;
+    }
+
+    reinterpret_cast<CaptureSegmentHeader*>(map_)->used_bytes = offset_;
+    msync(map_, offset_, MS_ASYNC);
+    munmap(map_, segment_size_);
+    map_ = nullptr;
+
+    // Trim the preallocation, keeping the file a whole number of blocks
+    if (ftruncate(fd_, alignUp(offset_, kCaptureBlockSize)) < 0) {
+        std::cerr << "[CaptureWriter] Failed to trim segment: " << strerror(errno) << std::endl;
+    }
+    ::close(fd_);
+    fd_ = -1;
+}
+
+bool CaptureWriter::writeRecord(const uint8_t* record, size_t size) {
+    if (kCaptureBlockSize + size > segment_size_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (!map_ || offset_ + size > segment_size_) {
+        closeSegment();
+        if (!openSegment()) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+
+    std::memcpy(map_ + offset_, record, size);
+    offset_ += size;
+    captured_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// CaptureReader
+// ---------------------------------------------------------------------------
+
+CaptureReader::~CaptureReader() {
+    close();
+}
+
+bool CaptureReader::open(const std::string& path) {
+    close();
+
+    fd_ = ::open(path.c_str(), O_RDONLY);
+    if (fd_ < 0) {
+        std::cerr << "[CaptureReader] Failed to open " << path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd_, &st) < 0 || static_cast<size_t>(st.st_size) < kCaptureBlockSize) {
+        std::cerr << "[CaptureReader] Not a capture segment: " << path << std::endl;
+        close();
+        return false;
+    }
+
+    map_size_ = st.st_size;
+    void* map = mmap(nullptr, map_size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+    if (map == MAP_FAILED) {
+        std::cerr << "[CaptureReader] Failed to map " << path << ": " << strerror(errno) << std::endl;
+        map_size_ = 0;
+        close();
+        return false;
+    }
+    map_ = static_cast<const uint8_t*>(map);
+    madvise(const_cast<uint8_t*>(map_), map_size_, MADV_SEQUENTIAL);
+
+    CaptureSegmentHeader header;
+    std::memcpy(&header, map_, sizeof(header));
+    if (header.magic != kCaptureMagic || header.version != kCaptureVersion) {
+        std::cerr << "[CaptureReader] Bad capture header: " << path << std::endl;
+        close();
+        return false;
+    }
+    used_ = std::min<size_t>(header.used_bytes, map_size_);
+    return true;
+}
+
+void CaptureReader::close() {
+    if (map_) {
+        munmap(const_cast<uint8_t*>(map_), map_size_);
+        map_ = nullptr;
+        map_size_ = 0;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    used_ = 0;
+}
+
+bool CaptureReader::forEach(const std::function<bool(const CaptureRecord&)>& fn) const {
+    size_t offset = kCaptureBlockSize;
+
+    while (offset + sizeof(CaptureRecordHeader) <= used_) {
+        CaptureRecordHeader header;
+        std::memcpy(&header, map_ + offset, sizeof(header));
+
+        size_t content = sizeof(header) + header.key_size + header.encoding_size + header.payload_size;
+        if (header.record_size < content || offset + header.record_size > used_) {
+            std::cerr << "[CaptureReader] Corrupt record at offset " << offset << std::endl;
+            return false;
+        }
+
+        const char* key = reinterpret_cast<const char*>(map_ + offset + sizeof(header));
+        CaptureRecord record;
+        record.receive_ns = header.receive_ns;
+        record.key = std::string_view(key, header.key_size);
+        record.encoding = std::string_view(key + header.key_size, header.encoding_size);
+        record.payload = map_ + offset + sizeof(header) + header.key_size + header.encoding_size;
+        record.payload_size = header.payload_size;
+
+        if (!fn(record)) {
+            break;
+        }
+        offset += header.record_size;
+    }
+    return true;
+}
+
+} // namespace data_bridge
@@ -1,16 +1,478 @@
 #include "common.h"
+#include "integrity.h"
+#include "json.h"
+#include "transcoder.h"
+#include <cmath>
 #include <fstream>
+#include <initializer_list>
+#include <limits>
 #include <sstream>
+#include <utility>
 
 namespace data_bridge {
 
-bool BridgeConfig::loadFromFile(const std::string& filepath) {
-    // TODO: Implement JSON parsing using nlohmann/json or similar
-    // For now, just return false to use default config
-    std::cerr << "[Config] JSON parsing not yet implemented, using default config" << std::endl;
+namespace {
+
+template <class Enum>
+using NameTable = std::initializer_list<std::pair<const char*, Enum>>;
+
+template <class Enum>
+bool parseName(const NameTable<Enum>& names, const std::string& name, Enum& value) {
+    for (const auto& entry : names) {
+        if (name == entry.first) {
+            value = entry.second;
+            return true;
+        }
+    }
     return false;
 }
 
+// Reads the members of one JSON object into config fields. A member of the wrong type or with
+// an unknown value fails the load; unknown keys are reported and ignored.
+class ObjectReader {
+public:
+    ObjectReader(const JsonValue& object, std::string path)
+        : object_(object), path_(std::move(path)), used_(object.size(), false) {}
+
+    void read(const char* key, std::string& out) {
+        if (const JsonValue* value = member(key, JsonValue::Type::STRING)) {
+            out = value->asString();
+        }
+    }
+
+    void read(const char* key, bool& out) {
+        if (const JsonValue* value = member(key, JsonValue::Type::BOOL)) {
+            out = value->asBool();
+        }
+    }
+
+    void read(const char* key, double& out) {
+        if (const JsonValue* value = member(key, JsonValue::Type::NUMBER)) {
+            out = value->asNumber();
+        }
+    }
+
+    void read(const char* key, int& out) { readInteger(key, out); }
+    void read(const char* key, size_t& out) { readInteger(key, out); }
+
+    // TCP/UDP port, checked here rather than failing later in inet_pton/htons
+    void readPort(const char* key, int& out) {
+        const JsonValue* value = member(key, JsonValue::Type::NUMBER);
+        int port = 0;
+        if (!value || !toInteger(*value, path_ + key, port)) {
+            return;
+        }
+        if (port < 1 || port > 65535) {
+            invalid(key, "expected a port number (1-65535), got " + std::to_string(port));
+            return;
+        }
+        out = port;
+    }
+
+    // Enum by name, through a table or one of the modules' own parsers
+    template <class Enum>
+    void read(const char* key, Enum& out, const NameTable<Enum>& names) {
+        const JsonValue* value = member(key, JsonValue::Type::STRING);
+        if (value && !parseName(names, value->asString(), out)) {
+            invalid(key, "unknown value '" + value->asString() + "'");
+        }
+    }
+
+    template <class Enum>
+    void read(const char* key, Enum& out, bool (*parse)(const std::string&, Enum&)) {
+        const JsonValue* value = member(key, JsonValue::Type::STRING);
+        if (value && !parse(value->asString(), out)) {
+            invalid(key, "unknown value '" + value->asString() + "'");
+        }
+    }
+
+    void read(const char* key, std::vector<std::string>& out) {
+        forEach(key, [&](const JsonValue& item, const std::string& path) {
+            if (item.type() != JsonValue::Type::STRING) {
+                return fail(path, "expected a string");
+            }
+            out.push_back(item.asString());
+            return true;
+        });
+    }
+
+    void read(const char* key, std::vector<int>& out) {
+        forEach(key, [&](const JsonValue& item, const std::string& path) {
+            int number = 0;
+            if (!toInteger(item, path, number)) {
+                return false;
+            }
+            out.push_back(number);
+            return true;
+        });
+    }
+
+    // Object members of an array, parse(object reader) per element
+    template <class Parse>
+    void readObjects(const char* key, Parse parse) {
+        forEach(key, [&](const JsonValue& item, const std::string& path) {
+            if (item.type() != JsonValue::Type::OBJECT) {
+                return fail(path, "expected an object");
+            }
+            ObjectReader reader(item, path + ".");
+            parse(reader);
+            return reader.finish();
+        });
+    }
+
+    // Nested object member
+    template <class Parse>
+    void readObject(const char* key, Parse parse) {
+        if (const JsonValue* value = member(key, JsonValue::Type::OBJECT)) {
+            ObjectReader reader(*value, path_ + key + ".");
+            parse(reader);
+            ok_ = reader.finish() && ok_;
+        }
+    }
+
+    // Report members nothing read, false if a member was invalid
+    bool finish() {
+        for (size_t i = 0; i < object_.size(); ++i) {
+            if (!used_[i]) {
+                std::cerr << "[Config] Unknown key '" << path_ << object_.key(i) << "' ignored" << std::endl;
+            }
+        }
+        return ok_;
+    }
+
+private:
+    const JsonValue* member(const char* key, JsonValue::Type type) {
+        for (size_t i = 0; i < object_.size(); ++i) {
+            if (object_.key(i) != key) {
+                continue;
+            }
+            used_[i] = true;
+            if (object_.at(i).type() != type) {
+                invalid(key, std::string("expected ") + JsonValue::typeName(type) + ", got " +
+                        JsonValue::typeName(object_.at(i).type()));
+                return nullptr;
+            }
+            return &object_.at(i);
+        }
+        return nullptr;
+    }
+
+    template <class Integer>
+    void readInteger(const char* key, Integer& out) {
+        if (const JsonValue* value = member(key, JsonValue::Type::NUMBER)) {
+            Integer number = 0;
+            if (toInteger(*value, path_ + key, number)) {
+                out = number;
+            }
+        }
+    }
+
+    template <class Integer>
+    bool toInteger(const JsonValue& value, const std::string& path, Integer& out) {
+        double number = value.asNumber();
+        if (value.type() != JsonValue::Type::NUMBER || std::floor(number) != number ||
+            number < static_cast<double>(std::numeric_limits<Integer>::min()) ||
+            number > static_cast<double>(std::numeric_limits<Integer>::max())) {
+            return fail(path, "expected an integer in range");
+        }
+        out = static_cast<Integer>(number);
+        return true;
+    }
+
+    template <class Visit>
+    void forEach(const char* key, Visit visit) {
+        const JsonValue* value = member(key, JsonValue::Type::ARRAY);
+        if (!value) {
+            return;
+        }
+        for (size_t i = 0; i < value->size(); ++i) {
+            if (!visit(value->at(i), path_ + key + "[" + std::to_string(i) + "]")) {
+                ok_ = false;
+            }
+        }
+    }
+
+    void invalid(const char* key, const std::string& reason) {
+        fail(path_ + key, reason);
+    }
+
+    bool fail(const std::string& path, const std::string& reason) {
+        std::cerr << "[Config] '" << path << "': " << reason << std::endl;
+        ok_ = false;
+        return false;
+    }
+
+private:
+    const JsonValue& object_;
+    std::string path_;                    // "streams[2]." for members of the third stream
+    std::vector<bool> used_;
+    bool ok_ = true;
+};
+
+// Config loading stays free of Zenoh, so PayloadCodec::parseType is not used here
+const NameTable<ProtocolType> kProtocols = {{"udp", ProtocolType::UDP}, {"grpc", ProtocolType::GRPC}};
+const NameTable<CompressionType> kCompressions = {
+    {"none", CompressionType::NONE}, {"lz4", CompressionType::LZ4}, {"zstd", CompressionType::ZSTD}};
+const NameTable<BackpressureAction> kBackpressureActions = {
+    {"none", BackpressureAction::NONE}, {"throttle", BackpressureAction::THROTTLE}, {"shed", BackpressureAction::SHED}};
+const NameTable<SequenceSource> kSequenceSources = {
+    {"none", SequenceSource::NONE}, {"source_info", SequenceSource::SOURCE_INFO},
+    {"payload_header", SequenceSource::PAYLOAD_HEADER}};
+const NameTable<IngestMode> kIngestModes = {
+    {"callback", IngestMode::CALLBACK}, {"ring", IngestMode::RING}, {"fifo", IngestMode::FIFO}};
+const NameTable<ServiceTransport> kServiceTransports = {
+    {"udp", ServiceTransport::UDP}, {"tcp", ServiceTransport::TCP}, {"unix", ServiceTransport::UNIX}};
+const NameTable<PollConsolidation> kPollConsolidations = {
+    {"auto", PollConsolidation::AUTO}, {"none", PollConsolidation::NONE},
+    {"monotonic", PollConsolidation::MONOTONIC}, {"latest", PollConsolidation::LATEST}};
+const NameTable<FieldType> kFieldTypes = {
+    {"BOOL", FieldType::BOOL}, {"INT32", FieldType::INT32}, {"UINT32", FieldType::UINT32},
+    {"INT64", FieldType::INT64}, {"UINT64", FieldType::UINT64}, {"FLOAT", FieldType::FLOAT},
+    {"DOUBLE", FieldType::DOUBLE}};
+const NameTable<FilterOp> kFilterOps = {
+    {"eq", FilterOp::EQ}, {"ne", FilterOp::NE}, {"lt", FilterOp::LT}, {"le", FilterOp::LE},
+    {"gt", FilterOp::GT}, {"ge", FilterOp::GE}, {"min_delta", FilterOp::MIN_DELTA},
+    {"max_age_ms", FilterOp::MAX_AGE_MS}};
+
+void readPlacement(ObjectReader& reader, ThreadPlacement& placement) {
+    reader.read("cpus", placement.cpus);
+    reader.read("realtime_priority", placement.realtime_priority);
+}
+
+void readTarget(ObjectReader& reader, StreamTarget& target) {
+    reader.read("protocol", target.protocol, kProtocols);
+    reader.read("local_host", target.local_host);
+    reader.readPort("local_port", target.local_port);
+    reader.read("grpc_service", target.grpc_service);
+    reader.read("grpc_method", target.grpc_method);
+}
+
+void readStream(ObjectReader& reader, StreamConfig& stream) {
+    reader.read("zenoh_topic", stream.zenoh_topic);
+    reader.read("protocol", stream.protocol, kProtocols);
+    reader.read("local_host", stream.local_host);
+    reader.readPort("local_port", stream.local_port);
+    reader.read("grpc_service", stream.grpc_service);
+    reader.read("grpc_method", stream.grpc_method);
+    reader.readObjects("extra_targets", [&](ObjectReader& target_reader) {
+        StreamTarget target;
+        readTarget(target_reader, target);
+        stream.extra_targets.push_back(target);
+    });
+
+    reader.read("compression", stream.compression, kCompressions);
+    reader.read("compression_min_size", stream.compression_min_size);
+    reader.read("compression_level", stream.compression_level);
+    reader.read("zstd_dictionary", stream.zstd_dictionary);
+
+    reader.read("cache_depth", stream.cache_depth);
+    reader.read("cache_max_payload", stream.cache_max_payload);
+    reader.read("cache_queryable", stream.cache_queryable);
+
+    reader.read("conflation_rate_hz", stream.conflation_rate_hz);
+    reader.read("conflation_consumer_paced", stream.conflation_consumer_paced);
+
+    reader.read("forwarding_worker", stream.forwarding_worker);
+    reader.read("low_latency", stream.low_latency);
+
+    reader.read("ingest", stream.ingest, kIngestModes);
+    reader.read("ingest_capacity", stream.ingest_capacity);
+    reader.read("ingest_batch", stream.ingest_batch);
+    reader.read("ingest_interval_us", stream.ingest_interval_us);
+
+    reader.read("sequence_source", stream.sequence_source, kSequenceSources);
+
+    reader.read("recoverable", stream.recoverable);
+    reader.read("recovery_history", stream.recovery_history);
+    reader.read("recovery_query_period_ms", stream.recovery_query_period_ms);
+    reader.read("recovery_query_timeout_ms", stream.recovery_query_timeout_ms);
+
+    reader.read("integrity", stream.integrity, Integrity::parseCheck);
+    reader.read("integrity_strip", stream.integrity_strip);
+
+    reader.read("lazy", stream.lazy);
+
+    reader.read("transcode_schema", stream.transcode_schema);
+    reader.read("transcode_from", stream.transcode_from, Transcoder::parseFormat);
+    reader.read("transcode_to", stream.transcode_to, Transcoder::parseFormat);
+    reader.read("transcode_fields", stream.transcode_fields);
+
+    reader.readObjects("filters", [&](ObjectReader& rule_reader) {
+        FilterRule rule;
+        rule_reader.read("field", rule.field);
+        rule_reader.read("offset", rule.offset);
+        rule_reader.read("type", rule.type, kFieldTypes);
+        rule_reader.read("op", rule.op, kFilterOps);
+        rule_reader.read("value", rule.value);
+        stream.filters.push_back(rule);
+    });
+    reader.read("filter_duplicates", stream.filter_duplicates);
+
+    reader.read("backpressure", stream.backpressure, kBackpressureActions);
+    reader.read("backpressure_priority", stream.backpressure_priority);
+    reader.read("backpressure_max_wait_us", stream.backpressure_max_wait_us);
+}
+
+void readService(ObjectReader& reader, ServiceConfig& service) {
+    reader.read("zenoh_key", service.zenoh_key);
+    reader.read("transport", service.transport, kServiceTransports);
+    reader.read("host", service.host);
+    reader.readPort("port", service.port);
+    reader.read("unix_path", service.unix_path);
+    reader.read("timeout_ms", service.timeout_ms);
+    reader.read("window", service.window);
+    reader.read("max_outstanding", service.max_outstanding);
+}
+
+void readPoll(ObjectReader& reader, PollConfig& poll) {
+    reader.read("zenoh_key", poll.zenoh_key);
+    reader.read("transport", poll.transport, kServiceTransports);
+    reader.read("host", poll.host);
+    reader.readPort("port", poll.port);
+    reader.read("unix_path", poll.unix_path);
+    reader.read("consolidation", poll.consolidation, kPollConsolidations);
+    reader.read("query_all", poll.query_all);
+    reader.read("timeout_ms", poll.timeout_ms);
+    reader.read("coalesce_ms", poll.coalesce_ms);
+}
+
+void readDestination(ObjectReader& reader, DestinationConfig& destination) {
+    reader.read("host", destination.host);
+    reader.readPort("port", destination.port);
+    reader.read("shards", destination.shards);
+    reader.read("send_buffer", destination.send_buffer);
+    reader.read("priority", destination.priority);
+    reader.read("dscp", destination.dscp);
+}
+
+void readBridge(ObjectReader& reader, BridgeConfig& config) {
+    reader.read("zenoh_mode", config.zenoh_mode);
+    reader.read("zenoh_connect", config.zenoh_connect);
+    reader.read("zenoh_low_latency", config.zenoh_low_latency);
+
+    reader.read("health_check_interval_ms", config.health_check_interval_ms);
+    reader.read("disconnect_grace_ms", config.disconnect_grace_ms);
+    reader.read("reconnect_backoff_initial_ms", config.reconnect_backoff_initial_ms);
+    reader.read("reconnect_backoff_max_ms", config.reconnect_backoff_max_ms);
+    reader.read("warm_standby", config.warm_standby);
+
+    reader.read("registration_port", config.registration_port);
+    reader.read("consumer_timeout_ms", config.consumer_timeout_ms);
+    reader.read("consumer_grace_ms", config.consumer_grace_ms);
+    reader.read("liveliness_prefix", config.liveliness_prefix);
+
+    reader.read("capture_dir", config.capture_dir);
+    reader.read("capture_segment_mb", config.capture_segment_mb);
+    reader.read("capture_ring_slots", config.capture_ring_slots);
+    reader.read("capture_max_record_kb", config.capture_max_record_kb);
+
+    reader.read("egress_backend", config.egress_backend);
+    reader.read("io_uring_engines", config.io_uring_engines);
+    reader.read("io_uring_queue_depth", config.io_uring_queue_depth);
+    reader.read("io_uring_buffer_size", config.io_uring_buffer_size);
+    reader.read("io_uring_zerocopy_threshold", config.io_uring_zerocopy_threshold);
+
+    reader.read("udp_connect", config.udp_connect);
+    reader.readObjects("destinations", [&](ObjectReader& destination_reader) {
+        DestinationConfig destination;
+        readDestination(destination_reader, destination);
+        config.destinations.push_back(destination);
+    });
+    reader.read("udp_gso", config.udp_gso);
+    reader.read("udp_zerocopy_threshold", config.udp_zerocopy_threshold);
+
+    reader.read("backpressure_interval_ms", config.backpressure_interval_ms);
+    reader.read("backpressure_high", config.backpressure_high);
+    reader.read("backpressure_critical", config.backpressure_critical);
+
+    reader.readObject("housekeeping", [&](ObjectReader& placement_reader) {
+        readPlacement(placement_reader, config.housekeeping);
+    });
+    reader.readObjects("forwarding_workers", [&](ObjectReader& placement_reader) {
+        ThreadPlacement placement;
+        readPlacement(placement_reader, placement);
+        config.forwarding_workers.push_back(placement);
+    });
+    reader.read("forwarding_queue_depth", config.forwarding_queue_depth);
+    reader.read("forwarding_spin_us", config.forwarding_spin_us);
+    reader.read("low_latency_idle_us", config.low_latency_idle_us);
+
+    reader.read("buffer_pool_hugepages", config.buffer_pool_hugepages);
+    reader.read("timer_tick_us", config.timer_tick_us);
+
+    reader.read("drain_timeout_ms", config.drain_timeout_ms);
+    reader.read("handoff_path", config.handoff_path);
+
+    reader.read("stats_interval_sec", config.stats_interval_sec);
+
+    reader.readObjects("streams", [&](ObjectReader& stream_reader) {
+        StreamConfig stream;
+        stream.protocol = ProtocolType::UDP;
+        stream.local_port = 0;
+        readStream(stream_reader, stream);
+        config.streams.push_back(stream);
+    });
+    reader.readObjects("services", [&](ObjectReader& service_reader) {
+        ServiceConfig service;
+        readService(service_reader, service);
+        config.services.push_back(service);
+    });
+    reader.readObjects("polls", [&](ObjectReader& poll_reader) {
+        PollConfig poll;
+        readPoll(poll_reader, poll);
+        config.polls.push_back(poll);
+    });
+}
+
+} // namespace
+
+std::vector<StreamTarget> StreamConfig::targets() const {
+    std::vector<StreamTarget> result;
+    
+    StreamTarget primary;
+    primary.protocol = protocol;
+    primary.local_host = local_host;
+    primary.local_port = local_port;
+    primary.grpc_service = grpc_service;
+    primary.grpc_method = grpc_method;
+    result.push_back(primary);
+    
+    result.insert(result.end(), extra_targets.begin(), extra_targets.end());
+    return result;
+}
+
+bool BridgeConfig::loadFromFile(const std::string& filepath) {
+    std::ifstream file(filepath);
+    if (!file) {
+        std::cerr << "[Config] Failed to open " << filepath << std::endl;
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+
+    JsonValue document;
+    std::string error;
+    if (!JsonValue::parse(text.str(), document, error)) {
+        std::cerr << "[Config] " << filepath << ": " << error << std::endl;
+        return false;
+    }
+    if (document.type() != JsonValue::Type::OBJECT) {
+        std::cerr << "[Config] " << filepath << ": expected an object" << std::endl;
+        return false;
+    }
+
+    // Fields absent from the file keep their defaults, nothing changes unless the whole file is valid
+    BridgeConfig config;
+    ObjectReader reader(document, "");
+    readBridge(reader, config);
+    if (!reader.finish()) {
+        std::cerr << "[Config] " << filepath << " is invalid" << std::endl;
+        return false;
+    }
+    *this = std::move(config);
+    return true;
+}
+
 BridgeConfig BridgeConfig::getDefault() {
     BridgeConfig config;
     config.zenoh_mode = "client";
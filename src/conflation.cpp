@@ -0,0 +1,70 @@
+#include "conflation.h"
+
+namespace data_bridge {
+
+Conflater::Conflater(bool consumer_paced)
+    : consumer_paced_(consumer_paced) {
+}
+
+bool Conflater::store(std::string_view key, const PayloadBuffer& payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.stored++;
+
+    auto it = pending_.find(key);
+    if (it == pending_.end()) {
+        it = pending_.emplace(std::string(key), Pending{}).first;
+    }
+
+    Pending& pending = it->second;
+    if (pending.dirty) {
+        stats_.conflated++;
+    } else {
+        pending.dirty = true;
+        dirty_count_++;
+    }
+    pending.payload = payload;
+
+    // A consumer that is already waiting gets the sample immediately
+    return consumer_paced_ && credit_;
+}
+
+void Conflater::grant() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    credit_ = true;
+}
+
+size_t Conflater::flush(const SendFunction& send) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (dirty_count_ == 0 || (consumer_paced_ && !credit_)) {
+        return 0;
+    }
+
+    batch_.clear();
+    for (auto& entry : pending_) {
+        Pending& pending = entry.second;
+        if (!pending.dirty) {
+            continue;
+        }
+        pending.dirty = false;
+        batch_.push_back(pending.payload.view());
+    }
+    size_t sent = send(batch_.data(), batch_.size());
+
+    for (auto& entry : pending_) {
+        if (!entry.second.dirty) {
+            entry.second.payload.reset();
+        }
+    }
+
+    dirty_count_ = 0;
+    credit_ = false;
+    stats_.forwarded += sent;
+    return sent;
+}
+
+ConflationStats Conflater::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace data_bridge
@@ -0,0 +1,134 @@
+#include "consumer_registry.h"
+#include "thread_placement.h"
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace data_bridge {
+
+namespace {
+
+constexpr const char* kHelloPrefix = "HELLO ";
+constexpr const char* kReadyPrefix = "READY ";
+constexpr const char* kAlivePrefix = "ALIVE ";
+constexpr const char* kByePrefix = "BYE ";
+
+bool hasPrefix(const std::string& message, const char* prefix) {
+    return message.compare(0, strlen(prefix), prefix) == 0;
+}
+
+// Poll timeout, bounds how long stop() waits for the receive thread
+constexpr int kPollTimeoutMs = 200;
+
+} // namespace
+
+ConsumerRegistry::ConsumerRegistry(int port)
+    : port_(port) {
+}
+
+ConsumerRegistry::~ConsumerRegistry() {
+    stop();
+}
+
+bool ConsumerRegistry::start(MessageCallback callback, int inherited) {
+    if (running_) {
+        std::cerr << "[ConsumerRegistry] Already running" << std::endl;
+        return false;
+    }
+
+    if (inherited >= 0) {
+        socket_ = inherited;
+    } else if (!bindSocket()) {
+        return false;
+    }
+
+    callback_ = std::move(callback);
+    running_ = true;
+    receive_thread_ = std::thread(&ConsumerRegistry::receiveLoop, this);
+
+    std::cout << "[ConsumerRegistry] Listening for consumers on UDP port " << port_ << std::endl;
+    return true;
+}
+
+void ConsumerRegistry::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (receive_thread_.joinable()) {
+        receive_thread_.join();
+    }
+
+    close(socket_);
+    socket_ = -1;
+}
+
+bool ConsumerRegistry::bindSocket() {
+    socket_ = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socket_ < 0) {
+        std::cerr << "[ConsumerRegistry] Failed to create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = INADDR_ANY;
+    addr.sin_port = htons(port_);
+
+    if (bind(socket_, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        std::cerr << "[ConsumerRegistry] Failed to bind port " << port_ << ": " << strerror(errno) << std::endl;
+        close(socket_);
+        socket_ = -1;
+        return false;
+    }
+    return true;
+}
+
+void ConsumerRegistry::receiveLoop() {
+    ThreadRegistration registration("consumer-reg");
+    char buffer[1024];
+    struct pollfd pfd = {socket_, POLLIN, 0};
+
+    while (running_) {
+        int ready = poll(&pfd, 1, kPollTimeoutMs);
+        if (ready <= 0) {
+            continue;
+        }
+
+        // A predecessor handing over still reads the same socket, it may have taken the datagram
+        ssize_t received = recv(socket_, buffer, sizeof(buffer), MSG_DONTWAIT);
+        if (received <= 0) {
+            continue;
+        }
+
+        std::string message(buffer, received);
+        while (!message.empty() && (message.back() == '\n' || message.back() == '\r')) {
+            message.pop_back();
+        }
+
+        if (hasPrefix(message, kHelloPrefix)) {
+            std::string topic = message.substr(strlen(kHelloPrefix));
+            std::cout << "[ConsumerRegistry] Consumer registered for: " << topic << std::endl;
+            callback_(ConsumerMessage::HELLO, topic);
+        } else if (hasPrefix(message, kReadyPrefix)) {
+            callback_(ConsumerMessage::READY, message.substr(strlen(kReadyPrefix)));
+        } else if (hasPrefix(message, kAlivePrefix)) {
+            callback_(ConsumerMessage::ALIVE, message.substr(strlen(kAlivePrefix)));
+        } else if (hasPrefix(message, kByePrefix)) {
+            std::string topic = message.substr(strlen(kByePrefix));
+            std::cout << "[ConsumerRegistry] Consumer left: " << topic << std::endl;
+            callback_(ConsumerMessage::BYE, topic);
+        } else {
+            std::cerr << "[ConsumerRegistry] Ignoring unknown message: " << message << std::endl;
+        }
+    }
+}
+
+} // namespace data_bridge
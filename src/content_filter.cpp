@@ -0,0 +1,235 @@
+#include "content_filter.h"
+#include "hash.h"
+#include "transcoder.h"
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace data_bridge {
+
+namespace {
+
+bool isSigned(FieldType type) {
+    return type == FieldType::INT32 || type == FieldType::INT64;
+}
+
+bool isReal(FieldType type) {
+    return type == FieldType::FLOAT || type == FieldType::DOUBLE;
+}
+
+double toReal(FieldType type, const FieldValue& value) {
+    if (isReal(type)) {
+        return value.d;
+    }
+    return isSigned(type) ? static_cast<double>(value.i) : static_cast<double>(value.u);
+}
+
+// Integral and exactly representable as a 64-bit integer
+bool isIntegral(double value) {
+    return std::trunc(value) == value && std::fabs(value) < 9.0e18;
+}
+
+template <class T>
+bool compare(T a, FilterOp op, T b) {
+    switch (op) {
+        case FilterOp::EQ: return a == b;
+        case FilterOp::NE: return a != b;
+        case FilterOp::LT: return a < b;
+        case FilterOp::LE: return a <= b;
+        case FilterOp::GT: return a > b;
+        default: return a >= b;
+    }
+}
+
+} // namespace
+
+ContentFilter::ContentFilter(const StreamConfig& config, const SchemaDescriptor* decoded)
+    : rules_(config.filters)
+    , drop_duplicates_(config.filter_duplicates)
+    , input_format_(config.transcode_from)
+    , schema_name_(config.transcode_schema)
+    , decoded_(decoded) {
+}
+
+bool ContentFilter::init() {
+    payload_program_.clear();
+    field_program_.clear();
+    last_values_.clear();
+    pending_values_.clear();
+    has_last_ = false;
+
+    for (const auto& rule : rules_) {
+        if (!compile(rule)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ContentFilter::compile(const FilterRule& rule) {
+    Instruction instruction{};
+    instruction.op = rule.op;
+    bool decoded = false;
+
+    if (rule.field.empty()) {
+        if (rule.offset > std::numeric_limits<uint32_t>::max()) {
+            std::cerr << "[ContentFilter] Offset " << rule.offset << " out of range" << std::endl;
+            return false;
+        }
+        instruction.type = rule.type;
+        instruction.location = static_cast<uint32_t>(rule.offset);
+    } else {
+        const SchemaDescriptor* schema = findSchema(schema_name_);
+        if (!schema) {
+            std::cerr << "[ContentFilter] Rule on field '" << rule.field << "' needs transcode_schema" << std::endl;
+            return false;
+        }
+        size_t index = 0;
+        while (index < schema->field_count && rule.field != schema->fields[index].name) {
+            ++index;
+        }
+        if (index == schema->field_count) {
+            std::cerr << "[ContentFilter] Schema '" << schema->name << "' has no field '" << rule.field << "'"
+                      << std::endl;
+            return false;
+        }
+        instruction.type = schema->fields[index].type;
+        if (input_format_ == PayloadFormat::STRUCT) {
+            // Packed structs are read in place, before anything is decoded
+            instruction.location = schema->fields[index].offset;
+        } else if (decoded_ == schema) {
+            instruction.location = static_cast<uint32_t>(index);
+            decoded = true;
+        } else {
+            std::cerr << "[ContentFilter] Rule on field '" << rule.field << "' of a "
+                      << Transcoder::formatName(input_format_) << " payload needs a transcoder to decode it"
+                      << std::endl;
+            return false;
+        }
+    }
+
+    switch (rule.op) {
+        case FilterOp::MIN_DELTA:
+            instruction.domain = Domain::REAL;
+            instruction.operand.d = std::fabs(rule.value);
+            instruction.slot = static_cast<int>(last_values_.size());
+            last_values_.push_back(0.0);
+            pending_values_.push_back(0.0);
+            break;
+        case FilterOp::MAX_AGE_MS:
+            if (instruction.type != FieldType::INT64 && instruction.type != FieldType::UINT64) {
+                std::cerr << "[ContentFilter] max_age_ms needs a 64-bit nanosecond timestamp" << std::endl;
+                return false;
+            }
+            instruction.domain = Domain::SIGNED;
+            instruction.operand.i = std::llround(rule.value * 1e6);
+            break;
+        default:
+            // Integers compare as integers unless the operand is fractional or out of their range
+            if (isReal(instruction.type) || !isIntegral(rule.value)) {
+                instruction.domain = Domain::REAL;
+                instruction.operand.d = rule.value;
+            } else if (isSigned(instruction.type)) {
+                instruction.domain = Domain::SIGNED;
+                instruction.operand.i = static_cast<int64_t>(rule.value);
+            } else if (rule.value >= 0.0) {
+                instruction.domain = Domain::UNSIGNED;
+                instruction.operand.u = static_cast<uint64_t>(rule.value);
+            } else {
+                instruction.domain = Domain::REAL;
+                instruction.operand.d = rule.value;
+            }
+            break;
+    }
+
+    (decoded ? field_program_ : payload_program_).push_back(instruction);
+    return true;
+}
+
+bool ContentFilter::evaluate(const Instruction& instruction, const FieldValue& value) {
+    switch (instruction.op) {
+        case FilterOp::MIN_DELTA: {
+            double current = toReal(instruction.type, value);
+            pending_values_[instruction.slot] = current;
+            return !has_last_ || std::fabs(current - last_values_[instruction.slot]) >= instruction.operand.d;
+        }
+        case FilterOp::MAX_AGE_MS: {
+            if (now_ns_ == 0) {
+                now_ns_ = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count();
+            }
+            // Both types hold the same bits, stamps from the future have a negative age
+            return now_ns_ - value.i <= instruction.operand.i;
+        }
+        default:
+            break;
+    }
+
+    switch (instruction.domain) {
+        case Domain::SIGNED: return compare(value.i, instruction.op, instruction.operand.i);
+        case Domain::UNSIGNED: return compare(value.u, instruction.op, instruction.operand.u);
+        default: return compare(toReal(instruction.type, value), instruction.op, instruction.operand.d);
+    }
+}
+
+bool ContentFilter::admitPayload(ByteView payload) {
+    now_ns_ = 0;
+    for (const auto& instruction : payload_program_) {
+        // A payload too short for the rule does not match it
+        if (instruction.location + fieldTypeSize(instruction.type) > payload.size ||
+            !evaluate(instruction, loadFieldValue(instruction.type, payload.data + instruction.location))) {
+            filtered_++;
+            return false;
+        }
+    }
+
+    // Last, hashing reads the whole payload
+    if (drop_duplicates_) {
+        pending_hash_ = xxhash64(payload.data, payload.size);
+        pending_size_ = payload.size;
+        if (has_last_ && pending_hash_ == last_hash_ && pending_size_ == last_size_) {
+            duplicates_++;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ContentFilter::admitFields(const FieldValue* values) {
+    for (const auto& instruction : field_program_) {
+        if (!evaluate(instruction, values[instruction.location])) {
+            filtered_++;
+            return false;
+        }
+    }
+    return true;
+}
+
+void ContentFilter::commit() {
+    last_hash_ = pending_hash_;
+    last_size_ = pending_size_;
+    last_values_.swap(pending_values_);
+    has_last_ = true;
+    passed_++;
+}
+
+std::string ContentFilter::describe() const {
+    std::string text = std::to_string(rules_.size()) + (rules_.size() == 1 ? " rule" : " rules");
+    if (!field_program_.empty()) {
+        text += " (" + std::to_string(field_program_.size()) + " on decoded fields)";
+    }
+    if (drop_duplicates_) {
+        text += ", duplicates dropped";
+    }
+    return text;
+}
+
+FilterStats ContentFilter::getStats() const {
+    FilterStats stats;
+    stats.passed = passed_.load(std::memory_order_relaxed);
+    stats.filtered = filtered_.load(std::memory_order_relaxed);
+    stats.duplicates = duplicates_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace data_bridge
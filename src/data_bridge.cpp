@@ -1,24 +1,30 @@
 #include "receiver_bridge.h"
+#include "thread_placement.h"
 #include <iostream>
+#include <algorithm>
 #include <csignal>
-#include <atomic>
-#include <thread>
-
-std::atomic<bool> running(true);
-
-void signalHandler(int signum) {
-    std::cout << "\n[Main] Interrupt signal (" << signum << ") received" << std::endl;
-    running.store(false);
-}
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/signalfd.h>
 
 int main(int argc, char** argv) {
     std::cout << "===========================================\n";
     std::cout << "  Zenoh Data Receiver Bridge\n";
     std::cout << "===========================================\n\n";
 
-    // Register signal handlers
-    signal(SIGINT, signalHandler);
-    signal(SIGTERM, signalHandler);
+    // SIGINT and SIGTERM are read from a signalfd. Blocked before any thread starts, so every thread inherits the mask.
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    int signal_fd = signalfd(-1, &signals, SFD_CLOEXEC);
+    if (signal_fd < 0) {
+        std::cerr << "[Main] Failed to create signalfd: " << strerror(errno) << std::endl;
+        return 1;
+    }
 
     // Load configuration
     data_bridge::BridgeConfig config;
@@ -47,8 +53,18 @@ int main(int argc, char** argv) {
         std::cout << "      Protocol: " << (stream.protocol == data_bridge::ProtocolType::UDP ? "UDP" : "GRPC") << std::endl;
         std::cout << "      Target: " << stream.local_host << ":" << stream.local_port << std::endl;
     }
+    if (!config.services.empty()) {
+        std::cout << "  Services: " << config.services.size() << std::endl;
+    }
+    if (!config.polls.empty()) {
+        std::cout << "  Poll endpoints: " << config.polls.size() << std::endl;
+    }
     std::cout << std::endl;
 
+    // Zenoh and support threads are created later and inherit this placement
+    data_bridge::applyThreadPlacement(config.housekeeping, "main");
+    data_bridge::ThreadMonitor::instance().add("main");
+
     // Create and start receiver bridge
     try {
         data_bridge::ReceiverBridge bridge(config);
@@ -60,12 +76,46 @@ int main(int argc, char** argv) {
 
         std::cout << "[Main] Receiver bridge running. Press Ctrl+C to stop..." << std::endl;
 
-        // Main loop
-        while (running.load()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // Main loop: sleeps until a signal, a successor taking over, or the next stats report
+        pollfd events[2] = {{signal_fd, POLLIN, 0}, {bridge.shutdownFd(), POLLIN, 0}};
+        auto stats_interval = std::chrono::seconds(config.stats_interval_sec);
+        auto next_stats = std::chrono::steady_clock::now() + stats_interval;
+        while (true) {
+            int timeout = -1;
+            if (config.stats_interval_sec > 0) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    next_stats - std::chrono::steady_clock::now());
+                timeout = static_cast<int>(std::max<int64_t>(wait.count(), 0));
+            }
+            if (poll(events, 2, timeout) < 0 && errno != EINTR) {
+                std::cerr << "[Main] poll failed: " << strerror(errno) << std::endl;
+                break;
+            }
+            
+            if (events[0].revents & POLLIN) {
+                signalfd_siginfo info{};
+                if (read(signal_fd, &info, sizeof(info)) == static_cast<ssize_t>(sizeof(info))) {
+                    std::cout << "\n[Main] Interrupt signal (" << info.ssi_signo << ") received" << std::endl;
+                }
+                break;
+            }
+            if (events[1].revents & POLLIN) {
+                std::cout << "\n[Main] A restarted bridge took over" << std::endl;
+                break;
+            }
+            
+            auto now = std::chrono::steady_clock::now();
+            if (config.stats_interval_sec > 0 && now >= next_stats) {
+                bridge.printStats(std::cout);
+                next_stats = now + stats_interval;
+            }
         }
 
+        // A second signal during the drain ends the process right away
+        pthread_sigmask(SIG_UNBLOCK, &signals, nullptr);
+
         std::cout << "\n[Main] Shutting down receiver bridge..." << std::endl;
+        bridge.printStats(std::cout);
         bridge.stop();
         
     } catch (const std::exception& e) {
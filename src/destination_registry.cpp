@@ -0,0 +1,234 @@
+#include "destination_registry.h"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <linux/sockios.h>
+
+namespace data_bridge {
+
+namespace {
+
+// Spreads forwarding threads over the shards of every destination
+std::atomic<size_t> g_next_thread_slot{0};
+
+size_t threadSlot() {
+    thread_local size_t slot = g_next_thread_slot.fetch_add(1, std::memory_order_relaxed);
+    return slot;
+}
+
+} // namespace
+
+UdpDestination::UdpDestination(const DestinationConfig& config, const BridgeConfig& bridge_config)
+    : config_(config),
+      connect_(bridge_config.udp_connect),
+      gso_(bridge_config.udp_gso),
+      zerocopy_threshold_(bridge_config.udp_zerocopy_threshold),
+      name_(config.host + ":" + std::to_string(config.port)) {
+}
+
+UdpDestination::~UdpDestination() {
+    for (auto& shard : shards_) {
+        shard.sender.reset();
+        if (shard.fd >= 0) {
+            close(shard.fd);
+        }
+    }
+}
+
+bool UdpDestination::open(std::vector<int> inherited) {
+    size_t shard_count = std::max<size_t>(config_.shards, 1);
+    for (int fd : inherited) {
+        // Zerocopy sequence numbers continue where the previous bridge stopped, a fresh socket starts at 0
+        if (shards_.size() < shard_count && zerocopy_threshold_ == 0) {
+            Shard shard;
+            shard.fd = fd;
+            shards_.push_back(std::move(shard));
+        } else {
+            close(fd);
+        }
+    }
+
+    addr_.sin_family = AF_INET;
+    addr_.sin_port = htons(config_.port);
+    if (inet_pton(AF_INET, config_.host.c_str(), &addr_.sin_addr) <= 0) {
+        std::cerr << "[DestinationRegistry] Invalid UDP address: " << config_.host << std::endl;
+        return false;
+    }
+
+    while (shards_.size() < shard_count) {
+        Shard shard;
+        shard.fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (shard.fd < 0) {
+            std::cerr << "[DestinationRegistry] Failed to create UDP socket: " << strerror(errno) << std::endl;
+            return false;
+        }
+        shards_.push_back(std::move(shard));
+    }
+
+    // Inherited sockets get the current options too
+    for (auto& shard : shards_) {
+        if (!configureSocket(shard.fd)) {
+            return false;
+        }
+
+        // A socket that cannot connect still works with an address per send
+        bool connected = false;
+        if (connect_) {
+            connected = connect(shard.fd, reinterpret_cast<const sockaddr*>(&addr_), sizeof(addr_)) == 0;
+            if (!connected) {
+                std::cerr << "[DestinationRegistry] Failed to connect to " << name_ << ": "
+                          << strerror(errno) << ", sending unconnected" << std::endl;
+            }
+        }
+
+        shard.sender = std::make_unique<UdpSender>(shard.fd, addr_, connected, gso_, zerocopy_threshold_);
+    }
+
+    return true;
+}
+
+bool UdpDestination::configureSocket(int fd) {
+    if (config_.send_buffer > 0 &&
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &config_.send_buffer, sizeof(config_.send_buffer)) < 0) {
+        std::cerr << "[DestinationRegistry] Failed to set SO_SNDBUF on " << name_ << ": "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (config_.priority >= 0 &&
+        setsockopt(fd, SOL_SOCKET, SO_PRIORITY, &config_.priority, sizeof(config_.priority)) < 0) {
+        std::cerr << "[DestinationRegistry] Failed to set SO_PRIORITY on " << name_ << ": "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+
+    if (config_.dscp >= 0) {
+        // DSCP occupies the upper six bits of the TOS byte
+        int tos = (config_.dscp & 0x3f) << 2;
+        if (setsockopt(fd, IPPROTO_IP, IP_TOS, &tos, sizeof(tos)) < 0) {
+            std::cerr << "[DestinationRegistry] Failed to set IP_TOS on " << name_ << ": "
+                      << strerror(errno) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+UdpSender& UdpDestination::sender() {
+    return *shards_[shardIndex()].sender;
+}
+
+size_t UdpDestination::shardIndex() const {
+    return threadSlot() % shards_.size();
+}
+
+std::vector<int> UdpDestination::sockets() const {
+    std::vector<int> fds;
+    for (const auto& shard : shards_) {
+        fds.push_back(shard.fd);
+    }
+    return fds;
+}
+
+UdpSenderStats UdpDestination::getStats() const {
+    UdpSenderStats total;
+    for (const auto& shard : shards_) {
+        auto stats = shard.sender->getStats();
+        total.gso_batches += stats.gso_batches;
+        total.gso_datagrams += stats.gso_datagrams;
+        total.zerocopy_sends += stats.zerocopy_sends;
+        total.zerocopy_copied += stats.zerocopy_copied;
+        total.zerocopy_fallbacks += stats.zerocopy_fallbacks;
+    }
+    return total;
+}
+
+SocketQueue UdpDestination::sendQueue() const {
+    SocketQueue total;
+    for (const auto& shard : shards_) {
+        int queued = 0;
+        int capacity = 0;
+        socklen_t len = sizeof(capacity);
+        if (ioctl(shard.fd, SIOCOUTQ, &queued) == 0 &&
+            getsockopt(shard.fd, SOL_SOCKET, SO_SNDBUF, &capacity, &len) == 0) {
+            total.queued += static_cast<uint64_t>(std::max(queued, 0));
+            total.capacity += static_cast<uint64_t>(std::max(capacity, 0));
+        }
+    }
+    return total;
+}
+
+DestinationPressure UdpDestination::getPressure() const {
+    std::lock_guard<std::mutex> lock(pressure_mutex_);
+    return pressure_;
+}
+
+void UdpDestination::setPressure(const DestinationPressure& pressure) {
+    std::lock_guard<std::mutex> lock(pressure_mutex_);
+    pressure_ = pressure;
+    pressure_level_.store(pressure.level, std::memory_order_relaxed);
+}
+
+DestinationRegistry::DestinationRegistry(const BridgeConfig& config)
+    : config_(config) {
+}
+
+std::shared_ptr<UdpDestination> DestinationRegistry::acquire(const std::string& host, int port,
+                                                              std::vector<int> inherited) {
+    std::string name = host + ":" + std::to_string(port);
+    auto it = destinations_.find(name);
+    if (it != destinations_.end()) {
+        return it->second;
+    }
+
+    DestinationConfig options;
+    for (const auto& configured : config_.destinations) {
+        if (configured.host == host && configured.port == port) {
+            options = configured;
+            break;
+        }
+    }
+    options.host = host;
+    options.port = port;
+
+    size_t inherited_count = inherited.size();
+    auto destination = std::make_shared<UdpDestination>(options, config_);
+    if (!destination->open(std::move(inherited))) {
+        return nullptr;
+    }
+
+    std::cout << "[DestinationRegistry] Opened " << name << " (" << destination->shardCount()
+              << " socket(s)" << (config_.udp_connect ? ", connected" : "")
+              << (inherited_count == 0 ? "" : destination->zeroCopy() ? ", not taken over (zerocopy)" : ", taken over")
+              << ")" << std::endl;
+    destinations_.emplace(name, destination);
+    return destination;
+}
+
+std::vector<std::shared_ptr<UdpDestination>> DestinationRegistry::all() const {
+    std::vector<std::shared_ptr<UdpDestination>> result;
+    for (const auto& entry : destinations_) {
+        result.push_back(entry.second);
+    }
+    return result;
+}
+
+std::map<std::string, std::vector<int>> DestinationRegistry::handoffSockets() const {
+    std::map<std::string, std::vector<int>> sockets;
+    for (const auto& entry : destinations_) {
+        if (!entry.second->zeroCopy()) {
+            sockets["udp:" + entry.first] = entry.second->sockets();
+        }
+    }
+    return sockets;
+}
+
+void DestinationRegistry::clear() {
+    destinations_.clear();
+}
+
+} // namespace data_bridge
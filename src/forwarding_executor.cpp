@@ -0,0 +1,591 @@
+#include "forwarding_executor.h"
+#include "thread_placement.h"
+#include <algorithm>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+
+namespace data_bridge {
+
+namespace {
+
+// Tasks a worker runs from one stream before giving other streams a turn
+constexpr size_t kStreamBudget = 32;
+
+// Busy workers still look at newly scheduled streams this often
+constexpr uint32_t kInjectionInterval = 16;
+
+// Upper bound on a park, in case a wakeup is missed
+constexpr auto kIdleWait = std::chrono::milliseconds(100);
+
+// Spin a little after an early wakeup even if the spin had decayed to zero
+constexpr int64_t kMinSpinNs = 1000;
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Queue delay histogram: four buckets per power of two of nanoseconds
+constexpr size_t kDelayBuckets = 256;
+
+size_t delayBucket(uint64_t ns) {
+    if (ns < 4) {
+        return ns;
+    }
+    int msb = 63 - __builtin_clzll(ns);
+    return static_cast<size_t>(msb - 1) * 4 + ((ns >> (msb - 2)) & 3);
+}
+
+// Largest delay that falls into a bucket
+uint64_t delayBucketLimit(size_t bucket) {
+    if (bucket < 4) {
+        return bucket;
+    }
+    int shift = static_cast<int>(bucket / 4) - 1;
+    uint64_t lower = (4 + bucket % 4) << shift;
+    return lower + (uint64_t(1) << shift) - 1;
+}
+
+// Counters written only by the owning worker, read by getStats()
+void bump(std::atomic<uint64_t>& counter, uint64_t value = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void recordMax(std::atomic<uint64_t>& max, uint64_t value) {
+    if (value > max.load(std::memory_order_relaxed)) {
+        max.store(value, std::memory_order_relaxed);
+    }
+}
+
+// Bounded MPMC queue (Vyukov), push() moves from value only on success
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity)
+        : slots_(roundUpPowerOfTwo(std::max<size_t>(capacity, 2))),
+          mask_(slots_.size() - 1) {
+        for (size_t i = 0; i < slots_.size(); ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(T& value) {
+        Slot* slot;
+        uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->value = std::move(value);
+        slot->sequence.store(pos + 1, std::memory_order_seq_cst);
+        return true;
+    }
+
+    bool pop(T& value) {
+        Slot* slot;
+        uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(slot->value);
+        slot->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        uint64_t pos = dequeue_pos_.load(std::memory_order_seq_cst);
+        return slots_[pos & mask_].sequence.load(std::memory_order_seq_cst) != pos + 1;
+    }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        T value{};
+    };
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> enqueue_pos_{0};
+    alignas(64) std::atomic<uint64_t> dequeue_pos_{0};
+};
+
+// Run queue of one worker: only the owner pushes, the owner and thieves take
+// from the front, so the owner's streams take turns in FIFO order. A stream
+// is in at most one queue at a time, capacity for all streams means it never
+// fills.
+template <typename T>
+class RunQueue {
+public:
+    explicit RunQueue(size_t capacity)
+        : items_(roundUpPowerOfTwo(std::max<size_t>(capacity, 2))),
+          mask_(items_.size() - 1) {
+    }
+
+    void push(T* item) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        items_[tail & mask_].store(item, std::memory_order_relaxed);
+        tail_.store(tail + 1, std::memory_order_seq_cst);
+    }
+
+    T* take() {
+        uint64_t head = head_.load(std::memory_order_seq_cst);
+        for (;;) {
+            if (head >= tail_.load(std::memory_order_seq_cst)) {
+                return nullptr;
+            }
+            // May be stale if the slot was reused, the CAS then fails
+            T* item = items_[head & mask_].load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(head, head + 1, std::memory_order_seq_cst)) {
+                return item;
+            }
+        }
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_seq_cst) >= tail_.load(std::memory_order_seq_cst);
+    }
+
+private:
+    std::vector<std::atomic<T*>> items_;
+    size_t mask_;
+    alignas(64) std::atomic<uint64_t> head_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0};
+};
+
+} // namespace
+
+struct ForwardingExecutor::StreamQueue {
+    StreamQueue(size_t depth, int pinned)
+        : tasks(depth), pinned_worker(pinned) {
+    }
+
+    BoundedQueue<ForwardTask> tasks;
+    int pinned_worker;
+    std::atomic<bool> scheduled{false};       // Queued somewhere or owned by a worker
+};
+
+struct ForwardingExecutor::Worker {
+    size_t index = 0;
+    ThreadPlacement placement;
+    std::unique_ptr<RunQueue<StreamQueue>> local;  // Owner pushes, any worker takes
+    std::unique_ptr<BoundedQueue<StreamQueue*>> pinned;  // Streams only this worker runs
+    bool busy_poll = false;                   // Runs only its pinned streams and polls for them
+    std::thread thread;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> parked{false};
+    int64_t spin_ns = 0;                      // Worker thread only
+    uint32_t runs = 0;                        // Worker thread only
+
+    std::atomic<uint64_t> forwarded{0};
+    std::atomic<uint64_t> steals{0};
+    std::atomic<uint64_t> parks{0};
+    std::atomic<uint64_t> max_delay_ns{0};
+    std::atomic<int64_t> current_spin_ns{0};
+    std::atomic<uint64_t> spin_time_ns{0};
+    std::atomic<uint64_t> park_time_ns{0};
+    std::array<std::atomic<uint64_t>, kDelayBuckets> delays{};
+};
+
+struct ForwardingExecutor::Injection {
+    explicit Injection(size_t capacity) : queue(capacity) {}
+
+    BoundedQueue<StreamQueue*> queue;
+};
+
+ForwardingExecutor::ForwardingExecutor(const std::vector<ThreadPlacement>& workers, size_t queue_depth,
+                                       std::chrono::microseconds max_spin,
+                                       std::chrono::microseconds busy_poll_idle, Handler handler)
+    : queue_depth_(queue_depth),
+      max_spin_ns_(std::max<int64_t>(max_spin.count(), 0) * 1000),
+      busy_poll_ns_(std::max<int64_t>(busy_poll_idle.count(), 0) * 1000),
+      handler_(std::move(handler)) {
+    for (size_t i = 0; i < workers.size(); ++i) {
+        auto worker = std::make_unique<Worker>();
+        worker->index = i;
+        worker->placement = workers[i];
+        worker->spin_ns = max_spin_ns_;
+        workers_.push_back(std::move(worker));
+    }
+}
+
+ForwardingExecutor::~ForwardingExecutor() {
+    stop();
+}
+
+int ForwardingExecutor::addStream(int pinned_worker, bool busy_poll) {
+    if (pinned_worker >= static_cast<int>(workers_.size())) {
+        std::cerr << "[ForwardingExecutor] No worker " << pinned_worker << ", stream is not pinned" << std::endl;
+        pinned_worker = -1;
+    }
+    if (busy_poll) {
+        if (pinned_worker < 0) {
+            std::cerr << "[ForwardingExecutor] Busy polling needs a pinned stream" << std::endl;
+        } else {
+            workers_[pinned_worker]->busy_poll = true;
+        }
+    }
+    streams_.push_back(std::make_unique<StreamQueue>(queue_depth_, pinned_worker));
+    return static_cast<int>(streams_.size()) - 1;
+}
+
+const ThreadPlacement& ForwardingExecutor::placement(size_t worker) const {
+    return workers_[worker]->placement;
+}
+
+bool ForwardingExecutor::start() {
+    if (running_) {
+        std::cerr << "[ForwardingExecutor] Already running" << std::endl;
+        return false;
+    }
+    if (workers_.empty()) {
+        return false;
+    }
+    if (std::all_of(workers_.begin(), workers_.end(), [](const auto& worker) { return worker->busy_poll; })) {
+        std::cerr << "[ForwardingExecutor] Every worker is dedicated to busy polling, "
+                  << "unpinned streams would never run" << std::endl;
+        return false;
+    }
+
+    // Every scheduling queue can hold all streams at once
+    injection_ = std::make_unique<Injection>(streams_.size());
+    for (auto& worker : workers_) {
+        worker->local = std::make_unique<RunQueue<StreamQueue>>(streams_.size());
+        worker->pinned = std::make_unique<BoundedQueue<StreamQueue*>>(streams_.size());
+    }
+
+    running_ = true;
+    for (auto& worker : workers_) {
+        worker->thread = std::thread(&ForwardingExecutor::run, this, std::ref(*worker));
+    }
+    return true;
+}
+
+bool ForwardingExecutor::drain(std::chrono::steady_clock::time_point deadline) {
+    for (const auto& stream : streams_) {
+        // Scheduled covers a stream whose last task is still being forwarded
+        while (!stream->tasks.empty() || stream->scheduled.load(std::memory_order_seq_cst)) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+    return true;
+}
+
+void ForwardingExecutor::stop(bool discard) {
+    discard_ = discard;
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    for (auto& worker : workers_) {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->cv.notify_one();
+    }
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+bool ForwardingExecutor::post(int stream_id, ForwardTask&& task) {
+    if (!running_.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    StreamQueue& stream = *streams_[stream_id];
+    task.enqueue_ns = steadyNowNs();
+
+    // Wait for the stream's worker instead of dropping or reordering
+    if (!stream.tasks.push(task)) {
+        waits_.fetch_add(1, std::memory_order_relaxed);
+        do {
+            if (!running_.load(std::memory_order_relaxed)) {
+                return false;
+            }
+            std::this_thread::yield();
+        } while (!stream.tasks.push(task));
+    }
+
+    if (!stream.scheduled.exchange(true, std::memory_order_seq_cst)) {
+        schedule(stream, nullptr);
+    }
+    return true;
+}
+
+void ForwardingExecutor::schedule(StreamQueue& stream, Worker* current) {
+    StreamQueue* item = &stream;
+
+    if (stream.pinned_worker >= 0) {
+        Worker& owner = *workers_[stream.pinned_worker];
+        while (!owner.pinned->push(item)) {
+            std::this_thread::yield();      // Sized for all streams, not expected
+        }
+        if (&owner != current) {
+            wake(owner);
+        }
+        return;
+    }
+
+    if (current) {
+        current->local->push(item);
+    } else {
+        while (!injection_->queue.push(item)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // One sleeping worker is enough to pick it up or steal it
+    for (auto& worker : workers_) {
+        if (worker.get() != current && !worker->busy_poll && worker->parked.load(std::memory_order_seq_cst)) {
+            wake(*worker);
+            break;
+        }
+    }
+}
+
+ForwardingExecutor::StreamQueue* ForwardingExecutor::findWork(Worker& worker) {
+    StreamQueue* stream = nullptr;
+    if (worker.pinned->pop(stream)) {
+        return stream;
+    }
+    if (worker.busy_poll) {
+        return nullptr;
+    }
+
+    // Local streams could otherwise keep a saturated pool from starting new ones
+    if (++worker.runs % kInjectionInterval == 0 && injection_->queue.pop(stream)) {
+        return stream;
+    }
+    if ((stream = worker.local->take())) {
+        return stream;
+    }
+    if (injection_->queue.pop(stream)) {
+        return stream;
+    }
+
+    for (size_t i = 1; i < workers_.size(); ++i) {
+        Worker& victim = *workers_[(worker.index + i) % workers_.size()];
+        if ((stream = victim.local->take())) {
+            bump(worker.steals);
+            return stream;
+        }
+    }
+    return nullptr;
+}
+
+bool ForwardingExecutor::hasWork(const Worker& worker) const {
+    if (!worker.pinned->empty()) {
+        return true;
+    }
+    if (worker.busy_poll) {
+        return false;
+    }
+    if (!injection_->queue.empty()) {
+        return true;
+    }
+    for (const auto& other : workers_) {
+        if (!other->local->empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ForwardingExecutor::runStream(Worker& worker, StreamQueue& stream) {
+    ForwardTask task;
+    size_t done = 0;
+    while (done < kStreamBudget && !discard_.load(std::memory_order_relaxed) && stream.tasks.pop(task)) {
+        uint64_t delay = static_cast<uint64_t>(std::max<int64_t>(steadyNowNs() - task.enqueue_ns, 0));
+        recordMax(worker.max_delay_ns, delay);
+        bump(worker.delays[delayBucket(delay)]);
+        handler_(task);
+        task.payload.reset();
+        done++;
+    }
+    bump(worker.forwarded, done);
+
+    // Budget used up: keep ownership, but let other streams run first
+    if (done == kStreamBudget) {
+        schedule(stream, &worker);
+        return;
+    }
+
+    // Release ownership. A post racing with the release either is seen here
+    // or finds the flag cleared and schedules the stream itself.
+    stream.scheduled.store(false, std::memory_order_seq_cst);
+    if (!stream.tasks.empty() && !stream.scheduled.exchange(true, std::memory_order_seq_cst)) {
+        schedule(stream, &worker);
+    }
+}
+
+void ForwardingExecutor::idle(Worker& worker) {
+    int64_t spin_start = steadyNowNs();
+
+    // Busy-poll workers spin for the whole idle period, their streams cannot wait for a wakeup
+    if (worker.busy_poll) {
+        int64_t now = spin_start;
+        while (now - spin_start < busy_poll_ns_ && running_.load(std::memory_order_relaxed)) {
+            if (!worker.pinned->empty()) {
+                bump(worker.spin_time_ns, now - spin_start);
+                return;
+            }
+            cpuRelax();
+            now = steadyNowNs();
+        }
+        bump(worker.spin_time_ns, now - spin_start);
+        park(worker);
+        return;
+    }
+
+    // Spin first, for as long as spinning recently paid off
+    int64_t now = spin_start;
+    while (now - spin_start < worker.spin_ns && running_.load(std::memory_order_relaxed)) {
+        if (hasWork(worker)) {
+            bump(worker.spin_time_ns, now - spin_start);
+            worker.spin_ns = std::min(max_spin_ns_, worker.spin_ns * 2);
+            worker.current_spin_ns.store(worker.spin_ns, std::memory_order_relaxed);
+            return;
+        }
+        cpuRelax();
+        now = steadyNowNs();
+    }
+    bump(worker.spin_time_ns, now - spin_start);
+
+    // Woken soon after parking: a longer spin would have caught that work
+    if (park(worker) < max_spin_ns_) {
+        worker.spin_ns = std::min(max_spin_ns_, std::max(worker.spin_ns * 2, kMinSpinNs));
+    } else {
+        worker.spin_ns /= 2;
+    }
+    worker.current_spin_ns.store(worker.spin_ns, std::memory_order_relaxed);
+}
+
+int64_t ForwardingExecutor::park(Worker& worker) {
+    int64_t parked_at = steadyNowNs();
+    {
+        std::unique_lock<std::mutex> lock(worker.mutex);
+        worker.parked.store(true, std::memory_order_seq_cst);
+        if (running_ && !hasWork(worker)) {
+            worker.cv.wait_for(lock, kIdleWait);
+        }
+        worker.parked.store(false, std::memory_order_relaxed);
+    }
+
+    int64_t parked_ns = steadyNowNs() - parked_at;
+    bump(worker.parks);
+    bump(worker.park_time_ns, parked_ns);
+    return parked_ns;
+}
+
+void ForwardingExecutor::wake(Worker& worker) {
+    if (worker.parked.load(std::memory_order_seq_cst)) {
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        worker.cv.notify_one();
+    }
+}
+
+void ForwardingExecutor::run(Worker& worker) {
+    std::string name = "forward-" + std::to_string(worker.index);
+    applyThreadPlacement(worker.placement, name);
+    ThreadRegistration registration(name);
+
+    for (;;) {
+        if (discard_) {
+            break;
+        }
+        StreamQueue* stream = findWork(worker);
+        if (stream) {
+            runStream(worker, *stream);
+            continue;
+        }
+
+        // Queued tasks are forwarded before stopping
+        if (!running_) {
+            break;
+        }
+        idle(worker);
+    }
+}
+
+ForwardingExecutorStats ForwardingExecutor::getStats() const {
+    ForwardingExecutorStats stats;
+    for (const auto& worker : workers_) {
+        ForwardingWorkerStats worker_stats;
+        worker_stats.busy_poll = worker->busy_poll;
+        worker_stats.forwarded = worker->forwarded.load(std::memory_order_relaxed);
+        worker_stats.steals = worker->steals.load(std::memory_order_relaxed);
+        worker_stats.parks = worker->parks.load(std::memory_order_relaxed);
+        worker_stats.max_delay_ns = worker->max_delay_ns.load(std::memory_order_relaxed);
+        worker_stats.spin_ns = worker->current_spin_ns.load(std::memory_order_relaxed);
+        worker_stats.spin_time_ns = worker->spin_time_ns.load(std::memory_order_relaxed);
+        worker_stats.park_time_ns = worker->park_time_ns.load(std::memory_order_relaxed);
+
+        std::array<uint64_t, kDelayBuckets> delays;
+        uint64_t total = 0;
+        for (size_t i = 0; i < kDelayBuckets; ++i) {
+            delays[i] = worker->delays[i].load(std::memory_order_relaxed);
+            total += delays[i];
+        }
+        uint64_t rank = total - total / 1000;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kDelayBuckets && total > 0; ++i) {
+            seen += delays[i];
+            if (seen >= rank) {
+                worker_stats.p999_delay_ns = std::min(delayBucketLimit(i), worker_stats.max_delay_ns);
+                break;
+            }
+        }
+        stats.workers.push_back(worker_stats);
+    }
+    stats.waits = waits_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace data_bridge
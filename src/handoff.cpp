@@ -0,0 +1,521 @@
+#include "handoff.h"
+#include "thread_placement.h"
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace data_bridge {
+
+namespace {
+
+enum FrameType : uint8_t {
+    kSocketsFrame = 1,    // name, count; descriptors attached
+    kStreamFrame = 2,     // One HandoffStream
+    kOfferedFrame = 3,    // End of the offer
+    kReadyFrame = 4,      // Successor subscribed, predecessor may release
+    kDoneFrame = 5        // Predecessor drained
+};
+
+constexpr size_t kHeaderSize = 5;
+constexpr size_t kMaxFrame = 256u << 20;
+constexpr size_t kMaxFdsPerFrame = 64;
+
+// One frame of the offer, or a write, taking longer than this fails the handover
+constexpr int kIoTimeoutMs = 5000;
+
+// How long a successor may take from the offer to subscribing (opening its Zenoh session included)
+constexpr int64_t kReadyTimeoutMs = 60000;
+
+// Poll timeout, bounds how long stop() waits for the handoff thread
+constexpr int kPollMs = 100;
+
+int64_t steadyNowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+class FrameWriter {
+public:
+    void put(uint64_t value, size_t bytes) {
+        for (size_t i = 0; i < bytes; ++i) {
+            body_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+    }
+
+    void put(const uint8_t* data, size_t len) {
+        put(len, 4);
+        body_.insert(body_.end(), data, data + len);
+    }
+
+    void put(const std::string& text) {
+        put(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+    }
+
+    const std::vector<uint8_t>& body() const { return body_; }
+
+private:
+    std::vector<uint8_t> body_;
+};
+
+class FrameReader {
+public:
+    explicit FrameReader(const std::vector<uint8_t>& body)
+        : data_(body.data()), size_(body.size()) {
+    }
+
+    bool get(uint64_t& value, size_t bytes) {
+        if (size_ - pos_ < bytes) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = bytes; i-- > 0;) {
+            value = (value << 8) | data_[pos_ + i];
+        }
+        pos_ += bytes;
+        return true;
+    }
+
+    bool get(std::vector<uint8_t>& out) {
+        uint64_t len;
+        if (!get(len, 4) || size_ - pos_ < len) {
+            return false;
+        }
+        out.assign(data_ + pos_, data_ + pos_ + len);
+        pos_ += len;
+        return true;
+    }
+
+    bool get(std::string& out) {
+        uint64_t len;
+        if (!get(len, 4) || size_ - pos_ < len) {
+            return false;
+        }
+        out.assign(reinterpret_cast<const char*>(data_ + pos_), len);
+        pos_ += len;
+        return true;
+    }
+
+private:
+    const uint8_t* data_;
+    size_t size_;
+    size_t pos_ = 0;
+};
+
+bool sendFrame(int fd, FrameType type, const std::vector<uint8_t>& body, const std::vector<int>& fds = {}) {
+    std::vector<uint8_t> frame(kHeaderSize + body.size());
+    frame[0] = type;
+    for (size_t i = 0; i < 4; ++i) {
+        frame[1 + i] = static_cast<uint8_t>(body.size() >> (8 * i));
+    }
+    std::copy(body.begin(), body.end(), frame.begin() + kHeaderSize);
+
+    // Descriptors travel with the first byte of the frame
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxFdsPerFrame)];
+    size_t sent = 0;
+    while (sent < frame.size()) {
+        iovec iov{frame.data() + sent, frame.size() - sent};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        if (sent == 0 && !fds.empty()) {
+            std::memset(control, 0, sizeof(control));
+            msg.msg_control = control;
+            msg.msg_controllen = CMSG_SPACE(sizeof(int) * fds.size());
+            cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+            cmsg->cmsg_level = SOL_SOCKET;
+            cmsg->cmsg_type = SCM_RIGHTS;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(int) * fds.size());
+            std::memcpy(CMSG_DATA(cmsg), fds.data(), sizeof(int) * fds.size());
+        }
+        ssize_t result = sendmsg(fd, &msg, MSG_NOSIGNAL);
+        if (result < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return false;
+        }
+        sent += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+// Read exactly len bytes, descriptors that come along are appended to fds
+bool readExact(int fd, uint8_t* out, size_t len, int64_t deadline_ms, std::vector<int>& fds) {
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * kMaxFdsPerFrame)];
+    size_t done = 0;
+    while (done < len) {
+        int64_t remaining = deadline_ms - steadyNowMs();
+        pollfd pfd{fd, POLLIN, 0};
+        int ready = remaining > 0 ? poll(&pfd, 1, static_cast<int>(remaining)) : 0;
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            if (ready == 0) {
+                errno = ETIMEDOUT;
+            }
+            return false;
+        }
+
+        iovec iov{out + done, len - done};
+        msghdr msg{};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+        ssize_t result = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            if (result == 0) {
+                errno = ECONNRESET;
+            }
+            return false;
+        }
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+                size_t count = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int);
+                for (size_t i = 0; i < count; ++i) {
+                    int received;
+                    std::memcpy(&received, CMSG_DATA(cmsg) + i * sizeof(int), sizeof(int));
+                    fds.push_back(received);
+                }
+            }
+        }
+        if (msg.msg_flags & MSG_CTRUNC) {
+            errno = EMSGSIZE;
+            return false;
+        }
+        done += static_cast<size_t>(result);
+    }
+    return true;
+}
+
+bool readFrame(int fd, uint8_t& type, std::vector<uint8_t>& body, std::vector<int>& fds, int timeout_ms) {
+    int64_t deadline = steadyNowMs() + timeout_ms;
+    uint8_t header[kHeaderSize];
+    if (!readExact(fd, header, kHeaderSize, deadline, fds)) {
+        return false;
+    }
+    size_t len = 0;
+    for (size_t i = 4; i-- > 0;) {
+        len = (len << 8) | header[1 + i];
+    }
+    if (len > kMaxFrame) {
+        errno = EMSGSIZE;
+        return false;
+    }
+    type = header[0];
+    body.resize(len);
+    return len == 0 || readExact(fd, body.data(), len, deadline, fds);
+}
+
+void closeAll(std::vector<int>& fds) {
+    for (int fd : fds) {
+        close(fd);
+    }
+    fds.clear();
+}
+
+bool unixAddress(const std::string& path, sockaddr_un& addr) {
+    addr = sockaddr_un{};
+    addr.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+        return false;
+    }
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+} // namespace
+
+Handoff::Handoff(const std::string& path)
+    : path_(path) {
+}
+
+Handoff::~Handoff() {
+    stop();
+    for (auto& entry : sockets_) {
+        closeAll(entry.second);
+    }
+}
+
+bool Handoff::receive() {
+    sockaddr_un addr;
+    if (!unixAddress(path_, addr)) {
+        std::cerr << "[Handoff] Invalid socket path: " << path_ << std::endl;
+        return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "[Handoff] Failed to create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+    if (connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+        // Nothing listening is the normal case, there is no bridge to replace
+        bool absent = errno == ENOENT || errno == ECONNREFUSED;
+        if (!absent) {
+            std::cerr << "[Handoff] Failed to connect to " << path_ << ": " << strerror(errno) << std::endl;
+        }
+        close(fd);
+        return absent;
+    }
+
+    std::vector<int> fds;
+    size_t socket_count = 0;
+    size_t sample_count = 0;
+    bool offered = false;
+    while (!offered) {
+        uint8_t type = 0;
+        std::vector<uint8_t> body;
+        if (!readFrame(fd, type, body, fds, kIoTimeoutMs)) {
+            std::cerr << "[Handoff] Failed to receive the offer: " << strerror(errno) << std::endl;
+            break;
+        }
+        FrameReader reader(body);
+        if (type == kSocketsFrame) {
+            std::string name;
+            uint64_t count;
+            if (!reader.get(name) || !reader.get(count, 4) || count > fds.size()) {
+                std::cerr << "[Handoff] Malformed sockets frame" << std::endl;
+                break;
+            }
+            auto& taken = sockets_[name];
+            taken.insert(taken.end(), fds.begin(), fds.begin() + count);
+            fds.erase(fds.begin(), fds.begin() + count);
+            socket_count += count;
+        } else if (type == kStreamFrame) {
+            HandoffStream stream;
+            uint64_t consumer_ns;
+            uint64_t count;
+            bool ok = reader.get(stream.topic) && reader.get(consumer_ns, 8) && reader.get(count, 4);
+            for (uint64_t i = 0; ok && i < count; ++i) {
+                CachedSample sample;
+                ok = reader.get(sample.key) && reader.get(sample.encoding) &&
+                     reader.get(sample.receive_ns, 8) && reader.get(sample.payload);
+                stream.samples.push_back(std::move(sample));
+            }
+            if (!ok) {
+                std::cerr << "[Handoff] Malformed stream frame" << std::endl;
+                break;
+            }
+            stream.consumer_ns = static_cast<int64_t>(consumer_ns);
+            sample_count += stream.samples.size();
+            streams_.push_back(std::move(stream));
+        } else if (type == kOfferedFrame) {
+            offered = true;
+        } else {
+            std::cerr << "[Handoff] Unexpected frame " << static_cast<int>(type) << std::endl;
+            break;
+        }
+    }
+    closeAll(fds);
+
+    if (!offered) {
+        for (auto& entry : sockets_) {
+            closeAll(entry.second);
+        }
+        sockets_.clear();
+        streams_.clear();
+        close(fd);
+        return false;
+    }
+
+    connection_ = fd;
+    took_over_ = true;
+    std::cout << "[Handoff] Taking over from the running bridge: " << socket_count << " socket(s), "
+              << sample_count << " cached sample(s)" << std::endl;
+    return true;
+}
+
+std::vector<int> Handoff::takeSockets(const std::string& name) {
+    auto it = sockets_.find(name);
+    if (it == sockets_.end()) {
+        return {};
+    }
+    std::vector<int> fds = std::move(it->second);
+    sockets_.erase(it);
+    return fds;
+}
+
+bool Handoff::complete(int timeout_ms) {
+    // Sockets of destinations and endpoints this bridge no longer has
+    for (auto& entry : sockets_) {
+        closeAll(entry.second);
+    }
+    sockets_.clear();
+    streams_.clear();
+    if (connection_ < 0) {
+        return false;
+    }
+
+    bool done = false;
+    if (sendFrame(connection_, kReadyFrame, {})) {
+        uint8_t type = 0;
+        std::vector<uint8_t> body;
+        std::vector<int> fds;
+        done = readFrame(connection_, type, body, fds, timeout_ms) && type == kDoneFrame;
+        closeAll(fds);
+    }
+    closeConnection();
+
+    if (done) {
+        std::cout << "[Handoff] Previous bridge drained and stopped" << std::endl;
+    } else {
+        std::cerr << "[Handoff] Previous bridge did not confirm its drain, it may still be forwarding" << std::endl;
+    }
+    return done;
+}
+
+bool Handoff::listen(OfferFunction offer, ReleaseFunction release) {
+    if (running_) {
+        return false;
+    }
+    sockaddr_un addr;
+    if (!unixAddress(path_, addr)) {
+        std::cerr << "[Handoff] Invalid socket path: " << path_ << std::endl;
+        return false;
+    }
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        std::cerr << "[Handoff] Failed to create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // The file of the bridge this one replaced, or of one that exited
+    unlink(path_.c_str());
+    if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(fd, 1) < 0) {
+        std::cerr << "[Handoff] Failed to listen on " << path_ << ": " << strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    listen_fd_ = fd;
+    offer_ = std::move(offer);
+    release_ = std::move(release);
+    running_ = true;
+    listen_thread_ = std::thread(&Handoff::listenLoop, this);
+
+    std::cout << "[Handoff] A restarted bridge can take over through " << path_ << std::endl;
+    return true;
+}
+
+void Handoff::stop() {
+    if (running_.exchange(false) && listen_thread_.joinable()) {
+        listen_thread_.join();
+    }
+    if (listen_fd_ >= 0) {
+        close(listen_fd_);
+        listen_fd_ = -1;
+        // After a handover the file is the successor's
+        if (!handed_over_) {
+            unlink(path_.c_str());
+        }
+    }
+    closeConnection();
+}
+
+void Handoff::listenLoop() {
+    ThreadRegistration registration("handoff");
+    pollfd pfd{listen_fd_, POLLIN, 0};
+
+    while (running_) {
+        if (poll(&pfd, 1, kPollMs) <= 0) {
+            continue;
+        }
+        int connection = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0) {
+            continue;
+        }
+        // A successor that stops reading must not block stop()
+        timeval timeout{kIoTimeoutMs / 1000, 0};
+        setsockopt(connection, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+        bool done = serve(connection);
+        close(connection);
+        if (done) {
+            break;
+        }
+    }
+}
+
+bool Handoff::serve(int connection) {
+    std::cout << "[Handoff] Successor connected, passing sockets and caches" << std::endl;
+    HandoffOffer offer = offer_();
+
+    bool ok = true;
+    for (const auto& entry : offer.sockets) {
+        for (size_t first = 0; ok && first < entry.second.size(); first += kMaxFdsPerFrame) {
+            std::vector<int> fds(entry.second.begin() + first,
+                                 entry.second.begin() + std::min(first + kMaxFdsPerFrame, entry.second.size()));
+            FrameWriter writer;
+            writer.put(entry.first);
+            writer.put(fds.size(), 4);
+            ok = sendFrame(connection, kSocketsFrame, writer.body(), fds);
+        }
+    }
+    for (size_t i = 0; ok && i < offer.streams.size(); ++i) {
+        const auto& stream = offer.streams[i];
+        FrameWriter writer;
+        writer.put(stream.topic);
+        writer.put(static_cast<uint64_t>(stream.consumer_ns), 8);
+        writer.put(stream.samples.size(), 4);
+        for (const auto& sample : stream.samples) {
+            writer.put(sample.key);
+            writer.put(sample.encoding);
+            writer.put(sample.receive_ns, 8);
+            writer.put(sample.payload.data(), sample.payload.size());
+        }
+        ok = sendFrame(connection, kStreamFrame, writer.body());
+    }
+    if (!ok || !sendFrame(connection, kOfferedFrame, {})) {
+        std::cerr << "[Handoff] Failed to send the offer: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // The successor subscribes with the shared sockets, this bridge keeps forwarding meanwhile
+    int64_t deadline = steadyNowMs() + kReadyTimeoutMs;
+    pollfd pfd{connection, POLLIN, 0};
+    while (true) {
+        if (!running_ || steadyNowMs() >= deadline) {
+            std::cerr << "[Handoff] Successor did not become ready, still serving" << std::endl;
+            return false;
+        }
+        if (poll(&pfd, 1, kPollMs) <= 0) {
+            continue;
+        }
+        uint8_t type = 0;
+        std::vector<uint8_t> body;
+        std::vector<int> fds;
+        bool received = readFrame(connection, type, body, fds, kIoTimeoutMs);
+        closeAll(fds);
+        if (!received) {
+            std::cerr << "[Handoff] Successor went away, still serving" << std::endl;
+            return false;
+        }
+        if (type == kReadyFrame) {
+            break;
+        }
+    }
+
+    std::cout << "[Handoff] Successor is forwarding, draining" << std::endl;
+    release_();
+    handed_over_ = true;
+    if (!sendFrame(connection, kDoneFrame, {})) {
+        std::cerr << "[Handoff] Failed to confirm the drain: " << strerror(errno) << std::endl;
+    }
+    return true;
+}
+
+void Handoff::closeConnection() {
+    if (connection_ >= 0) {
+        close(connection_);
+        connection_ = -1;
+    }
+}
+
+} // namespace data_bridge
@@ -0,0 +1,536 @@
+#include "hash.h"
+#include <array>
+#include <cstring>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#include <arm_acle.h>
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace data_bridge {
+
+namespace {
+
+constexpr uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+// Little-endian loads, the bridge only builds for little-endian hosts (see schema.h)
+inline uint64_t read64(const uint8_t* p) {
+    uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint64_t xxh64Round(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t xxh64Avalanche(uint64_t h) {
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+inline uint64_t mergeRound(uint64_t acc, uint64_t val) {
+    acc ^= xxh64Round(0, val);
+    return acc * kPrime1 + kPrime4;
+}
+
+// --- CRC32C ---
+
+constexpr uint32_t kCrc32cPolynomial = 0x82F63B78;    // Reflected 0x1EDC6F41
+
+using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>;
+
+// Slicing-by-8: table k advances a byte that is followed by k more
+constexpr Crc32cTables makeCrc32cTables() {
+    Crc32cTables tables{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc >> 1) ^ ((crc & 1) ? kCrc32cPolynomial : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (size_t k = 1; k < 8; ++k) {
+        for (size_t i = 0; i < 256; ++i) {
+            uint32_t prev = tables[k - 1][i];
+            tables[k][i] = (prev >> 8) ^ tables[0][prev & 0xFF];
+        }
+    }
+    return tables;
+}
+
+constexpr Crc32cTables kCrc32cTables = makeCrc32cTables();
+
+uint32_t crc32cSoftware(const uint8_t* p, size_t len) {
+    const auto& t = kCrc32cTables;
+    uint32_t crc = 0xFFFFFFFF;
+    for (; len >= 8; p += 8, len -= 8) {
+        uint64_t v = read64(p) ^ crc;
+        crc = t[7][v & 0xFF] ^ t[6][(v >> 8) & 0xFF] ^ t[5][(v >> 16) & 0xFF] ^ t[4][(v >> 24) & 0xFF] ^
+              t[3][(v >> 32) & 0xFF] ^ t[2][(v >> 40) & 0xFF] ^ t[1][(v >> 48) & 0xFF] ^ t[0][v >> 56];
+    }
+    for (; len > 0; ++p, --len) {
+        crc = t[0][(crc ^ *p) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+uint32_t crc32cSse42(const uint8_t* p, size_t len) {
+    uint64_t crc = 0xFFFFFFFF;
+    for (; len >= 8; p += 8, len -= 8) {
+        crc = _mm_crc32_u64(crc, read64(p));
+    }
+    uint32_t crc32 = static_cast<uint32_t>(crc);
+    for (; len > 0; ++p, --len) {
+        crc32 = _mm_crc32_u8(crc32, *p);
+    }
+    return ~crc32;
+}
+#elif defined(__aarch64__)
+__attribute__((target("+crc")))
+uint32_t crc32cArmv8(const uint8_t* p, size_t len) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (; len >= 8; p += 8, len -= 8) {
+        crc = __crc32cd(crc, read64(p));
+    }
+    for (; len > 0; ++p, --len) {
+        crc = __crc32cb(crc, *p);
+    }
+    return ~crc;
+}
+#endif
+
+using Crc32cFunction = uint32_t (*)(const uint8_t*, size_t);
+
+struct Crc32cImpl {
+    Crc32cFunction function;
+    const char* name;
+};
+
+Crc32cImpl selectCrc32c() {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("sse4.2")) {
+        return {crc32cSse42, "sse4.2"};
+    }
+#elif defined(__aarch64__)
+    if (getauxval(AT_HWCAP) & HWCAP_CRC32) {
+        return {crc32cArmv8, "armv8-crc"};
+    }
+#endif
+    return {crc32cSoftware, "portable"};
+}
+
+const Crc32cImpl& crc32cImpl() {
+    static const Crc32cImpl impl = selectCrc32c();
+    return impl;
+}
+
+// --- XXH3 ---
+
+constexpr uint32_t kPrime32_1 = 0x9E3779B1;
+constexpr uint32_t kPrime32_2 = 0x85EBCA77;
+constexpr uint32_t kPrime32_3 = 0xC2B2AE3D;
+constexpr uint64_t kPrimeMx1 = 0x165667919E3779F9ULL;
+constexpr uint64_t kPrimeMx2 = 0x9FB21C651E98DF25ULL;
+
+constexpr size_t kSecretSize = 192;
+constexpr size_t kSecretSizeMin = 136;
+constexpr size_t kStripeLen = 64;
+constexpr size_t kSecretConsumeRate = 8;
+constexpr size_t kStripesPerBlock = (kSecretSize - kStripeLen) / kSecretConsumeRate;
+constexpr size_t kBlockLen = kStripeLen * kStripesPerBlock;
+constexpr size_t kMidSizeMax = 240;
+
+alignas(64) constexpr uint8_t kSecret[kSecretSize] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+};
+
+inline uint64_t mul128Fold64(uint64_t a, uint64_t b) {
+    __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+}
+
+inline uint64_t xxh3Avalanche(uint64_t h) {
+    h ^= h >> 37;
+    h *= kPrimeMx1;
+    return h ^ (h >> 32);
+}
+
+inline uint64_t rrmxmx(uint64_t h, uint64_t len) {
+    h ^= rotl(h, 49) ^ rotl(h, 24);
+    h *= kPrimeMx2;
+    h ^= (h >> 35) + len;
+    h *= kPrimeMx2;
+    return h ^ (h >> 28);
+}
+
+inline uint64_t mix16(const uint8_t* input, const uint8_t* secret) {
+    return mul128Fold64(read64(input) ^ read64(secret), read64(input + 8) ^ read64(secret + 8));
+}
+
+uint64_t xxh3Short(const uint8_t* p, size_t len) {
+    if (len > 8) {
+        uint64_t lo = read64(p) ^ (read64(kSecret + 24) ^ read64(kSecret + 32));
+        uint64_t hi = read64(p + len - 8) ^ (read64(kSecret + 40) ^ read64(kSecret + 48));
+        return xxh3Avalanche(len + __builtin_bswap64(lo) + hi + mul128Fold64(lo, hi));
+    }
+    if (len >= 4) {
+        uint64_t input = read32(p + len - 4) + (static_cast<uint64_t>(read32(p)) << 32);
+        return rrmxmx(input ^ (read64(kSecret + 8) ^ read64(kSecret + 16)), len);
+    }
+    if (len > 0) {
+        uint32_t combined = (static_cast<uint32_t>(p[0]) << 16) | (static_cast<uint32_t>(p[len >> 1]) << 24) |
+                            p[len - 1] | (static_cast<uint32_t>(len) << 8);
+        return xxh64Avalanche(combined ^ static_cast<uint64_t>(read32(kSecret) ^ read32(kSecret + 4)));
+    }
+    return xxh64Avalanche(read64(kSecret + 56) ^ read64(kSecret + 64));
+}
+
+uint64_t xxh3Medium(const uint8_t* p, size_t len) {
+    uint64_t acc = len * kPrime1;
+    if (len <= 128) {
+        if (len > 32) {
+            if (len > 64) {
+                if (len > 96) {
+                    acc += mix16(p + 48, kSecret + 96);
+                    acc += mix16(p + len - 64, kSecret + 112);
+                }
+                acc += mix16(p + 32, kSecret + 64);
+                acc += mix16(p + len - 48, kSecret + 80);
+            }
+            acc += mix16(p + 16, kSecret + 32);
+            acc += mix16(p + len - 32, kSecret + 48);
+        }
+        acc += mix16(p, kSecret);
+        acc += mix16(p + len - 16, kSecret + 16);
+        return xxh3Avalanche(acc);
+    }
+
+    for (size_t i = 0; i < 8; ++i) {
+        acc += mix16(p + 16 * i, kSecret + 16 * i);
+    }
+    acc = xxh3Avalanche(acc);
+    uint64_t acc_end = mix16(p + len - 16, kSecret + kSecretSizeMin - 17);
+    for (size_t i = 8; i < len / 16; ++i) {
+        acc_end += mix16(p + 16 * i, kSecret + 16 * (i - 8) + 3);
+    }
+    return xxh3Avalanche(acc + acc_end);
+}
+
+// Inputs above 240 bytes: eight 64-bit lanes over 64-byte stripes, scrambled every kBlockLen bytes.
+// Kernel::State holds the lanes in registers for the whole loop, Kernel::store writes them out once;
+// accessing a uint64_t array through vector pointers is miscompiled by GCC at -O2 with strict aliasing.
+alignas(32) constexpr uint64_t kAccInit[8] = {kPrime32_3, kPrime1, kPrime2, kPrime3,
+                                               kPrime4, kPrime32_2, kPrime5, kPrime32_1};
+
+template <class Kernel>
+__attribute__((always_inline)) inline uint64_t xxh3Long(const uint8_t* p, size_t len) {
+    typename Kernel::State state = Kernel::init();
+
+    size_t blocks = (len - 1) / kBlockLen;
+    for (size_t n = 0; n < blocks; ++n) {
+        const uint8_t* block = p + n * kBlockLen;
+        for (size_t s = 0; s < kStripesPerBlock; ++s) {
+            Kernel::accumulate(state, block + s * kStripeLen, kSecret + s * kSecretConsumeRate);
+        }
+        Kernel::scramble(state, kSecret + kSecretSize - kStripeLen);
+    }
+
+    const uint8_t* tail = p + blocks * kBlockLen;
+    size_t stripes = ((len - 1) - blocks * kBlockLen) / kStripeLen;
+    for (size_t s = 0; s < stripes; ++s) {
+        Kernel::accumulate(state, tail + s * kStripeLen, kSecret + s * kSecretConsumeRate);
+    }
+    Kernel::accumulate(state, p + len - kStripeLen, kSecret + kSecretSize - kStripeLen - 7);
+
+    alignas(32) uint64_t acc[8];
+    Kernel::store(state, acc);
+
+    uint64_t result = len * kPrime1;
+    for (size_t i = 0; i < 4; ++i) {
+        result += mul128Fold64(acc[2 * i] ^ read64(kSecret + 11 + 16 * i),
+                               acc[2 * i + 1] ^ read64(kSecret + 11 + 16 * i + 8));
+    }
+    return xxh3Avalanche(result);
+}
+
+struct ScalarKernel {
+    struct State {
+        uint64_t lanes[8];
+    };
+
+    static inline State init() {
+        State state;
+        std::memcpy(state.lanes, kAccInit, sizeof(state.lanes));
+        return state;
+    }
+
+    static inline void accumulate(State& state, const uint8_t* input, const uint8_t* secret) {
+        for (size_t lane = 0; lane < 8; ++lane) {
+            uint64_t value = read64(input + lane * 8);
+            uint64_t key = value ^ read64(secret + lane * 8);
+            state.lanes[lane ^ 1] += value;
+            state.lanes[lane] += (key & 0xFFFFFFFF) * (key >> 32);
+        }
+    }
+
+    static inline void scramble(State& state, const uint8_t* secret) {
+        for (size_t lane = 0; lane < 8; ++lane) {
+            uint64_t value = state.lanes[lane];
+            value ^= value >> 47;
+            value ^= read64(secret + lane * 8);
+            state.lanes[lane] = value * kPrime32_1;
+        }
+    }
+
+    static inline void store(const State& state, uint64_t* acc) {
+        std::memcpy(acc, state.lanes, sizeof(state.lanes));
+    }
+};
+
+uint64_t xxh3LongScalar(const uint8_t* p, size_t len) {
+    return xxh3Long<ScalarKernel>(p, len);
+}
+
+#if defined(__x86_64__)
+// SSE2 is part of x86-64, no runtime check needed
+struct Sse2Kernel {
+    struct State {
+        __m128i lanes[4];
+    };
+
+    static inline State init() {
+        State state;
+        for (size_t i = 0; i < 4; ++i) {
+            state.lanes[i] = _mm_load_si128(reinterpret_cast<const __m128i*>(kAccInit) + i);
+        }
+        return state;
+    }
+
+    static inline void accumulate(State& state, const uint8_t* input, const uint8_t* secret) {
+        for (size_t i = 0; i < 4; ++i) {
+            __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input) + i);
+            __m128i key = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+            __m128i product = _mm_mul_epu32(key, _mm_shuffle_epi32(key, _MM_SHUFFLE(0, 3, 0, 1)));
+            __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            state.lanes[i] = _mm_add_epi64(product, _mm_add_epi64(state.lanes[i], swapped));
+        }
+    }
+
+    static inline void scramble(State& state, const uint8_t* secret) {
+        const __m128i prime = _mm_set1_epi32(static_cast<int>(kPrime32_1));
+        for (size_t i = 0; i < 4; ++i) {
+            __m128i value = _mm_xor_si128(state.lanes[i], _mm_srli_epi64(state.lanes[i], 47));
+            value = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret) + i));
+            __m128i lo = _mm_mul_epu32(value, prime);
+            __m128i hi = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+            state.lanes[i] = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+        }
+    }
+
+    static inline void store(const State& state, uint64_t* acc) {
+        for (size_t i = 0; i < 4; ++i) {
+            _mm_store_si128(reinterpret_cast<__m128i*>(acc) + i, state.lanes[i]);
+        }
+    }
+};
+
+uint64_t xxh3LongSse2(const uint8_t* p, size_t len) {
+    return xxh3Long<Sse2Kernel>(p, len);
+}
+
+struct Avx2Kernel {
+    struct State {
+        __m256i lanes[2];
+    };
+
+    __attribute__((target("avx2")))
+    static inline State init() {
+        State state;
+        for (size_t i = 0; i < 2; ++i) {
+            state.lanes[i] = _mm256_load_si256(reinterpret_cast<const __m256i*>(kAccInit) + i);
+        }
+        return state;
+    }
+
+    __attribute__((target("avx2")))
+    static inline void accumulate(State& state, const uint8_t* input, const uint8_t* secret) {
+        for (size_t i = 0; i < 2; ++i) {
+            __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(input) + i);
+            __m256i key = _mm256_xor_si256(data, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i));
+            __m256i product = _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32));
+            __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+            state.lanes[i] = _mm256_add_epi64(product, _mm256_add_epi64(state.lanes[i], swapped));
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static inline void scramble(State& state, const uint8_t* secret) {
+        const __m256i prime = _mm256_set1_epi32(static_cast<int>(kPrime32_1));
+        for (size_t i = 0; i < 2; ++i) {
+            __m256i value = _mm256_xor_si256(state.lanes[i], _mm256_srli_epi64(state.lanes[i], 47));
+            value = _mm256_xor_si256(value, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret) + i));
+            __m256i lo = _mm256_mul_epu32(value, prime);
+            __m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), prime);
+            state.lanes[i] = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+        }
+    }
+
+    __attribute__((target("avx2")))
+    static inline void store(const State& state, uint64_t* acc) {
+        for (size_t i = 0; i < 2; ++i) {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(acc) + i, state.lanes[i]);
+        }
+    }
+};
+
+// flatten inlines the kernel, which needs the caller compiled for AVX2 as well
+__attribute__((target("avx2"), flatten))
+uint64_t xxh3LongAvx2(const uint8_t* p, size_t len) {
+    return xxh3Long<Avx2Kernel>(p, len);
+}
+#endif
+
+using Xxh3Function = uint64_t (*)(const uint8_t*, size_t);
+
+struct Xxh3Impl {
+    Xxh3Function function;
+    const char* name;
+};
+
+Xxh3Impl selectXxh3() {
+#if defined(__x86_64__)
+    if (__builtin_cpu_supports("avx2")) {
+        return {xxh3LongAvx2, "avx2"};
+    }
+    return {xxh3LongSse2, "sse2"};
+#else
+    return {xxh3LongScalar, "portable"};
+#endif
+}
+
+const Xxh3Impl& xxh3Impl() {
+    static const Xxh3Impl impl = selectXxh3();
+    return impl;
+}
+
+inline uint64_t xxh3Dispatch(const uint8_t* p, size_t len, Xxh3Function hash_long) {
+    if (len <= 16) {
+        return xxh3Short(p, len);
+    }
+    if (len <= kMidSizeMax) {
+        return xxh3Medium(p, len);
+    }
+    return hash_long(p, len);
+}
+
+} // namespace
+
+uint64_t xxhash64(const void* data, size_t len, uint64_t seed) {
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    const uint8_t* end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        // Four independent lanes of 8 bytes each
+        uint64_t v1 = seed + kPrime1 + kPrime2;
+        uint64_t v2 = seed + kPrime2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - kPrime1;
+        const uint8_t* limit = end - 32;
+        do {
+            v1 = xxh64Round(v1, read64(p));
+            v2 = xxh64Round(v2, read64(p + 8));
+            v3 = xxh64Round(v3, read64(p + 16));
+            v4 = xxh64Round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    } else {
+        h = seed + kPrime5;
+    }
+    h += static_cast<uint64_t>(len);
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= xxh64Round(0, read64(p));
+        h = rotl(h, 27) * kPrime1 + kPrime4;
+    }
+    if (p + 4 <= end) {
+        h ^= static_cast<uint64_t>(read32(p)) * kPrime1;
+        h = rotl(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= (*p) * kPrime5;
+        h = rotl(h, 11) * kPrime1;
+    }
+
+    return xxh64Avalanche(h);
+}
+
+uint32_t crc32c(const void* data, size_t len) {
+    return crc32cImpl().function(static_cast<const uint8_t*>(data), len);
+}
+
+uint32_t crc32cPortable(const void* data, size_t len) {
+    return crc32cSoftware(static_cast<const uint8_t*>(data), len);
+}
+
+uint64_t xxh3_64(const void* data, size_t len) {
+    return xxh3Dispatch(static_cast<const uint8_t*>(data), len, xxh3Impl().function);
+}
+
+uint64_t xxh3_64Portable(const void* data, size_t len) {
+    return xxh3Dispatch(static_cast<const uint8_t*>(data), len, xxh3LongScalar);
+}
+
+const char* crc32cImplementation() {
+    return crc32cImpl().name;
+}
+
+const char* xxh3Implementation() {
+    return xxh3Impl().name;
+}
+
+} // namespace data_bridge
@@ -0,0 +1,81 @@
+#include "integrity.h"
+#include "hash.h"
+#include <cstring>
+
+namespace data_bridge {
+
+namespace {
+
+// Widened to 64 bits, a trailer holds its low bytes (little-endian host, see schema.h)
+uint64_t checksum(IntegrityCheck check, const uint8_t* data, size_t len) {
+    return check == IntegrityCheck::CRC32C ? crc32c(data, len) : xxh3_64(data, len);
+}
+
+} // namespace
+
+size_t Integrity::trailerSize(IntegrityCheck check) {
+    switch (check) {
+        case IntegrityCheck::CRC32C: return sizeof(uint32_t);
+        case IntegrityCheck::XXH3: return sizeof(uint64_t);
+        default: return 0;
+    }
+}
+
+bool Integrity::writeTrailer(IntegrityCheck check, uint8_t* data, size_t len) {
+    size_t trailer = trailerSize(check);
+    if (trailer == 0) {
+        return true;
+    }
+    if (len < trailer) {
+        return false;
+    }
+    uint64_t sum = checksum(check, data, len - trailer);
+    std::memcpy(data + len - trailer, &sum, trailer);
+    return true;
+}
+
+bool Integrity::verify(IntegrityCheck check, ByteView payload, size_t& body_size) {
+    size_t trailer = trailerSize(check);
+    if (trailer == 0) {
+        body_size = payload.size;
+        return true;
+    }
+    if (payload.size < trailer) {
+        return false;
+    }
+    body_size = payload.size - trailer;
+    uint64_t expected = 0;
+    std::memcpy(&expected, payload.data + body_size, trailer);
+    return checksum(check, payload.data, body_size) == expected;
+}
+
+bool Integrity::parseCheck(const std::string& name, IntegrityCheck& check) {
+    if (name == "none") {
+        check = IntegrityCheck::NONE;
+    } else if (name == "crc32c") {
+        check = IntegrityCheck::CRC32C;
+    } else if (name == "xxh3") {
+        check = IntegrityCheck::XXH3;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* Integrity::checkName(IntegrityCheck check) {
+    switch (check) {
+        case IntegrityCheck::CRC32C: return "crc32c";
+        case IntegrityCheck::XXH3: return "xxh3";
+        default: return "none";
+    }
+}
+
+std::string Integrity::describe(IntegrityCheck check) {
+    switch (check) {
+        case IntegrityCheck::CRC32C: return std::string("crc32c (") + crc32cImplementation() + ")";
+        case IntegrityCheck::XXH3: return std::string("xxh3 (") + xxh3Implementation() + ")";
+        default: return "none";
+    }
+}
+
+} // namespace data_bridge
@@ -0,0 +1,339 @@
+#include "json.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace data_bridge {
+
+namespace {
+
+// Deeper documents are rejected instead of exhausting the stack
+constexpr int kMaxDepth = 64;
+
+void appendUtf8(uint32_t code_point, std::string& out) {
+    if (code_point < 0x80) {
+        out += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        out += static_cast<char>(0xc0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3f));
+    } else if (code_point < 0x10000) {
+        out += static_cast<char>(0xe0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (code_point & 0x3f));
+    } else {
+        out += static_cast<char>(0xf0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3f));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (code_point & 0x3f));
+    }
+}
+
+} // namespace
+
+class JsonValue::Parser {
+public:
+    explicit Parser(const std::string& text) : text_(text) {}
+
+    bool parseDocument(JsonValue& value, std::string& error) {
+        skipWhitespace();
+        if (!parseValue(value, 0)) {
+            error = message();
+            return false;
+        }
+        skipWhitespace();
+        if (pos_ != text_.size()) {
+            fail("unexpected data after the document");
+            error = message();
+            return false;
+        }
+        return true;
+    }
+
+private:
+    bool parseValue(JsonValue& value, int depth) {
+        if (depth > kMaxDepth) {
+            return fail("nested too deeply");
+        }
+        if (pos_ >= text_.size()) {
+            return fail("unexpected end of document");
+        }
+
+        char c = text_[pos_];
+        if (c == '{') {
+            return parseObject(value, depth);
+        }
+        if (c == '[') {
+            return parseArray(value, depth);
+        }
+        if (c == '"') {
+            value.type_ = Type::STRING;
+            return parseString(value.string_);
+        }
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            value.type_ = Type::NUMBER;
+            return parseNumber(value.number_);
+        }
+        if (consumeWord("true")) {
+            value.type_ = Type::BOOL;
+            value.bool_ = true;
+            return true;
+        }
+        if (consumeWord("false")) {
+            value.type_ = Type::BOOL;
+            value.bool_ = false;
+            return true;
+        }
+        if (consumeWord("null")) {
+            value.type_ = Type::NUL;
+            return true;
+        }
+        return fail("unexpected character");
+    }
+
+    bool parseObject(JsonValue& value, int depth) {
+        value.type_ = Type::OBJECT;
+        pos_++;
+        skipWhitespace();
+        if (consume('}')) {
+            return true;
+        }
+
+        for (;;) {
+            skipWhitespace();
+            if (pos_ >= text_.size() || text_[pos_] != '"') {
+                return fail("expected a member name");
+            }
+            std::string key;
+            if (!parseString(key)) {
+                return false;
+            }
+            if (value.find(key)) {
+                return fail("duplicate key '" + key + "'");
+            }
+            skipWhitespace();
+            if (!consume(':')) {
+                return fail("expected ':'");
+            }
+            skipWhitespace();
+            value.keys_.push_back(std::move(key));
+            value.items_.emplace_back();
+            if (!parseValue(value.items_.back(), depth + 1)) {
+                return false;
+            }
+            skipWhitespace();
+            if (consume('}')) {
+                return true;
+            }
+            if (!consume(',')) {
+                return fail("expected ',' or '}'");
+            }
+        }
+    }
+
+    bool parseArray(JsonValue& value, int depth) {
+        value.type_ = Type::ARRAY;
+        pos_++;
+        skipWhitespace();
+        if (consume(']')) {
+            return true;
+        }
+
+        for (;;) {
+            skipWhitespace();
+            value.items_.emplace_back();
+            if (!parseValue(value.items_.back(), depth + 1)) {
+                return false;
+            }
+            skipWhitespace();
+            if (consume(']')) {
+                return true;
+            }
+            if (!consume(',')) {
+                return fail("expected ',' or ']'");
+            }
+        }
+    }
+
+    bool parseString(std::string& out) {
+        pos_++;
+        for (;;) {
+            if (pos_ >= text_.size()) {
+                return fail("unterminated string");
+            }
+            char c = text_[pos_++];
+            if (c == '"') {
+                return true;
+            }
+            if (static_cast<unsigned char>(c) < 0x20) {
+                return fail("control character in string");
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+
+            if (pos_ >= text_.size()) {
+                return fail("unterminated string");
+            }
+            switch (text_[pos_++]) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t code_point;
+                    if (!parseHex4(code_point)) {
+                        return false;
+                    }
+                    // Characters outside the BMP come as a surrogate pair
+                    if (code_point >= 0xd800 && code_point < 0xdc00) {
+                        uint32_t low;
+                        if (!consume('\\') || !consume('u') || !parseHex4(low) || low < 0xdc00 || low >= 0xe000) {
+                            return fail("unpaired surrogate in string");
+                        }
+                        code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+                    } else if (code_point >= 0xdc00 && code_point < 0xe000) {
+                        return fail("unpaired surrogate in string");
+                    }
+                    appendUtf8(code_point, out);
+                    break;
+                }
+                default:
+                    return fail("invalid escape in string");
+            }
+        }
+    }
+
+    bool parseHex4(uint32_t& value) {
+        if (text_.size() - pos_ < 4) {
+            return fail("invalid \\u escape");
+        }
+        value = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = text_[pos_++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') {
+                value |= static_cast<uint32_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                value |= static_cast<uint32_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                value |= static_cast<uint32_t>(c - 'A' + 10);
+            } else {
+                return fail("invalid \\u escape");
+            }
+        }
+        return true;
+    }
+
+    // Validated against the JSON grammar first, strtod accepts more (hex, inf, leading '+')
+    bool parseNumber(double& value) {
+        size_t start = pos_;
+        consume('-');
+        if (consume('0')) {
+            // No leading zeros
+        } else if (!consumeDigits()) {
+            return fail("invalid number");
+        }
+        if (consume('.') && !consumeDigits()) {
+            return fail("invalid number");
+        }
+        if (consume('e') || consume('E')) {
+            if (!consume('+')) {
+                consume('-');
+            }
+            if (!consumeDigits()) {
+                return fail("invalid number");
+            }
+        }
+        std::string number = text_.substr(start, pos_ - start);
+        value = std::strtod(number.c_str(), nullptr);
+        return true;
+    }
+
+    bool consumeDigits() {
+        size_t start = pos_;
+        while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9') {
+            pos_++;
+        }
+        return pos_ > start;
+    }
+
+    bool consumeWord(const char* word) {
+        size_t len = std::strlen(word);
+        if (text_.compare(pos_, len, word) != 0) {
+            return false;
+        }
+        pos_ += len;
+        return true;
+    }
+
+    bool consume(char c) {
+        if (pos_ < text_.size() && text_[pos_] == c) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+
+    void skipWhitespace() {
+        while (pos_ < text_.size() &&
+               (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            pos_++;
+        }
+    }
+
+    bool fail(const std::string& reason) {
+        if (reason_.empty()) {
+            reason_ = reason;
+            error_pos_ = std::min(pos_, text_.size());
+        }
+        return false;
+    }
+
+    std::string message() const {
+        size_t line = 1;
+        for (size_t i = 0; i < error_pos_; ++i) {
+            line += text_[i] == '\n' ? 1 : 0;
+        }
+        return reason_ + " at line " + std::to_string(line);
+    }
+
+private:
+    const std::string& text_;
+    size_t pos_ = 0;
+    std::string reason_;
+    size_t error_pos_ = 0;
+};
+
+bool JsonValue::parse(const std::string& text, JsonValue& value, std::string& error) {
+    value = JsonValue();
+    Parser parser(text);
+    return parser.parseDocument(value, error);
+}
+
+const char* JsonValue::typeName(Type type) {
+    switch (type) {
+        case Type::NUL: return "null";
+        case Type::BOOL: return "boolean";
+        case Type::NUMBER: return "number";
+        case Type::STRING: return "string";
+        case Type::ARRAY: return "array";
+        default: return "object";
+    }
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const {
+    for (size_t i = 0; i < keys_.size(); ++i) {
+        if (keys_[i] == key) {
+            return &items_[i];
+        }
+    }
+    return nullptr;
+}
+
+} // namespace data_bridge
@@ -0,0 +1,100 @@
+#include "last_value_cache.h"
+#include <algorithm>
+#include <cstring>
+
+namespace data_bridge {
+
+namespace {
+
+// Room for key and encoding strings on top of the payload
+constexpr size_t kMetadataReserve = 512;
+
+// Readers give up on a slot that keeps changing, the writer always wins
+constexpr int kMaxReadRetries = 16;
+
+} // namespace
+
+LastValueCache::LastValueCache(size_t depth, size_t max_payload)
+    : depth_(std::max<size_t>(depth, 1)),
+      capacity_(max_payload + kMetadataReserve),
+      slots_(depth_) {
+    for (auto& slot : slots_) {
+        slot.data.reset(new uint8_t[capacity_]);
+    }
+}
+
+bool LastValueCache::store(std::string_view key, std::string_view encoding,
+                           const uint8_t* payload, size_t len, uint64_t receive_ns) {
+    if (key.size() + encoding.size() + len > capacity_) {
+        return false;
+    }
+
+    // Writers are normally serialized by Zenoh, the flag only covers the
+    // brief overlap of two subscribers during a session failover
+    while (write_lock_.test_and_set(std::memory_order_acquire)) {
+    }
+
+    uint64_t head = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[head % depth_];
+
+    uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.receive_ns = receive_ns;
+    slot.key_size = static_cast<uint32_t>(key.size());
+    slot.encoding_size = static_cast<uint32_t>(encoding.size());
+    slot.payload_size = static_cast<uint32_t>(len);
+    std::memcpy(slot.data.get(), key.data(), key.size());
+    std::memcpy(slot.data.get() + key.size(), encoding.data(), encoding.size());
+    std::memcpy(slot.data.get() + key.size() + encoding.size(), payload, len);
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    head_.store(head + 1, std::memory_order_release);
+
+    write_lock_.clear(std::memory_order_release);
+    return true;
+}
+
+std::vector<CachedSample> LastValueCache::snapshot() const {
+    std::vector<CachedSample> samples;
+
+    uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t first = head > depth_ ? head - depth_ : 0;
+    samples.reserve(head - first);
+
+    for (uint64_t i = first; i < head; ++i) {
+        CachedSample sample;
+        if (readSlot(slots_[i % depth_], sample)) {
+            samples.push_back(std::move(sample));
+        }
+    }
+    return samples;
+}
+
+bool LastValueCache::readSlot(const Slot& slot, CachedSample& out) const {
+    for (int attempt = 0; attempt < kMaxReadRetries; ++attempt) {
+        uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+
+        size_t key_size = std::min<size_t>(slot.key_size, capacity_);
+        size_t encoding_size = std::min<size_t>(slot.encoding_size, capacity_ - key_size);
+        size_t payload_size = std::min<size_t>(slot.payload_size, capacity_ - key_size - encoding_size);
+        const uint8_t* data = slot.data.get();
+
+        out.receive_ns = slot.receive_ns;
+        out.key.assign(reinterpret_cast<const char*>(data), key_size);
+        out.encoding.assign(reinterpret_cast<const char*>(data + key_size), encoding_size);
+        out.payload.assign(data + key_size + encoding_size, data + key_size + encoding_size + payload_size);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace data_bridge
@@ -0,0 +1,36 @@
+#include "matching_gate.h"
+
+namespace data_bridge {
+
+MatchingGate::~MatchingGate() {
+    // Undeclared first, so no status update runs on a destroyed gate
+    listener_.reset();
+}
+
+bool MatchingGate::wait(std::chrono::milliseconds timeout) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait_for(lock, timeout, [this]() { return matched() || released_.load(std::memory_order_relaxed); });
+    return matched();
+}
+
+void MatchingGate::release() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released_ = true;
+    }
+    cv_.notify_all();
+}
+
+void MatchingGate::update(bool matching) {
+    bool was_matched;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        was_matched = matched_.exchange(matching, std::memory_order_acq_rel);
+    }
+    if (matching && !was_matched) {
+        matches_.fetch_add(1, std::memory_order_relaxed);
+        cv_.notify_all();
+    }
+}
+
+} // namespace data_bridge
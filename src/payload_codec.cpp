@@ -0,0 +1,358 @@
+#include "payload_codec.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef DATA_BRIDGE_HAVE_LZ4
+#include <lz4.h>
+#endif
+
+#ifdef DATA_BRIDGE_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace data_bridge {
+
+namespace {
+
+// Upper bound for a decompressed payload, guards against corrupt size headers
+constexpr size_t kMaxDecompressedSize = 64 * 1024 * 1024;
+
+constexpr size_t kLZ4HeaderSize = sizeof(uint32_t);
+
+#if defined(DATA_BRIDGE_HAVE_LZ4) || defined(DATA_BRIDGE_HAVE_ZSTD)
+// Per-thread output buffers, grown to the largest payload seen and then reused
+thread_local std::vector<uint8_t> t_compress_buffer;
+
+uint8_t* ensureCapacity(std::vector<uint8_t>& buffer, size_t size) {
+    if (buffer.size() < size) {
+        buffer.resize(size);
+    }
+    return buffer.data();
+}
+#endif
+
+// Output of the view-returning decompress(), released on the thread's next call
+thread_local PayloadBuffer t_decompress_buffer;
+
+#ifdef DATA_BRIDGE_HAVE_LZ4
+thread_local std::vector<char> t_lz4_state;
+#endif
+
+#ifdef DATA_BRIDGE_HAVE_ZSTD
+// Per-thread zstd contexts, created on first use
+struct ZstdContexts {
+    ZSTD_CCtx* cctx = nullptr;
+    ZSTD_DCtx* dctx = nullptr;
+
+    ~ZstdContexts() {
+        ZSTD_freeCCtx(cctx);
+        ZSTD_freeDCtx(dctx);
+    }
+};
+thread_local ZstdContexts t_zstd;
+#endif
+
+} // namespace
+
+PayloadCodec::PayloadCodec(const StreamConfig& config)
+    : type_(config.compression),
+      min_size_(config.compression_min_size),
+      level_(config.compression_level),
+      dictionary_path_(config.zstd_dictionary) {
+}
+
+PayloadCodec::~PayloadCodec() {
+#ifdef DATA_BRIDGE_HAVE_ZSTD
+    ZSTD_freeCDict(static_cast<ZSTD_CDict*>(zstd_cdict_));
+    ZSTD_freeDDict(static_cast<ZSTD_DDict*>(zstd_ddict_));
+#endif
+}
+
+bool PayloadCodec::init() {
+    if (!isAvailable(type_)) {
+        std::cerr << "[PayloadCodec] Codec not compiled in, rebuild with LZ4/zstd available" << std::endl;
+        return false;
+    }
+
+    if (dictionary_path_.empty()) {
+        return true;
+    }
+
+#ifdef DATA_BRIDGE_HAVE_ZSTD
+    std::ifstream file(dictionary_path_, std::ios::binary);
+    if (!file) {
+        std::cerr << "[PayloadCodec] Failed to open zstd dictionary: " << dictionary_path_ << std::endl;
+        return false;
+    }
+    std::vector<char> dictionary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    zstd_cdict_ = ZSTD_createCDict(dictionary.data(), dictionary.size(), level_);
+    zstd_ddict_ = ZSTD_createDDict(dictionary.data(), dictionary.size());
+    if (!zstd_cdict_ || !zstd_ddict_) {
+        std::cerr << "[PayloadCodec] Invalid zstd dictionary: " << dictionary_path_ << std::endl;
+        return false;
+    }
+
+    std::cout << "[PayloadCodec] Loaded zstd dictionary (" << dictionary.size() << " bytes)" << std::endl;
+    return true;
+#else
+    std::cerr << "[PayloadCodec] zstd dictionary configured but zstd is not compiled in" << std::endl;
+    return false;
+#endif
+}
+
+bool PayloadCodec::compress(ByteView input, ByteView& out, std::optional<zenoh::Encoding>& encoding) {
+    out = input;
+    if (type_ == CompressionType::NONE || input.size < min_size_) {
+        return true;
+    }
+
+    ByteView compressed;
+    bool ok = false;
+    switch (type_) {
+        case CompressionType::LZ4:
+            ok = compressLZ4(input, compressed);
+            break;
+        case CompressionType::ZSTD:
+            ok = compressZSTD(input, compressed);
+            break;
+        default:
+            break;
+    }
+    if (!ok) {
+        return false;
+    }
+
+    // Incompressible payloads go out raw, the receiver never pays for them
+    if (compressed.size >= input.size) {
+        return true;
+    }
+
+    out = compressed;
+    encoding = encodingFor(type_);
+    return true;
+}
+
+bool PayloadCodec::decompress(const zenoh::Encoding& encoding, ByteView input, ByteView& out) {
+    bool decompressed;
+    switch (fromEncoding(encoding)) {
+        case CompressionType::LZ4:
+            decompressed = decompressLZ4(input, t_decompress_buffer);
+            break;
+        case CompressionType::ZSTD:
+            decompressed = decompressZSTD(input, t_decompress_buffer);
+            break;
+        default:
+            out = input;
+            return true;
+    }
+    if (!decompressed) {
+        return false;
+    }
+    out = t_decompress_buffer.view();
+    return true;
+}
+
+bool PayloadCodec::decompress(CompressionType codec, const PayloadBuffer& input, PayloadBuffer& out) {
+    switch (codec) {
+        case CompressionType::LZ4:
+            return decompressLZ4(input.view(), out);
+        case CompressionType::ZSTD:
+            return decompressZSTD(input.view(), out);
+        default:
+            out = input;
+            return true;
+    }
+}
+
+bool PayloadCodec::parseType(const std::string& name, CompressionType& type) {
+    if (name == "none") {
+        type = CompressionType::NONE;
+    } else if (name == "lz4") {
+        type = CompressionType::LZ4;
+    } else if (name == "zstd") {
+        type = CompressionType::ZSTD;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool PayloadCodec::isAvailable(CompressionType type) {
+    switch (type) {
+        case CompressionType::NONE:
+            return true;
+#ifdef DATA_BRIDGE_HAVE_LZ4
+        case CompressionType::LZ4:
+            return true;
+#endif
+#ifdef DATA_BRIDGE_HAVE_ZSTD
+        case CompressionType::ZSTD:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+CompressionType PayloadCodec::fromEncoding(const zenoh::Encoding& encoding) {
+    if (encoding == encodingFor(CompressionType::LZ4)) {
+        return CompressionType::LZ4;
+    }
+    if (encoding == encodingFor(CompressionType::ZSTD)) {
+        return CompressionType::ZSTD;
+    }
+    return CompressionType::NONE;
+}
+
+const zenoh::Encoding& PayloadCodec::encodingFor(CompressionType type) {
+    static const zenoh::Encoding lz4_encoding("zenoh/bytes;lz4");
+    static const zenoh::Encoding zstd_encoding("zenoh/bytes;zstd");
+
+    switch (type) {
+        case CompressionType::LZ4:
+            return lz4_encoding;
+        case CompressionType::ZSTD:
+            return zstd_encoding;
+        default:
+            return zenoh::Encoding::Predefined::zenoh_bytes();
+    }
+}
+
+bool PayloadCodec::compressLZ4(ByteView input, ByteView& out) {
+#ifdef DATA_BRIDGE_HAVE_LZ4
+    if (input.size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+        return false;
+    }
+
+    int bound = LZ4_compressBound(static_cast<int>(input.size));
+    uint8_t* dst = ensureCapacity(t_compress_buffer, kLZ4HeaderSize + bound);
+    if (t_lz4_state.empty()) {
+        t_lz4_state.resize(LZ4_sizeofState());
+    }
+
+    uint32_t original_size = static_cast<uint32_t>(input.size);
+    for (size_t i = 0; i < kLZ4HeaderSize; ++i) {
+        dst[i] = static_cast<uint8_t>(original_size >> (8 * i));
+    }
+
+    int written = LZ4_compress_fast_extState(
+        t_lz4_state.data(),
+        reinterpret_cast<const char*>(input.data),
+        reinterpret_cast<char*>(dst + kLZ4HeaderSize),
+        static_cast<int>(input.size), bound, std::max(1, level_));
+    if (written <= 0) {
+        std::cerr << "[PayloadCodec] LZ4 compression failed" << std::endl;
+        return false;
+    }
+
+    out = {dst, kLZ4HeaderSize + static_cast<size_t>(written)};
+    return true;
+#else
+    (void)input;
+    (void)out;
+    return false;
+#endif
+}
+
+bool PayloadCodec::decompressLZ4(ByteView input, PayloadBuffer& out) {
+#ifdef DATA_BRIDGE_HAVE_LZ4
+    if (input.size < kLZ4HeaderSize) {
+        std::cerr << "[PayloadCodec] Truncated LZ4 payload" << std::endl;
+        return false;
+    }
+
+    uint32_t original_size = 0;
+    for (size_t i = 0; i < kLZ4HeaderSize; ++i) {
+        original_size |= static_cast<uint32_t>(input.data[i]) << (8 * i);
+    }
+    if (original_size > kMaxDecompressedSize) {
+        std::cerr << "[PayloadCodec] LZ4 payload too large: " << original_size << " bytes" << std::endl;
+        return false;
+    }
+
+    PayloadBuffer buffer = PayloadBuffer::allocate(original_size);
+    uint8_t* dst = buffer.data();
+    int read = LZ4_decompress_safe(
+        reinterpret_cast<const char*>(input.data + kLZ4HeaderSize),
+        reinterpret_cast<char*>(dst),
+        static_cast<int>(input.size - kLZ4HeaderSize), static_cast<int>(original_size));
+    if (read < 0 || static_cast<uint32_t>(read) != original_size) {
+        std::cerr << "[PayloadCodec] Corrupt LZ4 payload" << std::endl;
+        return false;
+    }
+
+    out = std::move(buffer);
+    return true;
+#else
+    (void)input;
+    (void)out;
+    std::cerr << "[PayloadCodec] Received LZ4 payload but LZ4 is not compiled in" << std::endl;
+    return false;
+#endif
+}
+
+bool PayloadCodec::compressZSTD(ByteView input, ByteView& out) {
+#ifdef DATA_BRIDGE_HAVE_ZSTD
+    if (!t_zstd.cctx) {
+        t_zstd.cctx = ZSTD_createCCtx();
+    }
+
+    size_t bound = ZSTD_compressBound(input.size);
+    uint8_t* dst = ensureCapacity(t_compress_buffer, bound);
+
+    size_t written = zstd_cdict_
+        ? ZSTD_compress_usingCDict(t_zstd.cctx, dst, bound, input.data, input.size,
+                                   static_cast<const ZSTD_CDict*>(zstd_cdict_))
+        : ZSTD_compressCCtx(t_zstd.cctx, dst, bound, input.data, input.size, level_);
+    if (ZSTD_isError(written)) {
+        std::cerr << "[PayloadCodec] zstd compression failed: " << ZSTD_getErrorName(written) << std::endl;
+        return false;
+    }
+
+    out = {dst, written};
+    return true;
+#else
+    (void)input;
+    (void)out;
+    return false;
+#endif
+}
+
+bool PayloadCodec::decompressZSTD(ByteView input, PayloadBuffer& out) {
+#ifdef DATA_BRIDGE_HAVE_ZSTD
+    if (!t_zstd.dctx) {
+        t_zstd.dctx = ZSTD_createDCtx();
+    }
+
+    unsigned long long original_size = ZSTD_getFrameContentSize(input.data, input.size);
+    if (original_size == ZSTD_CONTENTSIZE_UNKNOWN || original_size == ZSTD_CONTENTSIZE_ERROR ||
+        original_size > kMaxDecompressedSize) {
+        std::cerr << "[PayloadCodec] Invalid zstd frame header" << std::endl;
+        return false;
+    }
+
+    PayloadBuffer buffer = PayloadBuffer::allocate(original_size);
+    uint8_t* dst = buffer.data();
+    size_t read = zstd_ddict_
+        ? ZSTD_decompress_usingDDict(t_zstd.dctx, dst, original_size, input.data, input.size,
+                                     static_cast<const ZSTD_DDict*>(zstd_ddict_))
+        : ZSTD_decompressDCtx(t_zstd.dctx, dst, original_size, input.data, input.size);
+    if (ZSTD_isError(read) || read != original_size) {
+        std::cerr << "[PayloadCodec] Corrupt zstd payload" << std::endl;
+        return false;
+    }
+
+    out = std::move(buffer);
+    return true;
+#else
+    (void)input;
+    (void)out;
+    std::cerr << "[PayloadCodec] Received zstd payload but zstd is not compiled in" << std::endl;
+    return false;
+#endif
+}
+
+} // namespace data_bridge
@@ -0,0 +1,479 @@
+#include "poll_server.h"
+#include "thread_placement.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/un.h>
+
+namespace data_bridge {
+
+namespace {
+
+constexpr size_t kIdSize = 8;
+constexpr size_t kLengthSize = 4;
+constexpr size_t kKindSize = 1;
+
+// Larger polls are a protocol error, the connection is dropped
+constexpr size_t kMaxPoll = 65536;
+
+constexpr size_t kReceiveChunk = 65536;
+
+// Longest poll, bounds how late stop() and flight expiry are noticed
+constexpr int kMaxPollMs = 100;
+
+// A flight whose query has not finished timeout_ms plus this late is ended by the server
+constexpr int64_t kCompletionGraceNs = 1000000000;
+
+const char kUnavailable[] = "unavailable";
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void writeLittleEndian(uint64_t value, size_t bytes, uint8_t* data) {
+    for (size_t i = 0; i < bytes; ++i) {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t readLittleEndian(const uint8_t* data, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = bytes; i-- > 0;) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+} // namespace
+
+PollServer::PollServer(const PollConfig& config)
+    : config_(config),
+      stream_(config.transport != ServiceTransport::UDP) {
+}
+
+PollServer::~PollServer() {
+    stop();
+}
+
+bool PollServer::start(QueryFunction query, int inherited) {
+    if (running_ || !query) {
+        return false;
+    }
+    if (inherited >= 0) {
+        listen_fd_ = inherited;
+    } else if (!openListener()) {
+        return false;
+    }
+    query_ = std::move(query);
+
+    running_ = true;
+    try {
+        server_thread_ = std::thread(&PollServer::serverLoop, this);
+    } catch (const std::exception& e) {
+        std::cerr << "[PollServer] Failed to start server thread: " << e.what() << std::endl;
+        running_ = false;
+        close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    std::cout << "[PollServer] Listening on " << describe() << ": timeout " << config_.timeout_ms
+              << " ms, coalescing " << config_.coalesce_ms << " ms" << std::endl;
+    return true;
+}
+
+void PollServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+    if (server_thread_.joinable()) {
+        server_thread_.join();
+    }
+
+    // Replies of queries still running are dropped by deliver() and complete()
+    std::lock_guard<std::mutex> lock(mutex_);
+    flights_.clear();
+    by_parameters_.clear();
+    for (auto& entry : connections_) {
+        close(entry.second.fd);
+    }
+    connections_.clear();
+    close(listen_fd_);
+    listen_fd_ = -1;
+    if (config_.transport == ServiceTransport::UNIX && !handed_over_) {
+        unlink(config_.unix_path.c_str());
+    }
+}
+
+void PollServer::deliver(uint64_t flight, PollReplyKind kind, std::vector<uint8_t> payload) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = flights_.find(flight);
+    if (it == flights_.end() || it->second.done) {
+        return;
+    }
+    for (const auto& waiter : it->second.waiters) {
+        sendLocked(waiter, kind, payload.data(), payload.size());
+    }
+    it->second.replies.push_back(Reply{kind, std::move(payload)});
+}
+
+void PollServer::complete(uint64_t flight) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    finishLocked(flight);
+}
+
+PollStats PollServer::getStats() const {
+    PollStats stats;
+    stats.requests = requests_.load();
+    stats.queries = queries_.load();
+    stats.coalesced = coalesced_.load();
+    stats.replies = replies_.load();
+    stats.unavailable = unavailable_.load();
+    stats.send_failures = send_failures_.load();
+    return stats;
+}
+
+std::string PollServer::describe() const {
+    switch (config_.transport) {
+        case ServiceTransport::TCP: return "tcp://" + config_.host + ":" + std::to_string(config_.port);
+        case ServiceTransport::UNIX: return "unix://" + config_.unix_path;
+        default: return "udp://" + config_.host + ":" + std::to_string(config_.port);
+    }
+}
+
+void PollServer::serverLoop() {
+    ThreadRegistration registration("poll");
+
+    std::vector<pollfd> fds;
+    std::vector<uint64_t> ids;
+    std::vector<std::pair<Requester, std::string>> polls;
+    while (running_) {
+        fds.clear();
+        ids.clear();
+        fds.push_back(pollfd{listen_fd_, POLLIN, 0});
+        ids.push_back(0);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& entry : connections_) {
+                fds.push_back(pollfd{entry.second.fd, POLLIN, 0});
+                ids.push_back(entry.first);
+            }
+        }
+
+        int ready = poll(fds.data(), fds.size(), kMaxPollMs);
+        if (ready < 0 && errno != EINTR) {
+            std::cerr << "[PollServer] poll failed: " << strerror(errno) << std::endl;
+            break;
+        }
+        expireFlights();
+        if (ready <= 0) {
+            continue;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            if (stream_) {
+                acceptConnections();
+            } else {
+                receiveDatagrams();
+            }
+        }
+
+        // Connections may have been closed by a failed send since the poll, they are looked up again
+        for (size_t i = 1; i < fds.size(); ++i) {
+            if (!(fds[i].revents & (POLLIN | POLLHUP | POLLERR))) {
+                continue;
+            }
+            polls.clear();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = connections_.find(ids[i]);
+                if (it != connections_.end() && !readConnection(ids[i], it->second, polls)) {
+                    closeLocked(ids[i]);
+                }
+            }
+            for (auto& entry : polls) {
+                onPoll(entry.first, std::move(entry.second));
+            }
+        }
+    }
+}
+
+bool PollServer::openListener() {
+    bool unix_socket = config_.transport == ServiceTransport::UNIX;
+    int fd = socket(unix_socket ? AF_UNIX : AF_INET,
+                    (stream_ ? SOCK_STREAM : SOCK_DGRAM) | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        std::cerr << "[PollServer] Failed to create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    int result = -1;
+    if (unix_socket) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (config_.unix_path.size() < sizeof(addr.sun_path)) {
+            // A previous run may have left its socket file behind
+            unlink(config_.unix_path.c_str());
+            std::memcpy(addr.sun_path, config_.unix_path.c_str(), config_.unix_path.size() + 1);
+            result = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        } else {
+            errno = ENAMETOOLONG;
+        }
+    } else {
+        int reuse = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(config_.port));
+        if (inet_pton(AF_INET, config_.host.c_str(), &addr.sin_addr) == 1) {
+            result = bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        } else {
+            errno = EINVAL;
+        }
+    }
+    if (result == 0 && stream_) {
+        result = listen(fd, SOMAXCONN);
+    }
+    if (result < 0) {
+        std::cerr << "[PollServer] Failed to listen on " << describe() << ": " << strerror(errno) << std::endl;
+        close(fd);
+        return false;
+    }
+
+    listen_fd_ = fd;
+    return true;
+}
+
+void PollServer::acceptConnections() {
+    while (true) {
+        int fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC | SOCK_NONBLOCK);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "[PollServer] accept failed: " << strerror(errno) << std::endl;
+            }
+            return;
+        }
+        if (config_.transport == ServiceTransport::TCP) {
+            int nodelay = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        connections_[next_connection_++].fd = fd;
+    }
+}
+
+bool PollServer::readConnection(uint64_t id, Connection& connection,
+                                std::vector<std::pair<Requester, std::string>>& polls) {
+    uint8_t chunk[kReceiveChunk];
+    while (true) {
+        ssize_t received = recv(connection.fd, chunk, sizeof(chunk), MSG_DONTWAIT);
+        if (received > 0) {
+            connection.input.insert(connection.input.end(), chunk, chunk + received);
+            continue;
+        }
+        if (received == 0) {
+            return false;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break;
+        }
+        if (errno != EINTR) {
+            return false;
+        }
+    }
+
+    size_t offset = 0;
+    while (connection.input.size() - offset >= kLengthSize) {
+        size_t length = readLittleEndian(connection.input.data() + offset, kLengthSize);
+        if (length < kIdSize || length > kMaxPoll) {
+            std::cerr << "[PollServer] " << describe() << ": invalid poll length " << length
+                      << ", closing connection" << std::endl;
+            return false;
+        }
+        if (connection.input.size() - offset < kLengthSize + length) {
+            break;
+        }
+        const uint8_t* frame = connection.input.data() + offset + kLengthSize;
+        Requester requester;
+        requester.connection = id;
+        requester.request_id = readLittleEndian(frame, kIdSize);
+        polls.emplace_back(requester, std::string(reinterpret_cast<const char*>(frame) + kIdSize,
+                                                  length - kIdSize));
+        offset += kLengthSize + length;
+    }
+    connection.input.erase(connection.input.begin(), connection.input.begin() + offset);
+    return true;
+}
+
+void PollServer::receiveDatagrams() {
+    uint8_t datagram[kReceiveChunk];
+    while (running_) {
+        Requester requester;
+        requester.address_len = sizeof(requester.address);
+        ssize_t received = recvfrom(listen_fd_, datagram, sizeof(datagram), MSG_DONTWAIT,
+                                    reinterpret_cast<sockaddr*>(&requester.address), &requester.address_len);
+        if (received < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "[PollServer] recvfrom failed: " << strerror(errno) << std::endl;
+            }
+            return;
+        }
+        if (static_cast<size_t>(received) < kIdSize) {
+            continue;
+        }
+        requester.request_id = readLittleEndian(datagram, kIdSize);
+        onPoll(requester, std::string(reinterpret_cast<const char*>(datagram) + kIdSize, received - kIdSize));
+    }
+}
+
+void PollServer::onPoll(const Requester& requester, std::string parameters) {
+    requests_++;
+    int64_t now = steadyNowNs();
+
+    uint64_t id = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto joined = by_parameters_.find(parameters);
+        if (joined != by_parameters_.end()) {
+            auto it = flights_.find(joined->second);
+            if (it != flights_.end() && (!it->second.done || now < it->second.expires_ns)) {
+                Flight& flight = it->second;
+                for (const auto& reply : flight.replies) {
+                    sendLocked(requester, reply.kind, reply.payload.data(), reply.payload.size());
+                }
+                if (flight.done) {
+                    sendLocked(requester, PollReplyKind::END, nullptr, 0);
+                } else {
+                    flight.waiters.push_back(requester);
+                }
+                coalesced_++;
+                return;
+            }
+        }
+
+        id = next_flight_++;
+        Flight& flight = flights_[id];
+        flight.parameters = parameters;
+        flight.waiters.push_back(requester);
+        flight.expires_ns = now + static_cast<int64_t>(config_.timeout_ms) * 1000000 + kCompletionGraceNs;
+        by_parameters_[parameters] = id;
+    }
+
+    // Replies may arrive on Zenoh threads before query_ returns, so mutex_ is not held here
+    queries_++;
+    if (query_(parameters, id)) {
+        return;
+    }
+
+    unavailable_++;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = flights_.find(id);
+    if (it == flights_.end() || it->second.done) {
+        return;
+    }
+    for (const auto& waiter : it->second.waiters) {
+        sendLocked(waiter, PollReplyKind::ERROR, reinterpret_cast<const uint8_t*>(kUnavailable),
+                   sizeof(kUnavailable) - 1);
+    }
+    finishLocked(id);
+
+    // Not reused, the next poll tries again
+    it->second.expires_ns = 0;
+}
+
+void PollServer::expireFlights() {
+    int64_t now = steadyNowNs();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto it = flights_.begin(); it != flights_.end();) {
+        Flight& flight = it->second;
+        if (now < flight.expires_ns) {
+            ++it;
+            continue;
+        }
+        if (!flight.done) {
+            std::cerr << "[PollServer] " << describe() << ": query '" << flight.parameters
+                      << "' did not finish, ending it" << std::endl;
+            finishLocked(it->first);
+            ++it;
+            continue;
+        }
+        auto joined = by_parameters_.find(flight.parameters);
+        if (joined != by_parameters_.end() && joined->second == it->first) {
+            by_parameters_.erase(joined);
+        }
+        it = flights_.erase(it);
+    }
+}
+
+void PollServer::finishLocked(uint64_t flight) {
+    auto it = flights_.find(flight);
+    if (it == flights_.end() || it->second.done) {
+        return;
+    }
+    for (const auto& waiter : it->second.waiters) {
+        sendLocked(waiter, PollReplyKind::END, nullptr, 0);
+    }
+    it->second.waiters.clear();
+    it->second.done = true;
+    it->second.expires_ns = steadyNowNs() + static_cast<int64_t>(config_.coalesce_ms) * 1000000;
+}
+
+void PollServer::sendLocked(const Requester& requester, PollReplyKind kind, const uint8_t* data, size_t len) {
+    size_t header = (stream_ ? kLengthSize : 0) + kIdSize + kKindSize;
+    frame_.resize(header + len);
+    if (stream_) {
+        writeLittleEndian(kIdSize + kKindSize + len, kLengthSize, frame_.data());
+    }
+    writeLittleEndian(requester.request_id, kIdSize, frame_.data() + header - kIdSize - kKindSize);
+    frame_[header - kKindSize] = static_cast<uint8_t>(kind);
+    if (len > 0) {
+        std::memcpy(frame_.data() + header, data, len);
+    }
+
+    if (!stream_) {
+        ssize_t sent = sendto(listen_fd_, frame_.data(), frame_.size(), MSG_DONTWAIT,
+                              reinterpret_cast<const sockaddr*>(&requester.address), requester.address_len);
+        if (sent < 0) {
+            send_failures_++;
+        } else if (kind != PollReplyKind::END) {
+            replies_++;
+        }
+        return;
+    }
+
+    // The consumer has left, its waiters are skipped
+    auto it = connections_.find(requester.connection);
+    if (it == connections_.end()) {
+        return;
+    }
+
+    // A partial frame would break the framing, so a consumer that does not keep up is closed
+    ssize_t sent = send(it->second.fd, frame_.data(), frame_.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+    if (sent != static_cast<ssize_t>(frame_.size())) {
+        send_failures_++;
+        std::cerr << "[PollServer] " << describe() << ": consumer not keeping up, closing connection" << std::endl;
+        closeLocked(requester.connection);
+        return;
+    }
+    if (kind != PollReplyKind::END) {
+        replies_++;
+    }
+}
+
+void PollServer::closeLocked(uint64_t connection) {
+    auto it = connections_.find(connection);
+    if (it == connections_.end()) {
+        return;
+    }
+    close(it->second.fd);
+    connections_.erase(it);
+}
+
+} // namespace data_bridge
@@ -1,22 +1,58 @@
 #include "receiver_bridge.h"
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <unistd.h>
+#include <sys/eventfd.h>
 
 namespace data_bridge {
 
-ReceiverBridge::StreamHandler::~StreamHandler() {
-    if (udp_socket >= 0) {
-        close(udp_socket);
+namespace {
+
+// Consecutive failures before a target is skipped, and for how long
+constexpr int kTargetFailureLimit = 5;
+constexpr int64_t kTargetSuspendNs = 1000000000;
+
+// How often a throttled stream re-checks its consumer
+constexpr auto kThrottlePoll = std::chrono::microseconds(100);
+
+// How often lazy streams are checked for a departed consumer
+constexpr auto kConsumerCheckPeriod = std::chrono::milliseconds(100);
+
+// A restarted bridge waits this much longer than drain_timeout_ms for the previous one to confirm
+constexpr int kHandoffConfirmMarginMs = 1000;
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Text of a sample's encoding. A stream's encoding rarely changes, so each thread keeps the last
+// one and only allocates when a different encoding arrives.
+std::string_view encodingString(const zenoh::Encoding& encoding) {
+    thread_local zenoh::Encoding last;
+    thread_local std::string last_string = last.as_string();
+    if (!(encoding == last)) {
+        last = encoding;
+        last_string = encoding.as_string();
     }
+    return last_string;
 }
 
+} // namespace
+
 ReceiverBridge::ReceiverBridge(const BridgeConfig& config)
     : config_(config),
-      session_(zenoh::Session::open(zenoh::Config::create_default())) {
+      supervisor_(config),
+      destinations_(config) {
+    shutdown_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
 }
 
 ReceiverBridge::~ReceiverBridge() {
     stop();
+    if (shutdown_fd_ >= 0) {
+        close(shutdown_fd_);
+    }
 }
 
 bool ReceiverBridge::start() {
@@ -26,7 +62,19 @@ bool ReceiverBridge::start() {
     }
     
     std::cout << "[ReceiverBridge] Starting..." << std::endl;
-    std::cout << "[ReceiverBridge] Zenoh session already opened in constructor" << std::endl;
+    
+    BufferPool::instance().setHugePages(config_.buffer_pool_hugepages);
+    retired_ = false;
+    
+    // A restarted bridge takes over the sockets and caches of the running one before opening its own
+    if (!config_.handoff_path.empty()) {
+        handoff_ = std::make_unique<Handoff>(config_.handoff_path);
+        if (!handoff_->receive()) {
+            std::cerr << "[ReceiverBridge] Handoff failed, not starting next to the running bridge" << std::endl;
+            handoff_.reset();
+            return false;
+        }
+    }
     
     // Initialize all streams
     for (const auto& stream_config : config_.streams) {
@@ -42,14 +90,160 @@ bool ReceiverBridge::start() {
         handlers_.push_back(std::move(handler));
     }
     
-    if (handlers_.empty()) {
-        std::cerr << "[ReceiverBridge] No streams initialized" << std::endl;
+    for (const auto& service_config : config_.services) {
+        auto service = std::make_unique<ServiceHandler>();
+        service->config = service_config;
+        
+        if (!initService(*service)) {
+            std::cerr << "[ReceiverBridge] Failed to initialize service: "
+                      << service_config.zenoh_key << std::endl;
+            continue;
+        }
+        
+        services_.push_back(std::move(service));
+    }
+    
+    for (const auto& poll_config : config_.polls) {
+        auto poll = std::make_unique<PollHandler>();
+        poll->config = poll_config;
+        
+        if (!initPoll(*poll)) {
+            std::cerr << "[ReceiverBridge] Failed to initialize poll endpoint: "
+                      << poll_config.zenoh_key << std::endl;
+            continue;
+        }
+        
+        polls_.push_back(std::move(poll));
+    }
+    
+    if (handlers_.empty() && services_.empty() && polls_.empty()) {
+        std::cerr << "[ReceiverBridge] No streams, services or poll endpoints initialized" << std::endl;
+        return false;
+    }
+    
+    if (handoff_ && handoff_->tookOver()) {
+        adoptHandoff();
+    }
+    
+    if (config_.egress_backend == "io_uring") {
+        initEgress();
+    }
+    
+    if (!config_.forwarding_workers.empty()) {
+        initExecutor();
+    }
+    
+    // Sampling costs a sock_diag dump per period, only worth it if some stream acts on the pressure
+    bool acts_on_pressure = std::any_of(config_.streams.begin(), config_.streams.end(),
+        [](const StreamConfig& stream) { return stream.backpressure != BackpressureAction::NONE; });
+    auto destinations = destinations_.all();
+    if (config_.backpressure_interval_ms > 0 && acts_on_pressure && !destinations.empty()) {
+        backpressure_ = std::make_unique<BackpressureMonitor>(config_, std::move(destinations));
+        if (!backpressure_->start()) {
+            backpressure_.reset();
+        }
+    }
+    
+    if (!config_.capture_dir.empty()) {
+        capture_ = std::make_unique<CaptureWriter>(config_);
+        if (!capture_->start()) {
+            std::cerr << "[ReceiverBridge] Failed to start capture" << std::endl;
+            capture_.reset();
+        }
+    }
+    
+    // Restarted consumers get the cached state right away. Lazy streams are activated by their
+    // consumers, so the registry listens before the first session is up.
+    if (config_.registration_port > 0) {
+        registry_ = std::make_unique<ConsumerRegistry>(config_.registration_port);
+        auto on_message = [this](ConsumerMessage message, const std::string& topic) {
+            onConsumerMessage(message, topic);
+        };
+        if (!registry_->start(on_message, inheritedSocket("registration"))) {
+            std::cerr << "[ReceiverBridge] Failed to start consumer registry" << std::endl;
+            registry_.reset();
+            for (auto& handler : handlers_) {
+                if (handler->config.lazy) {
+                    std::cerr << "[ReceiverBridge] Stream '" << handler->config.zenoh_topic
+                              << "': no consumer registry, subscribing now" << std::endl;
+                    handler->config.lazy = false;
+                }
+            }
+        }
+    }
+    
+    // Subscribers follow the session across reconnects
+    supervisor_.setReconnectCallback([this](zenoh::Session& session) {
+        redeclareStreams(session);
+        redeclareServices(session);
+        redeclarePolls(session);
+    });
+    
+    if (!supervisor_.start()) {
+        std::cerr << "[ReceiverBridge] Failed to start session supervisor" << std::endl;
+        handlers_.clear();
+        services_.clear();
+        polls_.clear();
         return false;
     }
     
+    // If the router is not reachable yet, the supervisor declares them once connected
+    supervisor_.withSession([this](zenoh::Session& session) {
+        redeclareStreams(session);
+        redeclareServices(session);
+        redeclarePolls(session);
+    });
+    
+    // Rate-conflated and pull streams share one timer thread, streams with the same period drain on the same tick
+    for (auto& handler : handlers_) {
+        bool conflated = handler->conflater && !handler->config.conflation_consumer_paced;
+        bool pulled = handler->config.ingest != IngestMode::CALLBACK;
+        if (!conflated && !pulled) {
+            continue;
+        }
+        if (!timer_wheel_) {
+            timer_wheel_ = std::make_unique<TimerWheel>(std::chrono::microseconds(config_.timer_tick_us));
+        }
+        StreamHandler* stream = handler.get();
+        if (conflated) {
+            auto period = std::chrono::microseconds(
+                static_cast<int64_t>(1e6 / handler->config.conflation_rate_hz));
+            timer_wheel_->schedulePeriodic(period, [this, stream]() {
+                flushStream(*stream);
+            });
+        } else {
+            auto period = std::chrono::microseconds(std::max(handler->config.ingest_interval_us, 1));
+            timer_wheel_->schedulePeriodic(period, [this, stream]() {
+                requestDrain(*stream);
+            });
+        }
+    }
+    bool lazy = std::any_of(handlers_.begin(), handlers_.end(), [](const std::unique_ptr<StreamHandler>& handler) {
+        return handler->config.lazy;
+    });
+    if (lazy) {
+        if (!timer_wheel_) {
+            timer_wheel_ = std::make_unique<TimerWheel>(std::chrono::microseconds(config_.timer_tick_us));
+        }
+        timer_wheel_->schedulePeriodic(kConsumerCheckPeriod, [this]() {
+            expireConsumers();
+        });
+    }
+    if (timer_wheel_) {
+        timer_wheel_->start();
+    }
+    
     running_ = true;
     std::cout << "[ReceiverBridge] Started with " << handlers_.size() << " stream(s)" << std::endl;
     
+    // Subscribed next to the previous bridge, which drains and exits now
+    if (handoff_) {
+        if (handoff_->tookOver()) {
+            handoff_->complete(config_.drain_timeout_ms + kHandoffConfirmMarginMs);
+        }
+        handoff_->listen([this]() { return offerHandoff(); }, [this]() { handOver(); });
+    }
+    
     return true;
 }
 
@@ -61,11 +255,60 @@ void ReceiverBridge::stop() {
     std::cout << "[ReceiverBridge] Stopping..." << std::endl;
     running_ = false;
     
+    // A handover in progress finishes first, its drain is the one below
+    if (handoff_) {
+        handoff_->stop();
+        handoff_.reset();
+    }
+    
+    retire();
+    registry_.reset();
+    
+    // Conflated streams were flushed one last time
+    if (timer_wheel_) {
+        timer_wheel_->stop();
+        timer_wheel_.reset();
+    }
+    
+    // Pending queries are answered with an error while the session is still open
+    for (auto& service : services_) {
+        service->client->stop();
+    }
+    
+    if (executor_) {
+        executor_->stop(!drained_);
+        executor_.reset();
+    }
+    
+    // Throttled streams keep watching their consumers until the queues are drained
+    if (backpressure_) {
+        backpressure_->stop();
+        backpressure_.reset();
+    }
+    
     // Close all streams
     for (auto& handler : handlers_) {
         closeStream(*handler);
     }
+    
+    // Sends queued before the sockets closed still go out through the registered files
+    for (auto& egress : egress_) {
+        egress->stop();
+    }
+    egress_.clear();
     handlers_.clear();
+    services_.clear();
+    destinations_.clear();
+    
+    // Subscribers are gone, flush what is left in the capture ring
+    if (capture_) {
+        capture_->stop();
+        capture_.reset();
+    }
+    
+    // Closing the session drops the callbacks of pending gets, which still reference the poll servers
+    supervisor_.stop();
+    polls_.clear();
     
     std::cout << "[ReceiverBridge] Stopped" << std::endl;
 }
@@ -75,27 +318,138 @@ bool ReceiverBridge::initStream(StreamHandler& handler) {
     
     std::cout << "[ReceiverBridge] Initializing stream:" << std::endl;
     std::cout << "  Topic: " << config.zenoh_topic << std::endl;
-    std::cout << "  Protocol: " << (config.protocol == ProtocolType::UDP ? "UDP" : "gRPC") << std::endl;
-    std::cout << "  Destination: " << config.local_host << ":" << config.local_port << std::endl;
     
-    // Initialize protocol-specific resources
-    if (config.protocol == ProtocolType::UDP) {
-        // Create UDP socket
-        handler.udp_socket = socket(AF_INET, SOCK_DGRAM, 0);
-        if (handler.udp_socket < 0) {
-            std::cerr << "[ReceiverBridge] Failed to create UDP socket: " << strerror(errno) << std::endl;
+    handler.codec = std::make_unique<PayloadCodec>(config);
+    if (!handler.codec->init()) {
+        std::cerr << "[ReceiverBridge] Failed to initialize codec" << std::endl;
+        return false;
+    }
+    
+    if (config.integrity != IntegrityCheck::NONE) {
+        std::cout << "  Integrity: " << Integrity::describe(config.integrity)
+                  << (config.integrity_strip ? ", trailer stripped" : "") << std::endl;
+    }
+    
+    // A schema only named for filters on packed struct fields converts nothing
+    bool converts = config.transcode_from != config.transcode_to || !config.transcode_fields.empty();
+    if (!config.transcode_schema.empty() && (converts || config.filters.empty())) {
+        handler.transcoder = std::make_unique<Transcoder>(config);
+        if (!handler.transcoder->init()) {
+            std::cerr << "[ReceiverBridge] Failed to initialize transcoder" << std::endl;
+            return false;
+        }
+        std::cout << "  Transcode: " << handler.transcoder->describe() << std::endl;
+    }
+    
+    if (!config.filters.empty() || config.filter_duplicates) {
+        handler.filter = std::make_unique<ContentFilter>(
+            config, handler.transcoder ? handler.transcoder->schema() : nullptr);
+        if (!handler.filter->init()) {
+            std::cerr << "[ReceiverBridge] Failed to initialize content filter" << std::endl;
             return false;
         }
+        std::cout << "  Filter: " << handler.filter->describe() << std::endl;
+    }
+    
+    if (config.cache_depth > 0) {
+        handler.cache = std::make_unique<LastValueCache>(config.cache_depth, config.cache_max_payload);
+        std::cout << "  Cache: " << config.cache_depth << " sample(s)"
+                  << (config.cache_queryable ? ", queryable" : "") << std::endl;
+    }
+    
+    if (config.sequence_source != SequenceSource::NONE) {
+        handler.sequence = std::make_unique<SequenceTracker>();
+        std::cout << "  Sequence tracking: "
+                  << (config.sequence_source == SequenceSource::SOURCE_INFO ? "source info" : "payload header")
+                  << std::endl;
+    }
+    
+    if (config.recoverable) {
+        std::cout << "  Recovery: publisher cache";
+        if (config.recovery_history > 0) {
+            std::cout << ", history " << config.recovery_history << " sample(s)";
+        }
+        std::cout << std::endl;
+        if (config.recovery_history > 0 && config.sequence_source == SequenceSource::NONE) {
+            std::cerr << "[ReceiverBridge] Stream '" << config.zenoh_topic
+                      << "': history without sequence_source may repeat samples after a re-subscribe" << std::endl;
+        }
+    }
+    
+    if (config.lazy) {
+        if (config_.registration_port <= 0) {
+            std::cerr << "[ReceiverBridge] Stream '" << config.zenoh_topic
+                      << "': lazy needs registration_port, subscribing now" << std::endl;
+            handler.config.lazy = false;
+        } else {
+            std::cout << "  Lazy: subscribed while a consumer is registered" << std::endl;
+        }
+    }
+    
+    if (config.ingest != IngestMode::CALLBACK) {
+        if (config.conflation_rate_hz > 0.0 || config.conflation_consumer_paced || config.recoverable) {
+            std::cerr << "[ReceiverBridge] Stream '" << config.zenoh_topic
+                      << "': pull ingest does not combine with conflation or recovery, using the callback" << std::endl;
+            handler.config.ingest = IngestMode::CALLBACK;
+        } else {
+            handler.config.ingest_batch = std::max<size_t>(config.ingest_batch, 1);
+            std::cout << "  Ingest: " << (config.ingest == IngestMode::RING ? "ring" : "FIFO") << " channel, "
+                      << config.ingest_capacity << " slots, batches of " << config.ingest_batch
+                      << " every " << config.ingest_interval_us << " us" << std::endl;
+        }
+    }
+    
+    if (config.conflation_consumer_paced) {
+        handler.conflater = std::make_unique<Conflater>(true);
+        std::cout << "  Conflation: consumer-paced" << std::endl;
+    } else if (config.conflation_rate_hz > 0.0) {
+        handler.conflater = std::make_unique<Conflater>(false);
+        std::cout << "  Conflation: " << config.conflation_rate_hz << " Hz" << std::endl;
+    }
+    
+    // Every sample is received once and sent to all targets
+    auto targets = config.targets();
+    for (const auto& target_config : targets) {
+        auto target = std::make_unique<TargetHandler>();
+        target->config = target_config;
         
-        // Setup destination address
-        memset(&handler.udp_addr, 0, sizeof(handler.udp_addr));
-        handler.udp_addr.sin_family = AF_INET;
-        handler.udp_addr.sin_port = htons(config.local_port);
+        // With several consumers a full socket buffer must not hold up the others
+        target->nonblocking = targets.size() > 1;
+        target->backpressure = config.backpressure;
+        target->backpressure_priority = config.backpressure_priority;
         
-        if (inet_pton(AF_INET, config.local_host.c_str(), &handler.udp_addr.sin_addr) <= 0) {
-            std::cerr << "[ReceiverBridge] Invalid UDP address: " << config.local_host << std::endl;
-            close(handler.udp_socket);
-            handler.udp_socket = -1;
+        // The pressure level changes once per sampling period, a shorter wait would shed on every throttle
+        int64_t interval_ns = static_cast<int64_t>(config_.backpressure_interval_ms) * 1000000;
+        target->backpressure_max_wait_ns = config.backpressure_max_wait_us > 0
+            ? static_cast<int64_t>(config.backpressure_max_wait_us) * 1000 : 2 * interval_ns;
+        if (config.backpressure == BackpressureAction::THROTTLE && target->backpressure_max_wait_ns < interval_ns) {
+            std::cerr << "[ReceiverBridge] Stream '" << config.zenoh_topic << "': backpressure_max_wait_us "
+                      << config.backpressure_max_wait_us << " is shorter than backpressure_interval_ms, "
+                      << "throttled samples will mostly be shed" << std::endl;
+        }
+        
+        if (!initTarget(*target)) {
+            return false;
+        }
+        handler.targets.push_back(std::move(target));
+    }
+    
+    return true;
+}
+
+bool ReceiverBridge::initTarget(TargetHandler& target) {
+    const auto& config = target.config;
+    
+    std::cout << "  Protocol: " << (config.protocol == ProtocolType::UDP ? "UDP" : "gRPC") << std::endl;
+    std::cout << "  Destination: " << config.local_host << ":" << config.local_port << std::endl;
+    
+    // Initialize protocol-specific resources
+    if (config.protocol == ProtocolType::UDP) {
+        // Streams to the same host:port share its connected sockets
+        target.destination = destinations_.acquire(
+            config.local_host, config.local_port,
+            inheritedSockets("udp:" + config.local_host + ":" + std::to_string(config.local_port)));
+        if (!target.destination) {
             return false;
         }
         
@@ -106,102 +460,1312 @@ bool ReceiverBridge::initStream(StreamHandler& handler) {
         std::cout << "  Method: " << config.grpc_method << std::endl;
     }
     
-    // Create Zenoh subscriber
+    return true;
+}
+
+bool ReceiverBridge::initService(ServiceHandler& service) {
+    const auto& config = service.config;
+    
+    std::cout << "[ReceiverBridge] Initializing service:" << std::endl;
+    std::cout << "  Key: " << config.zenoh_key << std::endl;
+    
+    if (config.zenoh_key.empty() ||
+        (config.transport == ServiceTransport::UNIX ? config.unix_path.empty() : config.port <= 0)) {
+        std::cerr << "[ReceiverBridge] Service needs zenoh_key and a port or unix_path" << std::endl;
+        return false;
+    }
+    
+    service.client = std::make_unique<ServiceClient>(config);
+    return service.client->start();
+}
+
+bool ReceiverBridge::initPoll(PollHandler& poll) {
+    const auto& config = poll.config;
+    
+    std::cout << "[ReceiverBridge] Initializing poll endpoint:" << std::endl;
+    std::cout << "  Key: " << config.zenoh_key << std::endl;
+    
+    if (config.zenoh_key.empty() ||
+        (config.transport == ServiceTransport::UNIX ? config.unix_path.empty() : config.port <= 0)) {
+        std::cerr << "[ReceiverBridge] Poll endpoint needs zenoh_key and a port or unix_path" << std::endl;
+        return false;
+    }
+    
+    poll.server = std::make_unique<PollServer>(config);
+    PollHandler* handler = &poll;
+    return poll.server->start([this, handler](const std::string& parameters, uint64_t flight) {
+        return startPollQuery(*handler, parameters, flight);
+    }, inheritedSocket("poll:" + poll.server->describe()));
+}
+
+void ReceiverBridge::initEgress() {
+    if (!UringEgress::isAvailable()) {
+        std::cerr << "[ReceiverBridge] io_uring not available, using sendto" << std::endl;
+        return;
+    }
+    
+    size_t engine_count = static_cast<size_t>(std::max(config_.io_uring_engines, 1));
+    for (size_t i = 0; i < engine_count; ++i) {
+        egress_.push_back(std::make_unique<UringEgress>(config_.io_uring_queue_depth,
+                                                        config_.io_uring_buffer_size,
+                                                        config_.io_uring_zerocopy_threshold));
+    }
+    
+    std::vector<std::vector<TargetHandler*>> groups(engine_count);
+    size_t next = 0;
+    for (auto& handler : handlers_) {
+        for (auto& target : handler->targets) {
+            if (!target->destination) {
+                continue;
+            }
+            // Every shard, so the engine sends from the same source ports as the threads would
+            size_t index = next++ % engine_count;
+            for (int fd : target->destination->sockets()) {
+                target->egress_handles.push_back(egress_[index]->registerSocket(fd));
+            }
+            groups[index].push_back(target.get());
+        }
+    }
+    
+    // A group whose engine fails keeps using sendto
+    for (size_t i = 0; i < engine_count; ++i) {
+        if (groups[i].empty() || !egress_[i]->start()) {
+            continue;
+        }
+        for (auto* target : groups[i]) {
+            target->egress = egress_[i].get();
+        }
+    }
+}
+
+void ReceiverBridge::initExecutor() {
+    auto forward = [this](ForwardTask& task) {
+        auto& stream = *static_cast<StreamHandler*>(task.stream);
+        if (!task.drain) {
+            forwardSample(stream, task.codec, task.payload);
+        } else if (drainStream(stream) == stream.config.ingest_batch) {
+            // More may be waiting, queue behind the other streams instead of draining on
+            requestDrain(stream);
+        }
+    };
+    executor_ = std::make_unique<ForwardingExecutor>(config_.forwarding_workers, config_.forwarding_queue_depth,
+                                                     std::chrono::microseconds(config_.forwarding_spin_us),
+                                                     std::chrono::microseconds(config_.low_latency_idle_us),
+                                                     forward);
+    
+    // Conflated streams forward from their flush instead
+    for (auto& handler : handlers_) {
+        if (handler->conflater) {
+            continue;
+        }
+        int pinned = handler->config.forwarding_worker;
+        bool busy_poll = handler->config.low_latency;
+        if (busy_poll && pinned < 0) {
+            std::cerr << "[ReceiverBridge] Stream '" << handler->config.zenoh_topic
+                      << "': low_latency needs forwarding_worker, using the shared workers" << std::endl;
+            busy_poll = false;
+        }
+        handler->forward_id = executor_->addStream(pinned, busy_poll);
+        if (pinned >= 0 && pinned < static_cast<int>(executor_->workerCount())) {
+            std::cout << "[ReceiverBridge] Stream '" << handler->config.zenoh_topic << "' pinned to forwarding worker "
+                      << pinned << " (" << describePlacement(executor_->placement(pinned)) << ")"
+                      << (busy_poll ? ", busy polling" : "") << std::endl;
+        }
+    }
+    
+    if (!executor_->start()) {
+        std::cerr << "[ReceiverBridge] Failed to start forwarding workers, forwarding on the Zenoh callback" << std::endl;
+        for (auto& handler : handlers_) {
+            handler->forward_id = -1;
+        }
+        executor_.reset();
+        return;
+    }
+    std::cout << "[ReceiverBridge] " << executor_->workerCount() << " forwarding workers started" << std::endl;
+}
+
+bool ReceiverBridge::declareStream(StreamHandler& handler, zenoh::Session& session) {
+    const auto& config = handler.config;
+    
     try {
         auto on_sample = [this, &handler](const zenoh::Sample& sample) {
-            this->onDataReceived(handler.config, sample);
+            this->onDataReceived(handler, sample);
         };
         
         auto on_drop = []() {
             std::cout << "[ReceiverBridge] Subscriber dropped" << std::endl;
         };
         
-        handler.subscriber = std::make_unique<zenoh::Subscriber<void>>(
-            session_.declare_subscriber(config.zenoh_topic, on_sample, on_drop)
-        );
+        // Replacing the subscriber undeclares the one bound to the previous session
+        if (config.recoverable) {
+            declareRecoverable(handler, session, on_sample, on_drop);
+        } else if (config.ingest != IngestMode::CALLBACK) {
+            // Samples left in the old channel go out before the new one takes over
+            std::lock_guard<std::mutex> lock(handler.pull_mutex);
+            if (handler.ring_subscriber) {
+                while (drainChannel(handler, handler.ring_subscriber->handler()) == config.ingest_batch) {
+                }
+            } else if (handler.fifo_subscriber) {
+                while (drainChannel(handler, handler.fifo_subscriber->handler()) == config.ingest_batch) {
+                }
+            }
+            size_t capacity = std::max<size_t>(config.ingest_capacity, 1);
+            if (config.ingest == IngestMode::RING) {
+                handler.ring_subscriber.reset();
+                handler.ring_subscriber = std::make_unique<zenoh::Subscriber<zenoh::channels::RingHandler<zenoh::Sample>>>(
+                    session.declare_subscriber(config.zenoh_topic, zenoh::channels::RingChannel(capacity))
+                );
+            } else {
+                handler.fifo_subscriber.reset();
+                handler.fifo_subscriber = std::make_unique<zenoh::Subscriber<zenoh::channels::FifoHandler<zenoh::Sample>>>(
+                    session.declare_subscriber(config.zenoh_topic, zenoh::channels::FifoChannel(capacity))
+                );
+            }
+        } else {
+            handler.subscriber = std::make_unique<zenoh::Subscriber<void>>(
+                session.declare_subscriber(config.zenoh_topic, on_sample, on_drop)
+            );
+        }
         
         std::cout << "[ReceiverBridge] Subscribed to: " << config.zenoh_topic << std::endl;
         
+        if (handler.cache && config.cache_queryable) {
+            auto on_query = [this, &handler](const zenoh::Query& query) {
+                this->onCacheQuery(handler, query);
+            };
+            handler.queryable = std::make_unique<zenoh::Queryable<void>>(
+                session.declare_queryable(config.zenoh_topic, on_query, []() {})
+            );
+        }
+        
+        // Upstream can watch "<prefix>/**" to see which streams this bridge consumes
+        if (!config_.liveliness_prefix.empty()) {
+            handler.token.reset();
+            handler.token = std::make_unique<zenoh::LivelinessToken>(
+                session.liveliness_declare_token(zenoh::KeyExpr(config_.liveliness_prefix + "/" + config.zenoh_topic))
+            );
+        }
+        
     } catch (const std::exception& e) {
         std::cerr << "[ReceiverBridge] Failed to create subscriber: " << e.what() << std::endl;
-        closeStream(handler);
         return false;
     }
     
     return true;
 }
 
-void ReceiverBridge::closeStream(StreamHandler& handler) {
-    handler.subscriber.reset();
+template <class OnSample, class OnDrop>
+void ReceiverBridge::declareRecoverable(StreamHandler& handler, zenoh::Session& session,
+                                        OnSample& on_sample, OnDrop& on_drop) {
+    const auto& config = handler.config;
     
-    if (handler.udp_socket >= 0) {
-        close(handler.udp_socket);
-        handler.udp_socket = -1;
+    // Gaps are filled from the publisher's cache, the last sample of a burst through heartbeats or polling
+    zenoh::ext::SessionExt::AdvancedSubscriberOptions options;
+    options.recovery.emplace();
+    if (config.recovery_query_period_ms > 0) {
+        zenoh::ext::SessionExt::AdvancedSubscriberOptions::RecoveryOptions::PeriodicQueriesOptions periodic;
+        periodic.period_ms = static_cast<uint64_t>(config.recovery_query_period_ms);
+        options.recovery->last_sample_miss_detection = periodic;
+    } else {
+        options.recovery->last_sample_miss_detection =
+            zenoh::ext::SessionExt::AdvancedSubscriberOptions::RecoveryOptions::Heartbeat{};
     }
+    if (config.recovery_history > 0) {
+        options.history.emplace();
+        options.history->detect_late_publishers = true;
+        options.history->max_samples = config.recovery_history;
+    }
+    options.query_timeout_ms = static_cast<uint64_t>(std::max(config.recovery_query_timeout_ms, 0));
     
-    // TODO: Close gRPC resources
+    handler.subscriber.reset();
+    handler.advanced_subscriber = std::make_unique<zenoh::ext::AdvancedSubscriber<void>>(
+        session.ext().declare_advanced_subscriber(config.zenoh_topic, on_sample, on_drop, std::move(options))
+    );
+    
+    // Reported once the publisher's cache no longer holds the missing samples
+    StreamHandler* stream = &handler;
+    handler.advanced_subscriber->declare_background_sample_miss_listener(
+        [stream](const zenoh::ext::Miss& miss) {
+            stream->unrecovered += miss.nb;
+            std::cerr << "[ReceiverBridge] Stream '" << stream->config.zenoh_topic << "': " << miss.nb
+                      << " sample(s) could not be recovered" << std::endl;
+        },
+        []() {});
 }
 
-void ReceiverBridge::onDataReceived(const StreamConfig& config, const zenoh::Sample& sample) {
-    // Get payload as vector directly
-    const auto& payload = sample.get_payload();
-    auto bytes = payload.as_vector();
-    
-    std::cout << "[ReceiverBridge] Received data on '" << config.zenoh_topic 
-              << "': " << bytes.size() << " bytes" << std::endl;
-    
-    // Find handler for this topic
-    for (auto& handler : handlers_) {
-        if (handler->config.zenoh_topic == config.zenoh_topic) {
-            if (!forwardData(*handler, bytes.data(), bytes.size())) {
-                std::cerr << "[ReceiverBridge] Failed to forward data" << std::endl;
-            }
-            break;
+void ReceiverBridge::undeclareStream(StreamHandler& handler) {
+    handler.subscriber.reset();
+    handler.advanced_subscriber.reset();
+    if (handler.config.ingest != IngestMode::CALLBACK) {
+        // Like queued tasks, samples already in the channel are forwarded
+        size_t rounds = handler.config.ingest_capacity / handler.config.ingest_batch + 1;
+        while (rounds-- > 0 && drainStream(handler) == handler.config.ingest_batch) {
         }
+        std::lock_guard<std::mutex> lock(handler.pull_mutex);
+        handler.ring_subscriber.reset();
+        handler.fifo_subscriber.reset();
     }
+    handler.queryable.reset();
+    handler.token.reset();
 }
 
-bool ReceiverBridge::forwardData(StreamHandler& handler, const uint8_t* data, size_t len) {
-    switch (handler.config.protocol) {
-        case ProtocolType::UDP:
-            return forwardViaUDP(handler, data, len);
-        case ProtocolType::GRPC:
-            return forwardViaGRPC(handler, data, len);
-        default:
-            std::cerr << "[ReceiverBridge] Unknown protocol type" << std::endl;
-            return false;
+void ReceiverBridge::redeclareStreams(zenoh::Session& session) {
+    for (auto& handler : handlers_) {
+        std::lock_guard<std::mutex> lock(handler->activation_mutex);
+        if (handler->config.lazy && !handler->consumer_active) {
+            continue;
+        }
+        handler->declared = declareStream(*handler, session);
     }
 }
 
-bool ReceiverBridge::forwardViaUDP(StreamHandler& handler, const uint8_t* data, size_t len) {
-    if (handler.udp_socket < 0) {
-        std::cerr << "[ReceiverBridge] UDP socket not initialized" << std::endl;
+bool ReceiverBridge::declareService(ServiceHandler& service, zenoh::Session& session) {
+    try {
+        auto on_query = [this, &service](const zenoh::Query& query) {
+            this->onServiceQuery(service, query);
+        };
+        // Replacing the queryable undeclares the one bound to the previous session
+        service.queryable = std::make_unique<zenoh::Queryable<void>>(
+            session.declare_queryable(service.config.zenoh_key, on_query, []() {})
+        );
+        std::cout << "[ReceiverBridge] Serving queries on: " << service.config.zenoh_key
+                  << " -> " << service.client->describe() << std::endl;
+    } catch (const std::exception& e) {
+        std::cerr << "[ReceiverBridge] Failed to create queryable: " << e.what() << std::endl;
         return false;
     }
+    return true;
+}
+
+void ReceiverBridge::redeclareServices(zenoh::Session& session) {
+    for (auto& service : services_) {
+        declareService(*service, session);
+    }
+}
+
+bool ReceiverBridge::declarePoll(PollHandler& poll, zenoh::Session& session) {
+    const auto& config = poll.config;
     
-    ssize_t sent = sendto(handler.udp_socket, data, len, 0,
-                         (struct sockaddr*)&handler.udp_addr, sizeof(handler.udp_addr));
-    
-    if (sent < 0) {
-        std::cerr << "[ReceiverBridge] Failed to send UDP data: " << strerror(errno) << std::endl;
-        return false;
+    zenoh::ConsolidationMode consolidation;
+    switch (config.consolidation) {
+        case PollConsolidation::AUTO: consolidation = Z_CONSOLIDATION_MODE_AUTO; break;
+        case PollConsolidation::NONE: consolidation = Z_CONSOLIDATION_MODE_NONE; break;
+        case PollConsolidation::MONOTONIC: consolidation = Z_CONSOLIDATION_MODE_MONOTONIC; break;
+        default: consolidation = Z_CONSOLIDATION_MODE_LATEST; break;
     }
     
-    if (static_cast<size_t>(sent) != len) {
-        std::cerr << "[ReceiverBridge] Partial UDP send: " << sent << "/" << len << " bytes" << std::endl;
+    try {
+        zenoh::Session::QuerierOptions options;
+        options.target = config.query_all ? Z_QUERY_TARGET_ALL : Z_QUERY_TARGET_BEST_MATCHING;
+        options.consolidation = zenoh::QueryConsolidation(consolidation);
+        options.timeout_ms = static_cast<uint64_t>(std::max(config.timeout_ms, 1));
+        // Replacing the querier undeclares the one bound to the previous session
+        poll.querier = std::make_unique<zenoh::Querier>(
+            session.declare_querier(zenoh::KeyExpr(config.zenoh_key), std::move(options))
+        );
+        std::cout << "[ReceiverBridge] Polling: " << poll.server->describe()
+                  << " -> " << config.zenoh_key << std::endl;
+    } catch (const std::exception& e) {
+        poll.querier.reset();
+        std::cerr << "[ReceiverBridge] Failed to create querier: " << e.what() << std::endl;
         return false;
     }
+    return true;
+}
+
+void ReceiverBridge::redeclarePolls(zenoh::Session& session) {
+    for (auto& poll : polls_) {
+        declarePoll(*poll, session);
+    }
+}
+
+bool ReceiverBridge::startPollQuery(PollHandler& poll, const std::string& parameters, uint64_t flight) {
+    bool sent = false;
+    supervisor_.withSession([&](zenoh::Session&) {
+        if (!poll.querier) {
+            return;
+        }
+        PollServer* server = poll.server.get();
+        auto on_reply = [server, flight](const zenoh::Reply& reply) {
+            if (reply.is_ok()) {
+                server->deliver(flight, PollReplyKind::SAMPLE, reply.get_ok().get_payload().as_vector());
+            } else {
+                server->deliver(flight, PollReplyKind::ERROR, reply.get_err().get_payload().as_vector());
+            }
+        };
+        // Dropped once the last reply arrived or the querier timeout passed
+        auto on_drop = [server, flight]() {
+            server->complete(flight);
+        };
+        try {
+            poll.querier->get(parameters, on_reply, on_drop);
+            sent = true;
+        } catch (const std::exception& e) {
+            poll.query_failures++;
+            std::cerr << "[ReceiverBridge] Failed to send query: " << e.what() << std::endl;
+        }
+    });
+    return sent;
+}
+
+void ReceiverBridge::activateStream(StreamHandler& handler) {
+    {
+        std::lock_guard<std::mutex> lock(handler.activation_mutex);
+        if (handler.consumer_active && handler.declared) {
+            return;
+        }
+        if (!handler.consumer_active) {
+            handler.consumer_active = true;
+            handler.activations++;
+            std::cout << "[ReceiverBridge] Consumer of '" << handler.config.zenoh_topic
+                      << "' registered, subscribing" << std::endl;
+        }
+    }
     
-    std::cout << "[ReceiverBridge] Forwarded " << sent << " bytes via UDP to " 
-              << handler.config.local_host << ":" << handler.config.local_port << std::endl;
+    // The reconnect path declares with the supervisor lock held, so it is taken first here too.
+    // Without a session the supervisor declares the stream once connected.
+    supervisor_.withSession([this, &handler](zenoh::Session& session) {
+        std::lock_guard<std::mutex> lock(handler.activation_mutex);
+        if (handler.consumer_active && !handler.declared) {
+            handler.declared = declareStream(handler, session);
+        }
+    });
+}
+
+void ReceiverBridge::expireConsumers() {
+    for (auto& handler : handlers_) {
+        if (!handler->config.lazy || handler->release_at_ns.load() > steadyNowNs()) {
+            continue;
+        }
+        
+        std::lock_guard<std::mutex> lock(handler->activation_mutex);
+        // Re-checked under the lock, a HELLO may have just renewed the consumer
+        if (!handler->consumer_active || handler->release_at_ns.load() > steadyNowNs()) {
+            continue;
+        }
+        handler->consumer_active = false;
+        handler->declared = false;
+        undeclareStream(*handler);
+        handler->deactivations++;
+        std::cout << "[ReceiverBridge] No consumer of '" << handler->config.zenoh_topic
+                  << "', unsubscribed" << std::endl;
+    }
+}
+
+void ReceiverBridge::primeStream(StreamHandler& handler) {
+    for (const auto& sample : handler.cache->snapshot()) {
+        ByteView data;
+        if (!handler.codec->decompress(zenoh::Encoding(sample.encoding),
+                                       {sample.payload.data(), sample.payload.size()}, data)) {
+            continue;
+        }
+        if (handler.config.integrity != IntegrityCheck::NONE) {
+            size_t body_size;
+            if (!Integrity::verify(handler.config.integrity, data, body_size)) {
+                handler.integrity_failures++;
+                continue;
+            }
+            if (handler.config.integrity_strip) {
+                data.size = body_size;
+            }
+        }
+        PayloadBuffer converted;
+        if (handler.transcoder) {
+            if (!handler.transcoder->transcode(data, converted)) {
+                handler.transcode_failures++;
+                continue;
+            }
+            data = converted.view();
+        }
+        if (forwardData(handler, data.data, data.size)) {
+            handler.cache_primes++;
+        }
+    }
+}
+
+void ReceiverBridge::flushStream(StreamHandler& handler) {
+    handler.conflater->flush([this, &handler](const ByteView* items, size_t count) {
+        return forwardBatch(handler, items, count);
+    });
+}
+
+void ReceiverBridge::onConsumerMessage(ConsumerMessage message, const std::string& topic) {
+    for (auto& handler : handlers_) {
+        if (handler->config.zenoh_topic != topic) {
+            continue;
+        }
+        
+        // Any message but BYE renews the consumer, the subscription outlives it by the grace period
+        if (handler->config.lazy) {
+            int64_t grace_ns = static_cast<int64_t>(config_.consumer_grace_ms) * 1000000;
+            if (message == ConsumerMessage::BYE) {
+                handler->release_at_ns = steadyNowNs() + grace_ns;
+            } else {
+                handler->release_at_ns = steadyNowNs() + static_cast<int64_t>(config_.consumer_timeout_ms) * 1000000 + grace_ns;
+                activateStream(*handler);
+            }
+        }
+        
+        switch (message) {
+            case ConsumerMessage::HELLO:
+                if (handler->cache) {
+                    primeStream(*handler);
+                }
+                break;
+            case ConsumerMessage::READY:
+                if (handler->conflater && handler->config.conflation_consumer_paced) {
+                    handler->conflater->grant();
+                    flushStream(*handler);
+                }
+                break;
+            case ConsumerMessage::ALIVE:
+            case ConsumerMessage::BYE:
+                break;
+        }
+    }
+}
+
+void ReceiverBridge::onCacheQuery(StreamHandler& handler, const zenoh::Query& query) {
+    try {
+        for (const auto& sample : handler.cache->snapshot()) {
+            zenoh::KeyExpr key(sample.key);
+            if (!key.intersects(query.get_keyexpr())) {
+                continue;
+            }
+            
+            zenoh::Query::ReplyOptions options;
+            options.encoding = zenoh::Encoding(sample.encoding);
+            query.reply(key, zenoh::Bytes(sample.payload), std::move(options));
+        }
+        handler.cache_queries++;
+    } catch (const std::exception& e) {
+        std::cerr << "[ReceiverBridge] Failed to answer query: " << e.what() << std::endl;
+    }
+}
+
+void ReceiverBridge::onServiceQuery(ServiceHandler& service, const zenoh::Query& query) {
+    service.queries++;
+    
+    std::vector<uint8_t> request;
+    auto payload = query.get_payload();
+    if (payload) {
+        request = payload->get().as_vector();
+    }
+    
+    // Replies need a concrete key: the service's own, or the query's under a wildcard service key
+    std::string reply_key = service.config.zenoh_key.find('*') == std::string::npos
+        ? service.config.zenoh_key
+        : std::string(query.get_keyexpr().as_string_view());
+    
+    // The clone keeps the query open until the service answers, dropping it finalizes the query
+    auto pending = std::make_shared<zenoh::Query>(query.clone());
+    ServiceHandler* handler = &service;
+    auto on_reply = [handler, pending, reply_key](ServiceResult result, const uint8_t* data, size_t len) {
+        try {
+            if (result == ServiceResult::OK) {
+                pending->reply(zenoh::KeyExpr(reply_key), zenoh::Bytes(std::vector<uint8_t>(data, data + len)));
+            } else {
+                pending->reply_err(zenoh::Bytes(serviceResultName(result)));
+            }
+        } catch (const std::exception& e) {
+            handler->reply_failures++;
+            std::cerr << "[ReceiverBridge] Failed to answer query: " << e.what() << std::endl;
+        }
+    };
+    
+    if (!service.client->submit(request.data(), request.size(), std::move(on_reply))) {
+        try {
+            query.reply_err(zenoh::Bytes("busy"));
+        } catch (const std::exception& e) {
+            service.reply_failures++;
+            std::cerr << "[ReceiverBridge] Failed to answer query: " << e.what() << std::endl;
+        }
+    }
+}
+
+void ReceiverBridge::retire() {
+    if (retired_.exchange(true)) {
+        return;
+    }
+    
+    // Waits for an in-flight failover, so no subscriber is re-declared below
+    supervisor_.setReconnectCallback(nullptr);
+    
+    // No lazy stream is activated any more
+    if (registry_) {
+        registry_->stop();
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(std::max(config_.drain_timeout_ms, 0));
+    
+    // Intake stops first: no samples arrive once the subscribers are gone, pull channels are drained on the way
+    for (auto& handler : handlers_) {
+        std::lock_guard<std::mutex> lock(handler->activation_mutex);
+        handler->declared = false;
+        undeclareStream(*handler);
+    }
+    
+    // No new queries either, pending ones are still answered
+    for (auto& service : services_) {
+        service->queryable.reset();
+    }
+    
+    // Polls still in flight are dropped, late replies find no flight
+    for (auto& poll : polls_) {
+        poll->server->stop();
+        poll->querier.reset();
+    }
+    
+    // Then what is queued goes out, conflated streams last as the executor does not feed them
+    drained_ = !executor_ || executor_->drain(deadline);
+    for (auto& handler : handlers_) {
+        if (handler->conflater) {
+            flushStream(*handler);
+        }
+    }
+    
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    if (drained_) {
+        std::cout << "[ReceiverBridge] Drained in " << elapsed.count() << " ms" << std::endl;
+    } else {
+        std::cerr << "[ReceiverBridge] Drain timed out after " << config_.drain_timeout_ms
+                  << " ms, dropping queued samples" << std::endl;
+    }
+}
+
+HandoffOffer ReceiverBridge::offerHandoff() {
+    HandoffOffer offer;
+    offer.sockets = destinations_.handoffSockets();
+    if (registry_) {
+        offer.sockets["registration"] = {registry_->socket()};
+    }
+    for (const auto& poll : polls_) {
+        offer.sockets["poll:" + poll->server->describe()] = {poll->server->listener()};
+    }
+    
+    int64_t now = steadyNowNs();
+    for (const auto& handler : handlers_) {
+        HandoffStream stream;
+        stream.topic = handler->config.zenoh_topic;
+        if (handler->config.lazy) {
+            std::lock_guard<std::mutex> lock(handler->activation_mutex);
+            if (handler->consumer_active) {
+                stream.consumer_ns = std::max<int64_t>(handler->release_at_ns.load() - now, 1);
+            }
+        }
+        if (handler->cache) {
+            stream.samples = handler->cache->snapshot();
+        }
+        if (stream.consumer_ns > 0 || !stream.samples.empty()) {
+            offer.streams.push_back(std::move(stream));
+        }
+    }
+    return offer;
+}
+
+void ReceiverBridge::handOver() {
+    // The successor accepts on the poll listeners from now on
+    for (auto& poll : polls_) {
+        poll->server->handOver();
+    }
+    retire();
+    
+    uint64_t one = 1;
+    if (write(shutdown_fd_, &one, sizeof(one)) < 0) {
+        std::cerr << "[ReceiverBridge] Failed to signal shutdown: " << strerror(errno) << std::endl;
+    }
+}
+
+void ReceiverBridge::adoptHandoff() {
+    int64_t now = steadyNowNs();
+    for (const auto& stream : handoff_->streams()) {
+        for (auto& handler : handlers_) {
+            if (handler->config.zenoh_topic != stream.topic) {
+                continue;
+            }
+            if (handler->cache) {
+                for (const auto& sample : stream.samples) {
+                    handler->cache->store(sample.key, sample.encoding, sample.payload.data(),
+                                          sample.payload.size(), sample.receive_ns);
+                }
+            }
+            // Subscribed right away, its consumer registered with the previous bridge
+            if (handler->config.lazy && stream.consumer_ns > 0) {
+                handler->consumer_active = true;
+                handler->release_at_ns = now + stream.consumer_ns;
+                handler->activations++;
+            }
+        }
+    }
+}
+
+std::vector<int> ReceiverBridge::inheritedSockets(const std::string& name) {
+    return handoff_ ? handoff_->takeSockets(name) : std::vector<int>();
+}
+
+int ReceiverBridge::inheritedSocket(const std::string& name) {
+    auto fds = inheritedSockets(name);
+    for (size_t i = 1; i < fds.size(); ++i) {
+        close(fds[i]);
+    }
+    return fds.empty() ? -1 : fds[0];
+}
+
+void ReceiverBridge::closeStream(StreamHandler& handler) {
+    handler.subscriber.reset();
+    handler.advanced_subscriber.reset();
+    handler.ring_subscriber.reset();
+    handler.fifo_subscriber.reset();
+    handler.queryable.reset();
+    handler.token.reset();
+    
+    handler.targets.clear();
+    
+    // TODO: Close gRPC resources
+}
+
+void ReceiverBridge::onDataReceived(StreamHandler& handler, const zenoh::Sample& sample) {
+    PayloadBuffer bytes;
+    if (!receiveSample(handler, sample, bytes)) {
+        return;
+    }
+    
+    CompressionType codec = PayloadCodec::fromEncoding(sample.get_encoding());
+    
+    // Conflated streams only forward on flush
+    if (handler.conflater) {
+        PayloadBuffer data;
+        if (!handler.codec->decompress(codec, bytes, data)) {
+            std::cerr << "[ReceiverBridge] Failed to decompress data" << std::endl;
+            handler.decompress_failures++;
+            return;
+        }
+        if (!verifyPayload(handler, data) || !trackPayloadSequence(handler, data) || !prepareSample(handler, data)) {
+            return;
+        }
+        if (handler.conflater->store(sample.get_keyexpr().as_string_view(), data)) {
+            flushStream(handler);
+        }
+        return;
+    }
+    
+    // Decompression and sends run on a forwarding worker, one at a time per stream
+    if (handler.forward_id >= 0) {
+        ForwardTask task;
+        task.stream = &handler;
+        task.payload = bytes;
+        task.codec = codec;
+        if (executor_->post(handler.forward_id, std::move(task))) {
+            return;
+        }
+    }
+    
+    forwardSample(handler, codec, bytes);
+}
+
+bool ReceiverBridge::receiveSample(StreamHandler& handler, const zenoh::Sample& sample, PayloadBuffer& bytes) {
+    // Copy the payload into a pooled buffer, shared by every later stage
+    const auto& payload = sample.get_payload();
+    bytes = PayloadBuffer::allocate(payload.size());
+    payload.reader().read(bytes.data(), bytes.size());
+    
+    // Capture and cache the sample as received, before any transform
+    if (capture_ || handler.cache) {
+        auto receive_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        auto key = sample.get_keyexpr().as_string_view();
+        auto encoding = encodingString(sample.get_encoding());
+        
+        if (capture_) {
+            capture_->append(key, encoding, bytes.data(), bytes.size(), receive_ns);
+        }
+        if (handler.cache) {
+            handler.cache->store(key, encoding, bytes.data(), bytes.size(), receive_ns);
+        }
+    }
+    
+    // Sequence numbers are checked in arrival order, before any queueing
+    if (handler.sequence && handler.config.sequence_source == SequenceSource::SOURCE_INFO) {
+        auto source_info = sample.get_source_info();
+        if (source_info) {
+            auto id = source_info->get().id();
+            const auto& zid = id.id().bytes();
+            bool seen = !handler.sequence->observeWrapping(
+                SequenceTracker::publisherId(zid.data(), zid.size(), id.eid()), source_info->get().sn());
+            
+            // History fetched after a re-subscribe repeats samples already forwarded
+            if (seen && handler.config.recoverable) {
+                return false;
+            }
+        } else {
+            handler.unsequenced++;
+        }
+    }
+    
+    return true;
+}
+
+void ReceiverBridge::requestDrain(StreamHandler& handler) {
+    if (handler.forward_id >= 0) {
+        if (handler.drain_pending.exchange(true)) {
+            return;
+        }
+        ForwardTask task;
+        task.stream = &handler;
+        task.drain = true;
+        if (executor_->post(handler.forward_id, std::move(task))) {
+            return;
+        }
+        handler.drain_pending = false;
+    }
+    
+    // A full channel is emptied in a bounded number of batches
+    size_t rounds = handler.config.ingest_capacity / std::max<size_t>(handler.config.ingest_batch, 1) + 1;
+    while (rounds-- > 0 && drainStream(handler) == handler.config.ingest_batch) {
+    }
+}
+
+size_t ReceiverBridge::drainStream(StreamHandler& handler) {
+    // Cleared first: samples arriving during this drain get a drain of their own
+    handler.drain_pending = false;
+    
+    std::lock_guard<std::mutex> lock(handler.pull_mutex);
+    if (handler.ring_subscriber) {
+        return drainChannel(handler, handler.ring_subscriber->handler());
+    }
+    if (handler.fifo_subscriber) {
+        return drainChannel(handler, handler.fifo_subscriber->handler());
+    }
+    return 0;
+}
+
+template <class Channel>
+size_t ReceiverBridge::drainChannel(StreamHandler& handler, const Channel& channel) {
+    size_t limit = std::max<size_t>(handler.config.ingest_batch, 1);
+    size_t taken = 0;
+    
+    while (taken < limit) {
+        auto result = channel.try_recv();
+        if (!std::holds_alternative<zenoh::Sample>(result)) {
+            break;
+        }
+        taken++;
+        
+        const auto& sample = std::get<zenoh::Sample>(result);
+        PayloadBuffer bytes;
+        if (!receiveSample(handler, sample, bytes)) {
+            continue;
+        }
+        PayloadBuffer data;
+        if (!handler.codec->decompress(PayloadCodec::fromEncoding(sample.get_encoding()), bytes, data)) {
+            std::cerr << "[ReceiverBridge] Failed to decompress data" << std::endl;
+            handler.decompress_failures++;
+            continue;
+        }
+        if (verifyPayload(handler, data) && trackPayloadSequence(handler, data) && prepareSample(handler, data)) {
+            handler.pull_batch.push_back(std::move(data));
+        }
+    }
+    
+    // The whole batch goes out in one sendmmsg/GSO call per target (or through io_uring)
+    if (!handler.pull_batch.empty()) {
+        handler.pull_views.clear();
+        for (const auto& data : handler.pull_batch) {
+            handler.pull_views.push_back({data.data(), data.size()});
+        }
+        forwardBatch(handler, handler.pull_views.data(), handler.pull_views.size());
+        handler.pull_batch.clear();
+    }
+    
+    if (taken > 0) {
+        handler.drains++;
+        handler.drained += taken;
+        if (taken == limit) {
+            handler.full_drains++;
+        }
+    }
+    return taken;
+}
+
+bool ReceiverBridge::trackPayloadSequence(StreamHandler& handler, const PayloadBuffer& data) {
+    if (!handler.sequence || handler.config.sequence_source != SequenceSource::PAYLOAD_HEADER) {
+        return true;
+    }
+    
+    SequenceHeader header;
+    if (!SequenceTracker::readHeader(data.data(), data.size(), header)) {
+        handler.unsequenced++;
+        return true;
+    }
+    return handler.sequence->observe(header.publisher, header.sequence) || !handler.config.recoverable;
+}
+
+bool ReceiverBridge::verifyPayload(StreamHandler& handler, PayloadBuffer& data) {
+    if (handler.config.integrity == IntegrityCheck::NONE) {
+        return true;
+    }
+    
+    size_t body_size;
+    if (!Integrity::verify(handler.config.integrity, data.view(), body_size)) {
+        handler.integrity_failures++;
+        return false;
+    }
+    handler.verified++;
+    
+    // Only this sample references the buffer by now (capture and cache copied it), shrinking is safe
+    if (handler.config.integrity_strip) {
+        data.resize(body_size);
+    }
+    return true;
+}
+
+bool ReceiverBridge::prepareSample(StreamHandler& handler, PayloadBuffer& data) {
+    ContentFilter* filter = handler.filter.get();
+    if (filter && !filter->admitPayload(data.view())) {
+        return false;
+    }
+    
+    // Decoded once, for rules on schema fields and for the output format
+    if (handler.transcoder) {
+        FieldValue values[kMaxSchemaFields];
+        if (!handler.transcoder->decode(data.view(), values)) {
+            handler.transcode_failures++;
+            return false;
+        }
+        if (filter && !filter->admitFields(values)) {
+            return false;
+        }
+        PayloadBuffer converted;
+        if (!handler.transcoder->encode(values, converted)) {
+            handler.transcode_failures++;
+            return false;
+        }
+        data = std::move(converted);
+    }
+    
+    if (filter) {
+        filter->commit();
+    }
+    return true;
+}
+
+void ReceiverBridge::forwardSample(StreamHandler& handler, CompressionType codec, const PayloadBuffer& bytes) {
+    // Undo sender-side compression, unmarked payloads pass through
+    PayloadBuffer data;
+    if (!handler.codec->decompress(codec, bytes, data)) {
+        std::cerr << "[ReceiverBridge] Failed to decompress data" << std::endl;
+        handler.decompress_failures++;
+        return;
+    }
+    
+    // One stream runs on one thread at a time, so payload sequence numbers keep arrival order
+    if (!verifyPayload(handler, data) || !trackPayloadSequence(handler, data) || !prepareSample(handler, data)) {
+        return;
+    }
+    
+    // All targets share the buffer, zero-copy sends keep it until the kernel is done
+    if (!forwardData(handler, data.data(), data.size(), data)) {
+        std::cerr << "[ReceiverBridge] Failed to forward data" << std::endl;
+        handler.forward_failures++;
+    }
+}
+
+void ReceiverBridge::printStats(std::ostream& os) const {
+    auto session_stats = supervisor_.getStats();
+    
+    os << "[Stats] Session: " << (session_stats.connected ? "connected" : "disconnected")
+       << " | Disconnects: " << session_stats.disconnects
+       << " | Reconnects: " << session_stats.reconnects
+       << " (failovers: " << session_stats.failovers << ")"
+       << " | Downtime: " << session_stats.total_downtime_ms << " ms"
+       << " (last: " << session_stats.last_downtime_ms << " ms)" << std::endl;
+    
+    for (const auto& handler : handlers_) {
+        if (handler->cache) {
+            os << "[Stats] Cache '" << handler->config.zenoh_topic << "': "
+               << "Primed: " << handler->cache_primes.load()
+               << " | Queries: " << handler->cache_queries.load() << std::endl;
+        }
+    }
+    
+    // Loss upstream (sequence gaps) next to loss at the bridge (decompression, transcoding and egress)
+    for (const auto& handler : handlers_) {
+        if (!handler->sequence && !handler->config.recoverable &&
+            handler->decompress_failures == 0 && handler->transcode_failures == 0 &&
+            handler->forward_failures == 0) {
+            continue;
+        }
+        os << "[Stats] Stream '" << handler->config.zenoh_topic << "': ";
+        if (handler->sequence) {
+            auto sequence_stats = handler->sequence->getStats();
+            os << "Sequenced: " << sequence_stats.received
+               << " from " << sequence_stats.publishers << " publishers"
+               << " | Lost: " << sequence_stats.lost
+               << " (" << std::round(sequence_stats.lossRate() * 10000.0) / 100.0 << "%)"
+               << " | Reordered: " << sequence_stats.reordered
+               << " | Duplicates: " << sequence_stats.duplicates
+               << " | Stale: " << sequence_stats.stale
+               << " | Restarts: " << sequence_stats.resets
+               << " | Unsequenced: " << handler->unsequenced.load() << " | ";
+        }
+        if (handler->config.recoverable) {
+            os << "Unrecovered: " << handler->unrecovered.load() << " | ";
+        }
+        os << "Decompress failures: " << handler->decompress_failures.load()
+           << " | Transcode failures: " << handler->transcode_failures.load()
+           << " | Forward failures: " << handler->forward_failures.load() << std::endl;
+    }
+    
+    for (const auto& handler : handlers_) {
+        if (handler->config.integrity != IntegrityCheck::NONE) {
+            os << "[Stats] Integrity '" << handler->config.zenoh_topic << "': "
+               << "Verified: " << handler->verified.load()
+               << " | Mismatches: " << handler->integrity_failures.load() << std::endl;
+        }
+    }
+    
+    for (const auto& handler : handlers_) {
+        if (handler->filter) {
+            auto filter_stats = handler->filter->getStats();
+            os << "[Stats] Filter '" << handler->config.zenoh_topic << "': "
+               << "Passed: " << filter_stats.passed
+               << " | Filtered: " << filter_stats.filtered
+               << " | Duplicates: " << filter_stats.duplicates << std::endl;
+        }
+    }
+    
+    for (const auto& handler : handlers_) {
+        if (handler->conflater) {
+            auto conflation_stats = handler->conflater->getStats();
+            os << "[Stats] Conflation '" << handler->config.zenoh_topic << "': "
+               << "Received: " << conflation_stats.stored
+               << " | Conflated: " << conflation_stats.conflated
+               << " | Forwarded: " << conflation_stats.forwarded << std::endl;
+        }
+    }
+    
+    for (const auto& handler : handlers_) {
+        if (handler->config.ingest != IngestMode::CALLBACK) {
+            uint64_t drains = handler->drains.load();
+            uint64_t drained = handler->drained.load();
+            os << "[Stats] Pull '" << handler->config.zenoh_topic << "': "
+               << "Drained: " << drained << " in " << drains << " batches"
+               << " (avg " << (drains > 0 ? drained / drains : 0)
+               << ", full: " << handler->full_drains.load() << ")" << std::endl;
+        }
+        if (handler->config.lazy) {
+            uint64_t activations = handler->activations.load();
+            uint64_t deactivations = handler->deactivations.load();
+            os << "[Stats] Lazy '" << handler->config.zenoh_topic << "': "
+               << (activations > deactivations ? "subscribed" : "idle")
+               << ", Activations: " << activations
+               << ", Deactivations: " << deactivations << std::endl;
+        }
+    }
+    
+    for (const auto& handler : handlers_) {
+        for (const auto& target : handler->targets) {
+            if (handler->targets.size() == 1 && target->failed == 0 && target->skipped == 0 &&
+                target->shed == 0 && target->throttled == 0) {
+                continue;
+            }
+            os << "[Stats] Target '" << handler->config.zenoh_topic << "' -> "
+               << (target->config.protocol == ProtocolType::UDP ? "udp://" : "grpc://")
+               << target->config.local_host << ":" << target->config.local_port << ": "
+               << "Sent: " << target->sent.load()
+               << " | Failed: " << target->failed.load()
+               << " | Skipped: " << target->skipped.load()
+               << " | Shed: " << target->shed.load()
+               << " (throttled: " << target->throttled.load() << ")" << std::endl;
+        }
+    }
+    
+    for (const auto& service : services_) {
+        auto service_stats = service->client->getStats();
+        os << "[Stats] Service '" << service->config.zenoh_key << "' -> " << service->client->describe() << ": "
+           << "Queries: " << service->queries.load()
+           << " | Answered: " << service_stats.responses
+           << " | Timeouts: " << service_stats.timeouts
+           << " | Disconnected: " << service_stats.disconnected
+           << " | Busy: " << service_stats.rejected
+           << " | Late: " << service_stats.late
+           << " | Outstanding: " << service_stats.outstanding
+           << " | Reply failures: " << service->reply_failures.load() << std::endl;
+    }
+    for (const auto& poll : polls_) {
+        auto poll_stats = poll->server->getStats();
+        os << "[Stats] Poll " << poll->server->describe() << " -> '" << poll->config.zenoh_key << "': "
+           << "Polls: " << poll_stats.requests
+           << " | Queries: " << poll_stats.queries
+           << " | Coalesced: " << poll_stats.coalesced
+           << " | Replies: " << poll_stats.replies
+           << " | Unavailable: " << poll_stats.unavailable
+           << " | Send failures: " << poll_stats.send_failures
+           << " | Query failures: " << poll->query_failures.load() << std::endl;
+    }
+    
+    for (const auto& destination : destinations_.all()) {
+        auto udp_stats = destination->getStats();
+        if (udp_stats.gso_batches > 0 || udp_stats.zerocopy_sends > 0 || udp_stats.zerocopy_fallbacks > 0) {
+            os << "[Stats] UDP " << destination->name() << ": "
+               << "GSO: " << udp_stats.gso_datagrams << " in " << udp_stats.gso_batches << " sends"
+               << " | Zero-copy: " << udp_stats.zerocopy_sends
+               << " (copied: " << udp_stats.zerocopy_copied
+               << ", fallback: " << udp_stats.zerocopy_fallbacks << ")" << std::endl;
+        }
+    }
+    
+    if (backpressure_) {
+        for (const auto& destination : destinations_.all()) {
+            auto pressure = destination->getPressure();
+            os << "[Stats] Backpressure " << destination->name() << ": "
+               << (pressure.level == PressureLevel::CRITICAL ? "critical"
+                   : pressure.level == PressureLevel::HIGH ? "high" : "normal")
+               << " | Send queue: " << pressure.send.queued / 1024 << "/" << pressure.send.capacity / 1024 << " KiB";
+            if (pressure.consumer_found) {
+                os << " | Consumer queue: " << pressure.receive.queued / 1024 << "/"
+                   << pressure.receive.capacity / 1024 << " KiB"
+                   << " | Consumer drops: " << pressure.consumer_drops;
+            }
+            os << std::endl;
+        }
+    }
+    
+    for (size_t i = 0; i < egress_.size(); ++i) {
+        auto egress_stats = egress_[i]->getStats();
+        os << "[Stats] io_uring egress " << i << ": "
+           << "Sent: " << egress_stats.completed
+           << " | Failed: " << egress_stats.failed
+           << " | Zero-copy: " << egress_stats.zerocopy
+           << " | Fallback: " << egress_stats.rejected
+           << " | Batches: " << egress_stats.batches;
+        if (egress_stats.failed > 0) {
+            os << " (last error: " << strerror(egress_stats.last_error) << ")";
+        }
+        os << std::endl;
+    }
+    
+    if (executor_) {
+        auto executor_stats = executor_->getStats();
+        for (size_t i = 0; i < executor_stats.workers.size(); ++i) {
+            const auto& worker_stats = executor_stats.workers[i];
+            os << "[Stats] Worker " << i << " (" << describePlacement(executor_->placement(i))
+               << (worker_stats.busy_poll ? ", busy-poll" : "") << "): "
+               << "Forwarded: " << worker_stats.forwarded
+               << " | Stolen: " << worker_stats.steals
+               << " | Spinning: " << worker_stats.spin_time_ns / 1000000 << " ms";
+            if (!worker_stats.busy_poll) {
+                os << " (limit " << worker_stats.spin_ns / 1000 << " us)";
+            }
+            os << " | Parked: " << worker_stats.parks << "x, " << worker_stats.park_time_ns / 1000000 << " ms"
+               << " | Queue delay p99.9: " << worker_stats.p999_delay_ns / 1000.0 << " us"
+               << ", max: " << worker_stats.max_delay_ns / 1000.0 << " us" << std::endl;
+        }
+        os << "[Stats] Forwarding: Waits on full queue: " << executor_stats.waits << std::endl;
+    }
+    
+    for (const auto& thread : ThreadMonitor::instance().sample()) {
+        os << "[Stats] Thread '" << thread.name << "' (tid " << thread.tid << ", cpu " << thread.cpu;
+        if (thread.realtime_priority > 0) {
+            os << ", FIFO " << thread.realtime_priority;
+        }
+        os << "): CPU: " << std::round(thread.cpu_percent * 10.0) / 10.0 << "%"
+           << " | Preempted: " << thread.involuntary_switches << std::endl;
+    }
+    
+    auto pool_stats = BufferPool::instance().getStats();
+    os << "[Stats] Buffer pool: "
+       << "In use: " << pool_stats.in_use
+       << " | Allocations: " << pool_stats.allocations
+       << " (reused: " << pool_stats.cache_hits
+       << ", returned cross-thread: " << pool_stats.remote_frees << ")"
+       << " | Heap: " << pool_stats.heap
+       << " | Slabs: " << pool_stats.slab_bytes / (1024 * 1024) << " MiB"
+       << " (huge pages: " << pool_stats.huge_slabs << "/" << pool_stats.slabs << ")" << std::endl;
+    
+    if (capture_) {
+        auto capture_stats = capture_->getStats();
+        os << "[Stats] Capture: " << capture_stats.captured << " records"
+           << " | Dropped: " << capture_stats.dropped
+           << " | Segments: " << capture_stats.segments << std::endl;
+    }
+}
+
+bool ReceiverBridge::forwardData(StreamHandler& handler, const uint8_t* data, size_t len,
+                                 const PayloadBuffer& owner) {
+    // Targets are served in configuration order, the primary consumer first
+    bool all_sent = true;
+    for (auto& target : handler.targets) {
+        if (!forwardToTarget(handler, *target, data, len, owner)) {
+            all_sent = false;
+        }
+    }
+    return all_sent;
+}
+
+size_t ReceiverBridge::forwardBatch(StreamHandler& handler, const ByteView* items, size_t count) {
+    size_t most_sent = 0;
+    
+    for (auto& target_ptr : handler.targets) {
+        TargetHandler& target = *target_ptr;
+        size_t sent = 0;
+        
+        // The io_uring engine batches on its own, GSO/sendmmsg only help the sendto path
+        if (target.config.protocol != ProtocolType::UDP || target.egress || !target.destination) {
+            for (size_t i = 0; i < count; ++i) {
+                if (forwardToTarget(handler, target, items[i].data, items[i].size, PayloadBuffer())) {
+                    sent++;
+                }
+            }
+        } else if (isSuspended(target)) {
+            target.skipped += count;
+        } else if (!admit(target)) {
+            target.shed += count;
+        } else {
+            sent = target.destination->sender().sendBatch(items, count, target.nonblocking ? MSG_DONTWAIT : 0);
+            if (sent < count) {
+                std::cerr << "[ReceiverBridge] Failed to send UDP batch to " << target.destination->name()
+                          << ": " << sent << "/" << count << " datagrams: " << strerror(errno) << std::endl;
+            }
+            recordResult(handler, target, true, sent);
+            if (sent < count) {
+                recordResult(handler, target, false, count - sent);
+            }
+        }
+        
+        most_sent = std::max(most_sent, sent);
+    }
+    
+    return most_sent;
+}
+
+bool ReceiverBridge::forwardToTarget(StreamHandler& handler, TargetHandler& target, const uint8_t* data,
+                                     size_t len, const PayloadBuffer& owner) {
+    if (isSuspended(target)) {
+        target.skipped++;
+        return false;
+    }
+    if (!admit(target)) {
+        target.shed++;
+        return false;
+    }
+    
+    bool success;
+    switch (target.config.protocol) {
+        case ProtocolType::UDP:
+            success = forwardViaUDP(target, data, len, owner);
+            break;
+        case ProtocolType::GRPC:
+            success = forwardViaGRPC(target, data, len);
+            break;
+        default:
+            std::cerr << "[ReceiverBridge] Unknown protocol type" << std::endl;
+            success = false;
+            break;
+    }
+    
+    recordResult(handler, target, success);
+    return success;
+}
+
+bool ReceiverBridge::isSuspended(TargetHandler& target) const {
+    int64_t until = target.suspended_until_ns.load(std::memory_order_relaxed);
+    return until != 0 && steadyNowNs() < until;
+}
+
+bool ReceiverBridge::admit(TargetHandler& target) {
+    if (target.backpressure == BackpressureAction::NONE || !target.destination) {
+        return true;
+    }
+    
+    auto overloaded = [&target]() {
+        return static_cast<int>(target.destination->pressureLevel()) > target.backpressure_priority;
+    };
+    if (!overloaded()) {
+        return true;
+    }
+    
+    // Holding the forwarding thread lets the stream's queue, and then Zenoh, absorb the burst
+    if (target.backpressure == BackpressureAction::THROTTLE) {
+        target.throttled++;
+        int64_t deadline = steadyNowNs() + target.backpressure_max_wait_ns;
+        while (overloaded() && steadyNowNs() < deadline) {
+            std::this_thread::sleep_for(kThrottlePoll);
+        }
+        return !overloaded();
+    }
+    return false;
+}
+
+void ReceiverBridge::recordResult(StreamHandler& handler, TargetHandler& target, bool success, uint64_t count) {
+    if (count == 0) {
+        return;
+    }
+    
+    if (success) {
+        target.sent += count;
+        target.consecutive_failures.store(0, std::memory_order_relaxed);
+        return;
+    }
+    
+    target.failed += count;
+    if (target.consecutive_failures.fetch_add(static_cast<int>(count)) + static_cast<int>(count)
+            >= kTargetFailureLimit) {
+        // A consumer that keeps failing is skipped for a while so it cannot slow down the others.
+        // With no other working consumer there is nothing to protect, skipping would only lose samples.
+        target.consecutive_failures.store(0, std::memory_order_relaxed);
+        bool others_working = std::any_of(handler.targets.begin(), handler.targets.end(),
+            [&](const std::unique_ptr<TargetHandler>& other) {
+                return other.get() != &target && !isSuspended(*other);
+            });
+        if (!others_working) {
+            return;
+        }
+        target.suspended_until_ns.store(steadyNowNs() + kTargetSuspendNs, std::memory_order_relaxed);
+        std::cerr << "[ReceiverBridge] Suspending target " << target.config.local_host << ":"
+                  << target.config.local_port << " for " << kTargetSuspendNs / 1000000
+                  << " ms after repeated failures" << std::endl;
+    }
+}
+
+bool ReceiverBridge::forwardViaUDP(TargetHandler& target, const uint8_t* data, size_t len,
+                                   const PayloadBuffer& owner) {
+    if (!target.destination) {
+        std::cerr << "[ReceiverBridge] UDP destination not initialized" << std::endl;
+        return false;
+    }
+    
+    // Queued for the io_uring engine, a full ring falls back to a direct send
+    if (target.egress && target.egress->send(target.egress_handles[target.destination->shardIndex()],
+                                             target.destination->address(), data, len)) {
+        return true;
+    }
+    
+    UdpSender& sender = target.destination->sender();
+    if (owner && sender.sendZeroCopy(data, len, owner)) {
+        return true;
+    }
+    
+    ssize_t sent = sender.send(data, len, target.nonblocking ? MSG_DONTWAIT : 0);
+    
+    if (sent < 0) {
+        std::cerr << "[ReceiverBridge] Failed to send UDP data: " << strerror(errno) << std::endl;
+        return false;
+    }
+    
+    if (static_cast<size_t>(sent) != len) {
+        std::cerr << "[ReceiverBridge] Partial UDP send: " << sent << "/" << len << " bytes" << std::endl;
+        return false;
+    }
     return true;
 }
 
-bool ReceiverBridge::forwardViaGRPC(StreamHandler& handler, const uint8_t* data, size_t len) {
+bool ReceiverBridge::forwardViaGRPC(TargetHandler& target, const uint8_t* data, size_t len) {
     // TODO: Implement gRPC forwarding
     std::cerr << "[ReceiverBridge] gRPC forwarding not yet implemented" << std::endl;
     std::cout << "[ReceiverBridge] Would send " << len << " bytes to gRPC service: " 
-              << handler.config.grpc_service << "/" << handler.config.grpc_method << std::endl;
+              << target.config.grpc_service << "/" << target.config.grpc_method << std::endl;
     return false;
 }
 
@@ -0,0 +1,91 @@
+#include "bridge_schemas.h"
+#include <cstring>
+
+namespace data_bridge {
+
+namespace {
+
+#define DATA_BRIDGE_SCHEMA_ENTRY(Name, label, FIELDS) &SchemaTraits<schemas::Name>::descriptor,
+
+const SchemaDescriptor* const kSchemas[] = {
+    DATA_BRIDGE_SCHEMAS(DATA_BRIDGE_SCHEMA_ENTRY)
+};
+
+#undef DATA_BRIDGE_SCHEMA_ENTRY
+
+} // namespace
+
+const SchemaDescriptor* findSchema(const std::string& name) {
+    for (const auto* schema : kSchemas) {
+        if (name == schema->name) {
+            return schema;
+        }
+    }
+    return nullptr;
+}
+
+std::string schemaNames() {
+    std::string names;
+    for (const auto* schema : kSchemas) {
+        if (!names.empty()) {
+            names += ", ";
+        }
+        names += schema->name;
+    }
+    return names;
+}
+
+FieldValue loadFieldValue(FieldType type, const uint8_t* data) {
+    FieldValue value;
+    switch (type) {
+        case FieldType::BOOL:
+            value.u = data[0] != 0;
+            break;
+        case FieldType::INT32: {
+            int32_t v;
+            std::memcpy(&v, data, sizeof(v));
+            value.i = v;
+            break;
+        }
+        case FieldType::UINT32: {
+            uint32_t v;
+            std::memcpy(&v, data, sizeof(v));
+            value.u = v;
+            break;
+        }
+        case FieldType::FLOAT: {
+            float v;
+            std::memcpy(&v, data, sizeof(v));
+            value.d = v;
+            break;
+        }
+        default:
+            std::memcpy(&value.u, data, sizeof(value.u));
+            break;
+    }
+    return value;
+}
+
+size_t storeFieldValue(FieldType type, const FieldValue& value, uint8_t* out) {
+    switch (type) {
+        case FieldType::BOOL:
+            out[0] = value.u != 0;
+            return 1;
+        case FieldType::INT32:
+        case FieldType::UINT32: {
+            uint32_t v = static_cast<uint32_t>(value.u);
+            std::memcpy(out, &v, sizeof(v));
+            return 4;
+        }
+        case FieldType::FLOAT: {
+            float v = static_cast<float>(value.d);
+            std::memcpy(out, &v, sizeof(v));
+            return 4;
+        }
+        default:
+            std::memcpy(out, &value.u, sizeof(value.u));
+            return 8;
+    }
+}
+
+} // namespace data_bridge
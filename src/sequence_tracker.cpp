@@ -0,0 +1,184 @@
+#include "sequence_tracker.h"
+#include <cstring>
+
+namespace data_bridge {
+
+namespace {
+
+// Publishers tracked per stream, later ones are ignored
+constexpr size_t kMaxPublishers = 4096;
+
+uint64_t readLittleEndian64(const uint8_t* data) {
+    uint64_t value = 0;
+    for (int i = 7; i >= 0; --i) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+void writeLittleEndian64(uint64_t value, uint8_t* data) {
+    for (int i = 0; i < 8; ++i) {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+} // namespace
+
+uint64_t SequenceTracker::publisherId(const uint8_t* zid, size_t zid_size, uint32_t eid) {
+    // FNV-1a, collisions between the few publishers of a stream are negligible
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < zid_size; ++i) {
+        hash = (hash ^ zid[i]) * 1099511628211ULL;
+    }
+    for (int i = 0; i < 4; ++i) {
+        hash = (hash ^ ((eid >> (8 * i)) & 0xff)) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool SequenceTracker::readHeader(const uint8_t* data, size_t len, SequenceHeader& header) {
+    if (!data || len < 16) {
+        return false;
+    }
+    header.publisher = readLittleEndian64(data);
+    header.sequence = readLittleEndian64(data + 8);
+    return true;
+}
+
+bool SequenceTracker::writeHeader(const SequenceHeader& header, uint8_t* data, size_t len) {
+    if (!data || len < 16) {
+        return false;
+    }
+    writeLittleEndian64(header.publisher, data);
+    writeLittleEndian64(header.sequence, data + 8);
+    return true;
+}
+
+bool SequenceTracker::observe(uint64_t publisher, uint64_t sequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    bool created = false;
+    Window* window = findWindow(publisher, sequence, created);
+    if (!window || created) {
+        return true;
+    }
+    return observeLocked(*window, sequence);
+}
+
+bool SequenceTracker::observeWrapping(uint64_t publisher, uint32_t sequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    bool created = false;
+    Window* window = findWindow(publisher, sequence, created);
+    if (!window || created) {
+        return true;
+    }
+
+    // Closest 64-bit value to the highest seen with these low 32 bits
+    uint64_t extended = sequence;
+    int32_t delta = static_cast<int32_t>(sequence - static_cast<uint32_t>(window->highest));
+    if (delta >= 0 || static_cast<uint64_t>(-static_cast<int64_t>(delta)) <= window->highest) {
+        extended = window->highest + static_cast<int64_t>(delta);
+    }
+    return observeLocked(*window, extended);
+}
+
+SequenceTracker::Window* SequenceTracker::findWindow(uint64_t publisher, uint64_t sequence, bool& created) {
+    auto it = windows_.find(publisher);
+    if (it != windows_.end()) {
+        return &it->second;
+    }
+    if (windows_.size() >= kMaxPublishers) {
+        return nullptr;
+    }
+
+    // The first sample of a publisher opens its window
+    it = windows_.emplace(publisher, Window()).first;
+    restart(it->second, sequence);
+    stats_.publishers++;
+    stats_.received++;
+    created = true;
+    return &it->second;
+}
+
+bool SequenceTracker::observeLocked(Window& window, uint64_t sequence) {
+    stats_.received++;
+
+    if (sequence > window.highest) {
+        uint64_t advance = sequence - window.highest;
+        stats_.lost += advance - 1;
+
+        // Slots that now represent the new numbers start unseen
+        if (advance >= kWindow) {
+            window.seen.fill(0);
+        } else {
+            for (uint64_t skipped = window.highest + 1; skipped < sequence; ++skipped) {
+                clearBit(window, skipped);
+            }
+        }
+        window.highest = sequence;
+        window.stale_run = 0;
+        setBit(window, sequence);
+        return true;
+    }
+
+    // A single old or replayed sample must not move the window back, a steady run from lower numbers does
+    if (window.highest - sequence >= kWindow) {
+        window.stale_run = (window.stale_run > 0 && sequence == window.stale_next) ? window.stale_run + 1 : 1;
+        window.stale_next = sequence + 1;
+        if (window.stale_run < kRestartRun) {
+            stats_.stale++;
+            return false;
+        }
+        stats_.resets++;
+        restart(window, sequence);
+        return true;
+    }
+
+    // Older than the first sample: late, but it was never counted as lost
+    if (sequence < window.first) {
+        stats_.reordered++;
+        return true;
+    }
+
+    if (testBit(window, sequence)) {
+        stats_.duplicates++;
+        return false;
+    }
+    setBit(window, sequence);
+    stats_.reordered++;
+    if (stats_.lost > 0) {
+        stats_.lost--;
+    }
+    return true;
+}
+
+void SequenceTracker::restart(Window& window, uint64_t sequence) {
+    window.first = sequence;
+    window.highest = sequence;
+    window.seen.fill(0);
+    window.stale_run = 0;
+    setBit(window, sequence);
+}
+
+bool SequenceTracker::testBit(const Window& window, uint64_t sequence) {
+    size_t bit = sequence % kWindow;
+    return (window.seen[bit / 64] >> (bit % 64)) & 1;
+}
+
+void SequenceTracker::setBit(Window& window, uint64_t sequence) {
+    size_t bit = sequence % kWindow;
+    window.seen[bit / 64] |= uint64_t(1) << (bit % 64);
+}
+
+void SequenceTracker::clearBit(Window& window, uint64_t sequence) {
+    size_t bit = sequence % kWindow;
+    window.seen[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+}
+
+SequenceStats SequenceTracker::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+} // namespace data_bridge
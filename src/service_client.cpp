@@ -0,0 +1,513 @@
+#include "service_client.h"
+#include "thread_placement.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+namespace data_bridge {
+
+namespace {
+
+constexpr size_t kIdSize = 8;
+constexpr size_t kLengthSize = 4;
+
+// Larger stream frames are a protocol error, the connection is dropped
+constexpr size_t kMaxFrame = 16 * 1024 * 1024;
+
+constexpr size_t kReceiveChunk = 65536;
+constexpr int64_t kReconnectDelayNs = 500000000;
+
+// A TCP connect still pending after this is abandoned and retried
+constexpr int64_t kConnectTimeoutNs = 1000000000;
+
+// Longest poll, bounds how late stop() and UDP retries after EAGAIN are noticed
+constexpr int kMaxPollMs = 100;
+
+int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void writeLittleEndian(uint64_t value, size_t bytes, uint8_t* data) {
+    for (size_t i = 0; i < bytes; ++i) {
+        data[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+uint64_t readLittleEndian(const uint8_t* data, size_t bytes) {
+    uint64_t value = 0;
+    for (size_t i = bytes; i-- > 0;) {
+        value = (value << 8) | data[i];
+    }
+    return value;
+}
+
+} // namespace
+
+const char* serviceResultName(ServiceResult result) {
+    switch (result) {
+        case ServiceResult::OK: return "ok";
+        case ServiceResult::TIMEOUT: return "timeout";
+        default: return "disconnected";
+    }
+}
+
+ServiceClient::ServiceClient(const ServiceConfig& config)
+    : config_(config),
+      stream_(config.transport != ServiceTransport::UDP) {
+}
+
+ServiceClient::~ServiceClient() {
+    stop();
+}
+
+bool ServiceClient::start() {
+    if (running_) {
+        return false;
+    }
+
+    wakeup_fd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (wakeup_fd_ < 0) {
+        std::cerr << "[ServiceClient] Failed to create eventfd: " << strerror(errno) << std::endl;
+        return false;
+    }
+    datagram_.resize(stream_ ? 0 : kReceiveChunk);
+
+    running_ = true;
+    try {
+        io_thread_ = std::thread(&ServiceClient::ioLoop, this);
+    } catch (const std::exception& e) {
+        std::cerr << "[ServiceClient] Failed to start I/O thread: " << e.what() << std::endl;
+        running_ = false;
+        close(wakeup_fd_);
+        wakeup_fd_ = -1;
+        return false;
+    }
+
+    std::cout << "[ServiceClient] " << describe() << ": window " << config_.window << ", timeout "
+              << config_.timeout_ms << " ms, at most " << config_.max_outstanding << " outstanding" << std::endl;
+    return true;
+}
+
+void ServiceClient::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    uint64_t one = 1;
+    if (write(wakeup_fd_, &one, sizeof(one)) < 0) {
+        std::cerr << "[ServiceClient] Failed to wake I/O thread: " << strerror(errno) << std::endl;
+    }
+    if (io_thread_.joinable()) {
+        io_thread_.join();
+    }
+
+    // Every accepted request gets its answer, including ones submitted while stopping
+    disconnect(nullptr);
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        for (auto& request : submitted_) {
+            waiting_.push_back(std::move(request));
+        }
+        submitted_.clear();
+    }
+    for (auto& request : waiting_) {
+        finish(request, ServiceResult::DISCONNECTED);
+    }
+    waiting_.clear();
+
+    close(wakeup_fd_);
+    wakeup_fd_ = -1;
+}
+
+bool ServiceClient::submit(const uint8_t* data, size_t len, ReplyCallback callback) {
+    size_t pending = outstanding_.fetch_add(1);
+    if (!running_ || pending >= std::max<size_t>(config_.max_outstanding, 1)) {
+        outstanding_--;
+        rejected_++;
+        return false;
+    }
+
+    // The frame is built here so the I/O thread only writes it
+    Request request;
+    request.id = next_id_++;
+    request.deadline_ns = steadyNowNs() + static_cast<int64_t>(config_.timeout_ms) * 1000000;
+    size_t header = stream_ ? kLengthSize + kIdSize : kIdSize;
+    request.frame.resize(header + len);
+    if (stream_) {
+        writeLittleEndian(kIdSize + len, kLengthSize, request.frame.data());
+    }
+    writeLittleEndian(request.id, kIdSize, request.frame.data() + header - kIdSize);
+    if (len > 0) {
+        std::memcpy(request.frame.data() + header, data, len);
+    }
+    request.callback = std::move(callback);
+    requests_++;
+
+    // Only the first request of a batch wakes the I/O thread, it takes the whole queue
+    bool wake = false;
+    {
+        std::lock_guard<std::mutex> lock(submit_mutex_);
+        wake = submitted_.empty();
+        submitted_.push_back(std::move(request));
+    }
+    if (wake) {
+        uint64_t one = 1;
+        if (write(wakeup_fd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            std::cerr << "[ServiceClient] Failed to wake I/O thread: " << strerror(errno) << std::endl;
+        }
+    }
+    return true;
+}
+
+ServiceStats ServiceClient::getStats() const {
+    ServiceStats stats;
+    stats.requests = requests_.load();
+    stats.responses = responses_.load();
+    stats.timeouts = timeouts_.load();
+    stats.disconnected = disconnected_.load();
+    stats.rejected = rejected_.load();
+    stats.late = late_.load();
+    stats.connects = connects_.load();
+    stats.outstanding = outstanding_.load();
+    return stats;
+}
+
+std::string ServiceClient::describe() const {
+    switch (config_.transport) {
+        case ServiceTransport::TCP: return "tcp://" + config_.host + ":" + std::to_string(config_.port);
+        case ServiceTransport::UNIX: return "unix://" + config_.unix_path;
+        default: return "udp://" + config_.host + ":" + std::to_string(config_.port);
+    }
+}
+
+void ServiceClient::ioLoop() {
+    ThreadRegistration registration("service");
+
+    while (running_) {
+        int64_t now = steadyNowNs();
+        if (socket_ < 0 && now >= reconnect_at_ns_ && !connectService()) {
+            reconnect_at_ns_ = now + kReconnectDelayNs;
+        }
+        if (connecting_ && now >= connect_deadline_ns_) {
+            connectFailed(ETIMEDOUT);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(submit_mutex_);
+            for (auto& request : submitted_) {
+                waiting_.push_back(std::move(request));
+            }
+            submitted_.clear();
+        }
+
+        // Expired requests are not sent at all
+        expire(now);
+        if (socket_ >= 0 && !connecting_ && !sendRequests()) {
+            disconnect("send failed");
+        }
+
+        // UDP waits for socket space only while the window has room for a blocked request
+        short events = POLLIN;
+        if (connecting_) {
+            events = POLLOUT;
+        } else if (stream_ ? output_offset_ < output_.size()
+                           : !waiting_.empty() && in_flight_.size() < std::max<size_t>(config_.window, 1)) {
+            events |= POLLOUT;
+        }
+        pollfd fds[2] = {{wakeup_fd_, POLLIN, 0}, {socket_, events, 0}};
+        nfds_t count = socket_ >= 0 ? 2 : 1;
+
+        int ready = poll(fds, count, pollTimeoutMs(steadyNowNs()));
+        if (ready <= 0) {
+            continue;
+        }
+        if (fds[0].revents & POLLIN) {
+            uint64_t value = 0;
+            if (read(wakeup_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+                std::cerr << "[ServiceClient] Failed to read eventfd: " << strerror(errno) << std::endl;
+            }
+        }
+        if (count > 1 && connecting_) {
+            if (fds[1].revents & (POLLOUT | POLLERR | POLLHUP)) {
+                finishConnect();
+            }
+        } else if (count > 1 && (fds[1].revents & (POLLIN | POLLERR | POLLHUP)) && !receiveResponses()) {
+            disconnect("connection lost");
+        }
+    }
+}
+
+bool ServiceClient::connectService() {
+    bool unix_socket = config_.transport == ServiceTransport::UNIX;
+    int fd = socket(unix_socket ? AF_UNIX : AF_INET,
+                    (stream_ ? SOCK_STREAM : SOCK_DGRAM) | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+    if (fd < 0) {
+        std::cerr << "[ServiceClient] Failed to create socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Unix and UDP sockets connect (or fail) right away, TCP completes in the I/O loop
+    int result = -1;
+    if (unix_socket) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (config_.unix_path.size() < sizeof(addr.sun_path)) {
+            std::memcpy(addr.sun_path, config_.unix_path.c_str(), config_.unix_path.size() + 1);
+            result = connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        } else {
+            errno = ENAMETOOLONG;
+        }
+    } else {
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(config_.port));
+        if (inet_pton(AF_INET, config_.host.c_str(), &addr.sin_addr) == 1) {
+            result = connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        } else {
+            errno = EINVAL;
+        }
+    }
+    socket_ = fd;
+    if (result < 0 && errno == EINPROGRESS) {
+        connecting_ = true;
+        connect_deadline_ns_ = steadyNowNs() + kConnectTimeoutNs;
+        return true;
+    }
+    if (result < 0) {
+        connectFailed(errno);
+        return false;
+    }
+    connected();
+    return true;
+}
+
+void ServiceClient::finishConnect() {
+    int error = 0;
+    socklen_t len = sizeof(error);
+    if (getsockopt(socket_, SOL_SOCKET, SO_ERROR, &error, &len) < 0) {
+        error = errno;
+    }
+    if (error != 0) {
+        connectFailed(error);
+        return;
+    }
+    connecting_ = false;
+    connected();
+}
+
+void ServiceClient::connectFailed(int error) {
+    if (!connect_failed_) {
+        std::cerr << "[ServiceClient] Failed to connect to " << describe() << ": " << strerror(error)
+                  << ", retrying" << std::endl;
+        connect_failed_ = true;
+    }
+    close(socket_);
+    socket_ = -1;
+    connecting_ = false;
+    reconnect_at_ns_ = steadyNowNs() + kReconnectDelayNs;
+}
+
+void ServiceClient::connected() {
+    if (config_.transport == ServiceTransport::TCP) {
+        int nodelay = 1;
+        setsockopt(socket_, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    }
+
+    connect_failed_ = false;
+    if (stream_) {
+        connects_++;
+        std::cout << "[ServiceClient] Connected to " << describe() << std::endl;
+    }
+}
+
+void ServiceClient::disconnect(const char* reason) {
+    if (socket_ >= 0) {
+        close(socket_);
+        socket_ = -1;
+    }
+    connecting_ = false;
+    if (reason) {
+        std::cerr << "[ServiceClient] " << describe() << ": " << reason << ", " << in_flight_.size()
+                  << " request(s) failed" << std::endl;
+    }
+
+    // Their responses can no longer arrive
+    for (auto& entry : in_flight_) {
+        finish(entry.second, ServiceResult::DISCONNECTED);
+    }
+    in_flight_.clear();
+    deadlines_.clear();
+    output_.clear();
+    output_offset_ = 0;
+    input_.clear();
+    reconnect_at_ns_ = steadyNowNs() + kReconnectDelayNs;
+}
+
+bool ServiceClient::sendRequests() {
+    size_t window = std::max<size_t>(config_.window, 1);
+    while (!waiting_.empty() && in_flight_.size() < window) {
+        Request& request = waiting_.front();
+
+        if (stream_) {
+            output_.insert(output_.end(), request.frame.begin(), request.frame.end());
+        } else {
+            // A connected UDP socket reports an earlier ICMP refusal once, the datagram then goes out on retry
+            ssize_t sent = send(socket_, request.frame.data(), request.frame.size(), MSG_DONTWAIT);
+            if (sent < 0 && errno == ECONNREFUSED) {
+                sent = send(socket_, request.frame.data(), request.frame.size(), MSG_DONTWAIT);
+            }
+            if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == ENOBUFS)) {
+                break;
+            }
+            // Any other failure leaves the request to time out, like a lost datagram
+        }
+
+        deadlines_.emplace_back(request.deadline_ns, request.id);
+        request.frame = std::vector<uint8_t>();
+        uint64_t id = request.id;
+        in_flight_.emplace(id, std::move(request));
+        waiting_.pop_front();
+    }
+
+    return !stream_ || flushOutput();
+}
+
+bool ServiceClient::flushOutput() {
+    while (output_offset_ < output_.size()) {
+        ssize_t written = send(socket_, output_.data() + output_offset_, output_.size() - output_offset_,
+                               MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        output_offset_ += static_cast<size_t>(written);
+    }
+    output_.clear();
+    output_offset_ = 0;
+    return true;
+}
+
+bool ServiceClient::receiveResponses() {
+    if (!stream_) {
+        for (;;) {
+            ssize_t received = recv(socket_, datagram_.data(), datagram_.size(), MSG_DONTWAIT);
+            if (received < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // Refused: nobody listens yet, the requests time out
+                return errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED;
+            }
+            dispatch(datagram_.data(), static_cast<size_t>(received));
+        }
+    }
+
+    for (;;) {
+        size_t used = input_.size();
+        input_.resize(used + kReceiveChunk);
+        ssize_t received = recv(socket_, input_.data() + used, kReceiveChunk, MSG_DONTWAIT);
+        input_.resize(used + std::max<ssize_t>(received, 0));
+        if (received == 0) {
+            return false;
+        }
+        if (received < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            return false;
+        }
+    }
+
+    size_t offset = 0;
+    while (input_.size() - offset >= kLengthSize) {
+        size_t length = readLittleEndian(input_.data() + offset, kLengthSize);
+        if (length < kIdSize || length > kMaxFrame) {
+            std::cerr << "[ServiceClient] " << describe() << ": invalid frame length " << length << std::endl;
+            return false;
+        }
+        if (input_.size() - offset - kLengthSize < length) {
+            break;
+        }
+        dispatch(input_.data() + offset + kLengthSize, length);
+        offset += kLengthSize + length;
+    }
+    input_.erase(input_.begin(), input_.begin() + offset);
+    return true;
+}
+
+void ServiceClient::dispatch(const uint8_t* data, size_t len) {
+    if (len < kIdSize) {
+        return;
+    }
+    auto it = in_flight_.find(readLittleEndian(data, kIdSize));
+    if (it == in_flight_.end()) {
+        late_++;
+        return;
+    }
+    finish(it->second, ServiceResult::OK, data + kIdSize, len - kIdSize);
+    in_flight_.erase(it);
+}
+
+void ServiceClient::expire(int64_t now_ns) {
+    while (!waiting_.empty() && waiting_.front().deadline_ns <= now_ns) {
+        finish(waiting_.front(), ServiceResult::TIMEOUT);
+        waiting_.pop_front();
+    }
+
+    // One timeout for all requests: send order is deadline order. Answered ones are skipped here.
+    while (!deadlines_.empty() && deadlines_.front().first <= now_ns) {
+        auto it = in_flight_.find(deadlines_.front().second);
+        if (it != in_flight_.end()) {
+            finish(it->second, ServiceResult::TIMEOUT);
+            in_flight_.erase(it);
+        }
+        deadlines_.pop_front();
+    }
+}
+
+int ServiceClient::pollTimeoutMs(int64_t now_ns) const {
+    int64_t next = now_ns + static_cast<int64_t>(kMaxPollMs) * 1000000;
+    if (!waiting_.empty()) {
+        next = std::min(next, waiting_.front().deadline_ns);
+    }
+    if (!deadlines_.empty()) {
+        next = std::min(next, deadlines_.front().first);
+    }
+    if (socket_ < 0) {
+        next = std::min(next, reconnect_at_ns_);
+    }
+    if (connecting_) {
+        next = std::min(next, connect_deadline_ns_);
+    }
+    // Rounded up, so a deadline is never polled for just before it passes
+    return static_cast<int>(std::max<int64_t>(next - now_ns + 999999, 0) / 1000000);
+}
+
+void ServiceClient::finish(Request& request, ServiceResult result, const uint8_t* data, size_t len) {
+    switch (result) {
+        case ServiceResult::OK: responses_++; break;
+        case ServiceResult::TIMEOUT: timeouts_++; break;
+        case ServiceResult::DISCONNECTED: disconnected_++; break;
+    }
+    outstanding_--;
+    if (request.callback) {
+        request.callback(result, data, len);
+        request.callback = nullptr;
+    }
+}
+
+} // namespace data_bridge
@@ -0,0 +1,287 @@
+#include "session_supervisor.h"
+#include "thread_placement.h"
+#include <sstream>
+
+namespace data_bridge {
+
+namespace {
+
+// Build the JSON5 endpoint list from a comma separated zenoh_connect value
+std::string endpointsJson(const std::string& connect) {
+    std::ostringstream json;
+    std::istringstream input(connect);
+    std::string endpoint;
+    bool first = true;
+
+    json << "[";
+    while (std::getline(input, endpoint, ',')) {
+        if (endpoint.empty()) {
+            continue;
+        }
+        json << (first ? "" : ",") << "\"" << endpoint << "\"";
+        first = false;
+    }
+    json << "]";
+    return json.str();
+}
+
+} // namespace
+
+SessionSupervisor::SessionSupervisor(const BridgeConfig& config)
+    : config_(config),
+      supervised_(!config.zenoh_connect.empty()),
+      backoff_(config.reconnect_backoff_initial_ms),
+      rng_(std::random_device{}()) {
+}
+
+SessionSupervisor::~SessionSupervisor() {
+    stop();
+}
+
+bool SessionSupervisor::start() {
+    if (running_) {
+        std::cerr << "[SessionSupervisor] Already running" << std::endl;
+        return false;
+    }
+
+    auto session = openSession();
+    bool reachable = session && hasConnectivity(*session);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        primary_ = std::move(session);
+    }
+
+    connected_ = reachable;
+    {
+        std::lock_guard<std::mutex> lock(stats_mutex_);
+        stats_.connected = reachable;
+        down_since_ = std::chrono::steady_clock::now();
+    }
+
+    if (!reachable) {
+        std::cerr << "[SessionSupervisor] Router not reachable yet, retrying in background" << std::endl;
+    }
+
+    running_ = true;
+    try {
+        monitor_thread_ = std::thread(&SessionSupervisor::monitorLoop, this);
+    } catch (const std::exception& e) {
+        std::cerr << "[SessionSupervisor] Failed to start monitor: " << e.what() << std::endl;
+        running_ = false;
+        return false;
+    }
+
+    return true;
+}
+
+void SessionSupervisor::stop() {
+    if (running_.exchange(false)) {
+        {
+            std::lock_guard<std::mutex> lock(wait_mutex_);
+        }
+        wait_cv_.notify_all();
+        if (monitor_thread_.joinable()) {
+            monitor_thread_.join();
+        }
+    }
+
+    std::unique_ptr<zenoh::Session> primary;
+    std::unique_ptr<zenoh::Session> standby;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        primary = std::move(primary_);
+        standby = std::move(standby_);
+    }
+    connected_ = false;
+}
+
+void SessionSupervisor::setReconnectCallback(ReconnectCallback callback) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    callback_ = std::move(callback);
+}
+
+SupervisorStats SessionSupervisor::getStats() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    SupervisorStats snapshot = stats_;
+    if (!snapshot.connected && snapshot.disconnects > 0) {
+        snapshot.total_downtime_ms += std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - down_since_).count();
+    }
+    return snapshot;
+}
+
+void SessionSupervisor::monitorLoop() {
+    ThreadRegistration registration("supervisor");
+    const auto check_interval = std::chrono::milliseconds(config_.health_check_interval_ms);
+    const auto grace = std::chrono::milliseconds(config_.disconnect_grace_ms);
+
+    while (waitFor(check_interval)) {
+        bool healthy;
+        bool need_standby;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            healthy = primary_ && hasConnectivity(*primary_);
+            need_standby = config_.warm_standby && supervised_ && !standby_;
+        }
+
+        if (healthy) {
+            if (!connected_) {
+                // Transport came back inside the same session; Zenoh restores
+                // its own declarations in that case
+                markUp(false);
+            }
+            backoff_ = std::chrono::milliseconds(config_.reconnect_backoff_initial_ms);
+
+            if (need_standby) {
+                auto standby = openSession();
+                std::lock_guard<std::mutex> lock(mutex_);
+                standby_ = std::move(standby);
+            }
+            continue;
+        }
+
+        if (connected_) {
+            markDown();
+        }
+
+        bool has_primary;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            has_primary = primary_ != nullptr;
+        }
+        if (has_primary && downFor() < grace) {
+            continue;
+        }
+
+        // Prefer the warm standby, otherwise open a fresh session
+        std::unique_ptr<zenoh::Session> candidate;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (standby_ && hasConnectivity(*standby_)) {
+                candidate = std::move(standby_);
+            }
+        }
+        if (!candidate) {
+            candidate = openSession();
+            if (candidate && !hasConnectivity(*candidate)) {
+                candidate.reset();
+            }
+        }
+
+        if (candidate) {
+            promote(std::move(candidate));
+            markUp(true);
+            backoff_ = std::chrono::milliseconds(config_.reconnect_backoff_initial_ms);
+        } else {
+            auto delay = nextBackoff();
+            std::cerr << "[SessionSupervisor] Reconnect failed, retrying in "
+                      << delay.count() << " ms" << std::endl;
+            waitFor(delay);
+        }
+    }
+}
+
+bool SessionSupervisor::hasConnectivity(const zenoh::Session& session) const {
+    if (session.is_closed()) {
+        return false;
+    }
+    if (!supervised_) {
+        return true;
+    }
+
+    zenoh::ZResult err = Z_OK;
+    auto routers = session.get_routers_z_id(&err);
+    if (err == Z_OK && !routers.empty()) {
+        return true;
+    }
+    auto peers = session.get_peers_z_id(&err);
+    return err == Z_OK && !peers.empty();
+}
+
+std::unique_ptr<zenoh::Session> SessionSupervisor::openSession() const {
+    try {
+        zenoh::Config zenoh_config = zenoh::Config::create_default();
+        if (supervised_) {
+            zenoh_config.insert_json5("mode", "\"" + config_.zenoh_mode + "\"");
+            zenoh_config.insert_json5("connect/endpoints", endpointsJson(config_.zenoh_connect));
+        }
+        if (config_.zenoh_low_latency) {
+            // Skips the QoS priority queues and batching, both ends must agree
+            zenoh_config.insert_json5("transport/unicast/lowlatency", "true");
+            zenoh_config.insert_json5("transport/unicast/qos/enabled", "false");
+        }
+        return std::make_unique<zenoh::Session>(zenoh::Session::open(std::move(zenoh_config)));
+    } catch (const std::exception& e) {
+        std::cerr << "[SessionSupervisor] Failed to open session: " << e.what() << std::endl;
+        return nullptr;
+    }
+}
+
+void SessionSupervisor::promote(std::unique_ptr<zenoh::Session> session) {
+    std::unique_ptr<zenoh::Session> old;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        old = std::move(primary_);
+        primary_ = std::move(session);
+        if (callback_) {
+            callback_(*primary_);
+        }
+    }
+    // Old session is closed outside the lock, closing may wait on timeouts
+    old.reset();
+}
+
+void SessionSupervisor::markDown() {
+    connected_ = false;
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    down_since_ = std::chrono::steady_clock::now();
+    stats_.connected = false;
+    stats_.disconnects++;
+    std::cerr << "[SessionSupervisor] Router connectivity lost" << std::endl;
+}
+
+void SessionSupervisor::markUp(bool failover) {
+    connected_ = true;
+
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    auto downtime = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - down_since_).count();
+    stats_.connected = true;
+    if (stats_.disconnects == 0) {
+        // First connection after a failed initial open, not a recovery
+        std::cout << "[SessionSupervisor] Connected" << std::endl;
+        return;
+    }
+    stats_.reconnects++;
+    if (failover) {
+        stats_.failovers++;
+    }
+    stats_.last_downtime_ms = downtime;
+    stats_.total_downtime_ms += downtime;
+    std::cout << "[SessionSupervisor] Reconnected " << (failover ? "via new session" : "in-session")
+              << " after " << downtime << " ms" << std::endl;
+}
+
+std::chrono::steady_clock::duration SessionSupervisor::downFor() const {
+    std::lock_guard<std::mutex> lock(stats_mutex_);
+    return std::chrono::steady_clock::now() - down_since_;
+}
+
+std::chrono::milliseconds SessionSupervisor::nextBackoff() {
+    auto base = backoff_;
+    backoff_ = std::min(backoff_ * 2, std::chrono::milliseconds(config_.reconnect_backoff_max_ms));
+
+    // Equal jitter: half fixed, half random, so retries from many bridges spread out
+    std::uniform_int_distribution<long> jitter(0, base.count() / 2);
+    return std::chrono::milliseconds(base.count() - base.count() / 2 + jitter(rng_));
+}
+
+bool SessionSupervisor::waitFor(std::chrono::milliseconds delay) {
+    std::unique_lock<std::mutex> lock(wait_mutex_);
+    wait_cv_.wait_for(lock, delay, [this]() { return !running_; });
+    return running_;
+}
+
+} // namespace data_bridge
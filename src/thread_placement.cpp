@@ -0,0 +1,246 @@
+#include "thread_placement.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iterator>
+#include <sched.h>
+#include <sstream>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+
+namespace data_bridge {
+
+namespace {
+
+// Kernel thread names are limited to 15 characters
+constexpr size_t kMaxThreadName = 15;
+
+uint64_t toNs(const timespec& ts) {
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t steadyNowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return toNs(ts);
+}
+
+uint64_t readInvoluntarySwitches(pid_t tid) {
+    std::ifstream status("/proc/self/task/" + std::to_string(tid) + "/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, 26, "nonvoluntary_ctxt_switches") == 0) {
+            return std::strtoull(line.c_str() + line.find(':') + 1, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+int readLastCpu(pid_t tid) {
+    std::ifstream stat("/proc/self/task/" + std::to_string(tid) + "/stat");
+    std::string content((std::istreambuf_iterator<char>(stat)), std::istreambuf_iterator<char>());
+
+    // Fields after the parenthesized name start with the state (field 3), processor is field 39
+    size_t end = content.rfind(')');
+    if (end == std::string::npos) {
+        return -1;
+    }
+    std::istringstream fields(content.substr(end + 1));
+    std::string field;
+    for (int i = 3; i <= 39 && fields >> field; ++i) {
+        if (i == 39) {
+            return std::atoi(field.c_str());
+        }
+    }
+    return -1;
+}
+
+} // namespace
+
+bool applyThreadPlacement(const ThreadPlacement& placement, const std::string& name) {
+    bool applied = true;
+
+    if (!placement.cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : placement.cpus) {
+            if (cpu < 0 || cpu >= CPU_SETSIZE) {
+                std::cerr << "[ThreadPlacement] Invalid CPU " << cpu << " for " << name << std::endl;
+                applied = false;
+                continue;
+            }
+            CPU_SET(cpu, &set);
+        }
+
+        int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (err != 0) {
+            std::cerr << "[ThreadPlacement] Failed to pin " << name << ": " << strerror(err) << std::endl;
+            applied = false;
+        }
+
+        // Prefer the node of the CPUs for pages this thread touches first
+        int node = numaNodeOfCpu(placement.cpus.front());
+        bool one_node = std::all_of(placement.cpus.begin(), placement.cpus.end(),
+                                    [node](int cpu) { return numaNodeOfCpu(cpu) == node; });
+        if (node >= 0 && one_node && node < static_cast<int>(sizeof(unsigned long) * 8)) {
+            unsigned long mask = 1UL << node;
+            if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &mask, sizeof(mask) * 8 + 1) != 0) {
+                std::cerr << "[ThreadPlacement] Failed to prefer NUMA node " << node << " for " << name
+                          << ": " << strerror(errno) << std::endl;
+                applied = false;
+            }
+        }
+    }
+
+    if (placement.realtime_priority > 0) {
+        sched_param param{};
+        param.sched_priority = std::clamp(placement.realtime_priority,
+                                          sched_get_priority_min(SCHED_FIFO),
+                                          sched_get_priority_max(SCHED_FIFO));
+        int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            std::cerr << "[ThreadPlacement] Failed to set SCHED_FIFO for " << name << ": " << strerror(err)
+                      << " (needs CAP_SYS_NICE or an rtprio limit)" << std::endl;
+            applied = false;
+        }
+    } else {
+        // Threads inherit SCHED_FIFO from their creator, undo it for normal threads
+        int policy;
+        sched_param param;
+        if (pthread_getschedparam(pthread_self(), &policy, &param) == 0 && policy == SCHED_FIFO) {
+            param.sched_priority = 0;
+            pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+        }
+    }
+
+    if (!placement.cpus.empty() || placement.realtime_priority > 0) {
+        std::cout << "[ThreadPlacement] " << name << ": " << describePlacement(placement) << std::endl;
+    }
+    return applied;
+}
+
+int numaNodeOfCpu(int cpu) {
+    std::string path = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    DIR* dir = opendir(path.c_str());
+    if (!dir) {
+        return -1;
+    }
+
+    int node = -1;
+    while (dirent* entry = readdir(dir)) {
+        if (strncmp(entry->d_name, "node", 4) == 0 && isdigit(static_cast<unsigned char>(entry->d_name[4]))) {
+            node = std::atoi(entry->d_name + 4);
+            break;
+        }
+    }
+    closedir(dir);
+    return node;
+}
+
+std::string describePlacement(const ThreadPlacement& placement) {
+    std::ostringstream os;
+    if (placement.cpus.empty()) {
+        os << "unpinned";
+    } else {
+        os << "cpus ";
+        for (size_t i = 0; i < placement.cpus.size(); ++i) {
+            os << (i > 0 ? "," : "") << placement.cpus[i];
+        }
+        int node = numaNodeOfCpu(placement.cpus.front());
+        if (node >= 0) {
+            os << " (node " << node << ")";
+        }
+    }
+    if (placement.realtime_priority > 0) {
+        os << " FIFO " << placement.realtime_priority;
+    }
+    return os.str();
+}
+
+ThreadMonitor& ThreadMonitor::instance() {
+    // Never destroyed, threads may still deregister during static destruction
+    static ThreadMonitor* monitor = new ThreadMonitor();
+    return *monitor;
+}
+
+void ThreadMonitor::add(const std::string& name) {
+    Entry entry;
+    entry.name = name;
+    entry.thread = pthread_self();
+    entry.tid = static_cast<pid_t>(syscall(SYS_gettid));
+    if (pthread_getcpuclockid(entry.thread, &entry.clock) != 0) {
+        return;
+    }
+
+    timespec cpu;
+    clock_gettime(entry.clock, &cpu);
+    entry.last_cpu_ns = toNs(cpu);
+    entry.last_wall_ns = steadyNowNs();
+    entry.last_switches = readInvoluntarySwitches(entry.tid);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back(std::move(entry));
+}
+
+void ThreadMonitor::remove() {
+    pthread_t self = pthread_self();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                  [self](const Entry& entry) { return pthread_equal(entry.thread, self); }),
+                   entries_.end());
+}
+
+std::vector<ThreadUsage> ThreadMonitor::sample() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Entries are removed before their thread exits, so the clocks stay valid here
+    std::vector<ThreadUsage> usage;
+    for (auto& entry : entries_) {
+        timespec cpu;
+        if (clock_gettime(entry.clock, &cpu) != 0) {
+            continue;
+        }
+        uint64_t cpu_ns = toNs(cpu);
+        uint64_t wall_ns = steadyNowNs();
+        uint64_t switches = readInvoluntarySwitches(entry.tid);
+
+        ThreadUsage thread;
+        thread.name = entry.name;
+        thread.tid = entry.tid;
+        thread.cpu = readLastCpu(entry.tid);
+        if (wall_ns > entry.last_wall_ns) {
+            thread.cpu_percent = 100.0 * static_cast<double>(cpu_ns - entry.last_cpu_ns) /
+                                 static_cast<double>(wall_ns - entry.last_wall_ns);
+        }
+        thread.involuntary_switches = switches - std::min(switches, entry.last_switches);
+
+        int policy;
+        sched_param param;
+        if (pthread_getschedparam(entry.thread, &policy, &param) == 0 && policy == SCHED_FIFO) {
+            thread.realtime_priority = param.sched_priority;
+        }
+
+        entry.last_cpu_ns = cpu_ns;
+        entry.last_wall_ns = wall_ns;
+        entry.last_switches = switches;
+        usage.push_back(std::move(thread));
+    }
+    return usage;
+}
+
+ThreadRegistration::ThreadRegistration(const std::string& name) {
+    pthread_setname_np(pthread_self(), name.substr(0, kMaxThreadName).c_str());
+    ThreadMonitor::instance().add(name);
+}
+
+ThreadRegistration::~ThreadRegistration() {
+    ThreadMonitor::instance().remove();
+}
+
+} // namespace data_bridge
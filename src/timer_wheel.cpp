@@ -0,0 +1,132 @@
+#include "timer_wheel.h"
+#include "thread_placement.h"
+
+namespace data_bridge {
+
+TimerWheel::TimerWheel(std::chrono::microseconds tick, size_t slots)
+    : tick_(std::max(tick, std::chrono::microseconds(1))),
+      slots_(std::max<size_t>(slots, 1)) {
+}
+
+TimerWheel::~TimerWheel() {
+    stop();
+}
+
+bool TimerWheel::start() {
+    if (running_) {
+        std::cerr << "[TimerWheel] Already running" << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    thread_ = std::thread(&TimerWheel::run, this);
+    return true;
+}
+
+void TimerWheel::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+TimerWheel::TimerId TimerWheel::schedulePeriodic(std::chrono::microseconds period, Callback callback) {
+    return schedule(period, true, std::move(callback));
+}
+
+TimerWheel::TimerId TimerWheel::scheduleOnce(std::chrono::microseconds delay, Callback callback) {
+    return schedule(delay, false, std::move(callback));
+}
+
+void TimerWheel::cancel(TimerId id) {
+    // The entry stays in its slot and is discarded when reached
+    std::lock_guard<std::mutex> lock(mutex_);
+    active_.erase(id);
+}
+
+TimerWheel::TimerId TimerWheel::schedule(std::chrono::microseconds delay, bool periodic, Callback callback) {
+    uint64_t ticks = toTicks(delay);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    Timer timer;
+    timer.id = next_id_++;
+    timer.rounds = 0;
+    timer.period_ticks = periodic ? ticks : 0;
+    timer.callback = std::make_shared<Callback>(std::move(callback));
+
+    active_.insert(timer.id);
+    insertLocked(std::move(timer), ticks);
+    return next_id_ - 1;
+}
+
+void TimerWheel::insertLocked(Timer timer, uint64_t delay_ticks) {
+    timer.rounds = (delay_ticks - 1) / slots_.size();
+    slots_[(current_tick_ + delay_ticks) % slots_.size()].push_back(std::move(timer));
+}
+
+uint64_t TimerWheel::toTicks(std::chrono::microseconds delay) const {
+    uint64_t ticks = (delay.count() + tick_.count() - 1) / tick_.count();
+    return std::max<uint64_t>(ticks, 1);
+}
+
+void TimerWheel::run() {
+    ThreadRegistration registration("timer-wheel");
+
+    auto next_tick = std::chrono::steady_clock::now() + tick_;
+
+    while (running_) {
+        std::this_thread::sleep_until(next_tick);
+
+        // Catch up on ticks missed while callbacks ran long
+        auto now = std::chrono::steady_clock::now();
+        while (next_tick <= now && running_) {
+            advance();
+            next_tick += tick_;
+        }
+    }
+}
+
+void TimerWheel::advance() {
+    std::vector<Timer> expired;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        current_tick_++;
+        auto& slot = slots_[current_tick_ % slots_.size()];
+
+        for (size_t i = 0; i < slot.size();) {
+            Timer& timer = slot[i];
+            if (active_.count(timer.id) == 0) {
+                timer = std::move(slot.back());
+                slot.pop_back();
+            } else if (timer.rounds > 0) {
+                timer.rounds--;
+                ++i;
+            } else {
+                expired.push_back(std::move(timer));
+                timer = std::move(slot.back());
+                slot.pop_back();
+            }
+        }
+    }
+
+    // Callbacks run unlocked so they may schedule or cancel timers
+    for (auto& timer : expired) {
+        (*timer.callback)();
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& timer : expired) {
+        if (timer.period_ticks > 0 && active_.count(timer.id) > 0) {
+            uint64_t period = timer.period_ticks;
+            insertLocked(std::move(timer), period);
+        } else {
+            active_.erase(timer.id);
+        }
+    }
+}
+
+} // namespace data_bridge
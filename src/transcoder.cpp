@@ -0,0 +1,598 @@
+#include "transcoder.h"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace data_bridge {
+
+namespace {
+
+constexpr uint32_t kWireVarint = 0;
+constexpr uint32_t kWireFixed64 = 1;
+constexpr uint32_t kWireLengthDelimited = 2;
+constexpr uint32_t kWireFixed32 = 5;
+
+// CDR encapsulation identifiers, followed by two option bytes
+constexpr uint8_t kCdrBigEndian = 0x00;
+constexpr uint8_t kCdrLittleEndian = 0x01;
+constexpr size_t kCdrHeaderSize = 4;
+
+// Longest JSON number written, shortest round-trip form of a double
+constexpr size_t kMaxJsonNumber = 32;
+
+size_t varintSize(uint64_t value) {
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        size++;
+    }
+    return size;
+}
+
+uint8_t* writeVarint(uint64_t value, uint8_t* out) {
+    while (value >= 0x80) {
+        *out++ = static_cast<uint8_t>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+}
+
+bool readVarint(const uint8_t* data, size_t size, size_t& pos, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && pos < size; shift += 7) {
+        uint8_t byte = data[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t wireType(FieldType type) {
+    switch (type) {
+        case FieldType::FLOAT: return kWireFixed32;
+        case FieldType::DOUBLE: return kWireFixed64;
+        default: return kWireVarint;
+    }
+}
+
+bool isInteger(FieldType type) {
+    return type != FieldType::FLOAT && type != FieldType::DOUBLE;
+}
+
+bool isSigned(FieldType type) {
+    return type == FieldType::INT32 || type == FieldType::INT64;
+}
+
+// Field sizes are powers of two
+size_t alignCdr(size_t pos, size_t size) {
+    return (pos + size - 1) & ~(size - 1);
+}
+
+bool isWhitespace(uint8_t c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void skipWhitespace(const uint8_t* data, size_t size, size_t& pos) {
+    while (pos < size && isWhitespace(data[pos])) {
+        pos++;
+    }
+}
+
+// Skip a JSON string starting at its opening quote
+bool skipString(const uint8_t* data, size_t size, size_t& pos) {
+    for (pos++; pos < size; pos++) {
+        if (data[pos] == '\\') {
+            pos++;
+        } else if (data[pos] == '"') {
+            pos++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Skip any JSON value, nested objects and arrays included
+bool skipValue(const uint8_t* data, size_t size, size_t& pos) {
+    int depth = 0;
+    while (pos < size) {
+        uint8_t c = data[pos];
+        if (c == '"') {
+            if (!skipString(data, size, pos)) {
+                return false;
+            }
+        } else if (c == '{' || c == '[') {
+            depth++;
+            pos++;
+        } else if (c == '}' || c == ']') {
+            if (depth == 0) {
+                return true;
+            }
+            depth--;
+            pos++;
+        } else if (c == ',' && depth == 0) {
+            return true;
+        } else {
+            pos++;
+        }
+        if (depth == 0 && pos < size && (data[pos] == ',' || data[pos] == '}' || isWhitespace(data[pos]))) {
+            return true;
+        }
+    }
+    return depth == 0;
+}
+
+} // namespace
+
+Transcoder::Transcoder(const StreamConfig& config)
+    : schema_name_(config.transcode_schema),
+      from_(config.transcode_from),
+      to_(config.transcode_to),
+      field_names_(config.transcode_fields) {
+}
+
+bool Transcoder::init() {
+    schema_ = findSchema(schema_name_);
+    if (!schema_) {
+        std::cerr << "[Transcoder] Unknown schema '" << schema_name_ << "', compiled schemas: "
+                  << schemaNames() << std::endl;
+        return false;
+    }
+
+    selected_.clear();
+    for (const auto& name : field_names_) {
+        size_t hint = 0;
+        int index = findField(name.data(), name.size(), hint);
+        if (index < 0) {
+            std::cerr << "[Transcoder] Schema '" << schema_name_ << "' has no field '" << name << "'" << std::endl;
+            return false;
+        }
+        selected_.push_back(static_cast<uint16_t>(index));
+    }
+    if (selected_.empty()) {
+        for (size_t i = 0; i < schema_->field_count; ++i) {
+            selected_.push_back(static_cast<uint16_t>(i));
+        }
+    }
+    std::sort(selected_.begin(), selected_.end());
+    selected_.erase(std::unique(selected_.begin(), selected_.end()), selected_.end());
+
+    if (from_ == to_ && selected_.size() == schema_->field_count) {
+        std::cerr << "[Transcoder] Schema '" << schema_name_ << "': same format on both sides and no projection"
+                  << std::endl;
+        return false;
+    }
+
+    max_output_ = 0;
+    switch (to_) {
+        case PayloadFormat::STRUCT:
+            for (auto index : selected_) {
+                max_output_ += schema_->fields[index].size;
+            }
+            break;
+        case PayloadFormat::PROTOBUF:
+            for (auto index : selected_) {
+                const auto& field = schema_->fields[index];
+                max_output_ += varintSize(static_cast<uint64_t>(field.number) << 3) + 10;
+            }
+            break;
+        case PayloadFormat::CDR:
+            max_output_ = kCdrHeaderSize;
+            for (auto index : selected_) {
+                max_output_ += schema_->fields[index].size + 7;
+            }
+            break;
+        case PayloadFormat::JSON:
+            max_output_ = 2;
+            for (auto index : selected_) {
+                max_output_ += std::strlen(schema_->fields[index].name) + 4 + kMaxJsonNumber;
+            }
+            break;
+    }
+    return true;
+}
+
+bool Transcoder::transcode(ByteView input, PayloadBuffer& out) const {
+    FieldValue values[kMaxSchemaFields];
+    return decode(input, values) && encode(values, out);
+}
+
+bool Transcoder::encode(const FieldValue* values, PayloadBuffer& out) const {
+    out = PayloadBuffer::allocate(max_output_);
+    if (!out) {
+        return false;
+    }
+    return out.resize(encodeFormat(values, out.data()));
+}
+
+std::string Transcoder::describe() const {
+    std::string text = schema_name_ + ": " + formatName(from_) + " -> " + formatName(to_);
+    if (schema_ && selected_.size() < schema_->field_count) {
+        text += ", " + std::to_string(selected_.size()) + " of " + std::to_string(schema_->field_count) + " fields";
+    }
+    return text;
+}
+
+bool Transcoder::parseFormat(const std::string& name, PayloadFormat& format) {
+    if (name == "struct") {
+        format = PayloadFormat::STRUCT;
+    } else if (name == "protobuf") {
+        format = PayloadFormat::PROTOBUF;
+    } else if (name == "cdr") {
+        format = PayloadFormat::CDR;
+    } else if (name == "json") {
+        format = PayloadFormat::JSON;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* Transcoder::formatName(PayloadFormat format) {
+    switch (format) {
+        case PayloadFormat::STRUCT: return "struct";
+        case PayloadFormat::PROTOBUF: return "protobuf";
+        case PayloadFormat::CDR: return "cdr";
+        default: return "json";
+    }
+}
+
+bool Transcoder::decode(ByteView input, FieldValue* values) const {
+    // Absent protobuf and JSON fields read as zero
+    std::memset(values, 0, schema_->field_count * sizeof(FieldValue));
+    switch (from_) {
+        case PayloadFormat::STRUCT: return decodeStruct(input, values);
+        case PayloadFormat::PROTOBUF: return decodeProtobuf(input, values);
+        case PayloadFormat::CDR: return decodeCdr(input, values);
+        default: return decodeJson(input, values);
+    }
+}
+
+size_t Transcoder::encodeFormat(const FieldValue* values, uint8_t* out) const {
+    switch (to_) {
+        case PayloadFormat::STRUCT: return encodeStruct(values, out);
+        case PayloadFormat::PROTOBUF: return encodeProtobuf(values, out);
+        case PayloadFormat::CDR: return encodeCdr(values, out);
+        default: return encodeJson(values, out);
+    }
+}
+
+bool Transcoder::decodeStruct(ByteView input, FieldValue* values) const {
+    if (input.size != schema_->struct_size) {
+        return false;
+    }
+
+    // Every field, content filters may test fields that are not written
+    for (size_t i = 0; i < schema_->field_count; ++i) {
+        const auto& field = schema_->fields[i];
+        values[i] = loadFieldValue(field.type, input.data + field.offset);
+    }
+    return true;
+}
+
+bool Transcoder::decodeProtobuf(ByteView input, FieldValue* values) const {
+    const uint8_t* data = input.data;
+    size_t size = input.size;
+    size_t pos = 0;
+    size_t hint = 0;
+
+    while (pos < size) {
+        uint64_t key;
+        if (!readVarint(data, size, pos, key)) {
+            return false;
+        }
+        uint32_t wire = static_cast<uint32_t>(key & 7);
+        int index = findField(static_cast<uint32_t>(key >> 3), hint);
+        const SchemaField* field = index >= 0 ? &schema_->fields[index] : nullptr;
+
+        // A known field with another wire type does not match the schema
+        if (field && wireType(field->type) != wire) {
+            return false;
+        }
+
+        switch (wire) {
+            case kWireVarint: {
+                uint64_t raw;
+                if (!readVarint(data, size, pos, raw)) {
+                    return false;
+                }
+                if (!field) {
+                    break;
+                }
+                switch (field->type) {
+                    case FieldType::INT32: values[index].i = static_cast<int32_t>(raw); break;
+                    case FieldType::INT64: values[index].i = static_cast<int64_t>(raw); break;
+                    case FieldType::UINT32: values[index].u = static_cast<uint32_t>(raw); break;
+                    case FieldType::BOOL: values[index].u = raw != 0; break;
+                    default: values[index].u = raw; break;
+                }
+                break;
+            }
+            case kWireFixed64:
+                if (size - pos < 8) {
+                    return false;
+                }
+                if (field) {
+                    std::memcpy(&values[index].d, data + pos, 8);
+                }
+                pos += 8;
+                break;
+            case kWireFixed32:
+                if (size - pos < 4) {
+                    return false;
+                }
+                if (field) {
+                    values[index] = loadFieldValue(FieldType::FLOAT, data + pos);
+                }
+                pos += 4;
+                break;
+            case kWireLengthDelimited: {
+                uint64_t length;
+                if (!readVarint(data, size, pos, length) || length > size - pos) {
+                    return false;
+                }
+                pos += length;
+                break;
+            }
+            default:
+                return false;
+        }
+    }
+    return true;
+}
+
+bool Transcoder::decodeCdr(ByteView input, FieldValue* values) const {
+    if (input.size < kCdrHeaderSize || input.data[0] != 0 ||
+        (input.data[1] != kCdrLittleEndian && input.data[1] != kCdrBigEndian)) {
+        return false;
+    }
+    bool swap = input.data[1] == kCdrBigEndian;
+    const uint8_t* data = input.data + kCdrHeaderSize;
+    size_t size = input.size - kCdrHeaderSize;
+
+    // Every field is present, aligned to its size from the end of the header
+    size_t pos = 0;
+    uint8_t swapped[8];
+    for (size_t i = 0; i < schema_->field_count; ++i) {
+        const auto& field = schema_->fields[i];
+        pos = alignCdr(pos, field.size);
+        if (size < field.size || pos > size - field.size) {
+            return false;
+        }
+        const uint8_t* bytes = data + pos;
+        if (swap && field.size > 1) {
+            std::reverse_copy(bytes, bytes + field.size, swapped);
+            bytes = swapped;
+        }
+        values[i] = loadFieldValue(field.type, bytes);
+        pos += field.size;
+    }
+    return true;
+}
+
+bool Transcoder::decodeJson(ByteView input, FieldValue* values) const {
+    const uint8_t* data = input.data;
+    size_t size = input.size;
+    size_t pos = 0;
+    size_t hint = 0;
+
+    skipWhitespace(data, size, pos);
+    if (pos >= size || data[pos] != '{') {
+        return false;
+    }
+    pos++;
+    skipWhitespace(data, size, pos);
+    if (pos < size && data[pos] == '}') {
+        return true;
+    }
+
+    while (pos < size) {
+        if (data[pos] != '"') {
+            return false;
+        }
+        size_t key_start = pos + 1;
+        if (!skipString(data, size, pos)) {
+            return false;
+        }
+        int index = findField(reinterpret_cast<const char*>(data + key_start), pos - key_start - 1, hint);
+
+        skipWhitespace(data, size, pos);
+        if (pos >= size || data[pos] != ':') {
+            return false;
+        }
+        pos++;
+        skipWhitespace(data, size, pos);
+
+        if (index < 0) {
+            if (!skipValue(data, size, pos)) {
+                return false;
+            }
+        } else {
+            size_t start = pos;
+            while (pos < size && data[pos] != ',' && data[pos] != '}' && !isWhitespace(data[pos])) {
+                pos++;
+            }
+            const char* first = reinterpret_cast<const char*>(data + start);
+            const char* last = reinterpret_cast<const char*>(data + pos);
+            size_t length = pos - start;
+            FieldType type = schema_->fields[index].type;
+            FieldValue& value = values[index];
+
+            if (length == 4 && std::memcmp(first, "true", 4) == 0) {
+                if (isInteger(type)) {
+                    value.u = 1;
+                } else {
+                    value.d = 1.0;
+                }
+            } else if ((length == 5 && std::memcmp(first, "false", 5) == 0) ||
+                       (length == 4 && std::memcmp(first, "null", 4) == 0)) {
+                value.u = 0;
+            } else if (!isInteger(type)) {
+                auto result = std::from_chars(first, last, value.d);
+                if (result.ec != std::errc() || result.ptr != last) {
+                    return false;
+                }
+            } else {
+                // Integers written as 1.0 or 1e3 are truncated
+                auto result = isSigned(type) ? std::from_chars(first, last, value.i)
+                                             : std::from_chars(first, last, value.u);
+                if (result.ec != std::errc() || result.ptr != last) {
+                    double real;
+                    result = std::from_chars(first, last, real);
+                    if (result.ec != std::errc() || result.ptr != last) {
+                        return false;
+                    }
+                    if (isSigned(type)) {
+                        value.i = static_cast<int64_t>(real);
+                    } else {
+                        value.u = real > 0 ? static_cast<uint64_t>(real) : 0;
+                    }
+                }
+                if (type == FieldType::BOOL) {
+                    value.u = value.u != 0;
+                }
+            }
+        }
+
+        skipWhitespace(data, size, pos);
+        if (pos >= size) {
+            return false;
+        }
+        if (data[pos] == '}') {
+            return true;
+        }
+        if (data[pos] != ',') {
+            return false;
+        }
+        pos++;
+        skipWhitespace(data, size, pos);
+    }
+    return false;
+}
+
+size_t Transcoder::encodeStruct(const FieldValue* values, uint8_t* out) const {
+    uint8_t* cursor = out;
+    for (auto index : selected_) {
+        cursor += storeFieldValue(schema_->fields[index].type, values[index], cursor);
+    }
+    return cursor - out;
+}
+
+size_t Transcoder::encodeProtobuf(const FieldValue* values, uint8_t* out) const {
+    uint8_t* cursor = out;
+    for (auto index : selected_) {
+        const auto& field = schema_->fields[index];
+        const FieldValue& value = values[index];
+        if (value.u == 0) {
+            continue;
+        }
+        uint32_t wire = wireType(field.type);
+        cursor = writeVarint((static_cast<uint64_t>(field.number) << 3) | wire, cursor);
+        if (wire == kWireVarint) {
+            // Negative int32 values are sign-extended to ten bytes, as protobuf does
+            cursor = writeVarint(value.u, cursor);
+        } else {
+            cursor += storeFieldValue(field.type, value, cursor);
+        }
+    }
+    return cursor - out;
+}
+
+size_t Transcoder::encodeCdr(const FieldValue* values, uint8_t* out) const {
+    out[0] = 0;
+    out[1] = kCdrLittleEndian;
+    out[2] = 0;
+    out[3] = 0;
+    uint8_t* data = out + kCdrHeaderSize;
+    size_t pos = 0;
+    for (auto index : selected_) {
+        const auto& field = schema_->fields[index];
+        size_t aligned = alignCdr(pos, field.size);
+        std::memset(data + pos, 0, aligned - pos);
+        pos = aligned + storeFieldValue(field.type, values[index], data + aligned);
+    }
+    return kCdrHeaderSize + pos;
+}
+
+size_t Transcoder::encodeJson(const FieldValue* values, uint8_t* out) const {
+    char* cursor = reinterpret_cast<char*>(out);
+    *cursor++ = '{';
+    bool first = true;
+    for (auto index : selected_) {
+        const auto& field = schema_->fields[index];
+        const FieldValue& value = values[index];
+        if (!first) {
+            *cursor++ = ',';
+        }
+        first = false;
+        *cursor++ = '"';
+        size_t name_length = std::strlen(field.name);
+        std::memcpy(cursor, field.name, name_length);
+        cursor += name_length;
+        *cursor++ = '"';
+        *cursor++ = ':';
+
+        char* last = cursor + kMaxJsonNumber;
+        switch (field.type) {
+            case FieldType::BOOL:
+                std::memcpy(cursor, value.u ? "true" : "false", value.u ? 4 : 5);
+                cursor += value.u ? 4 : 5;
+                break;
+            case FieldType::INT32:
+            case FieldType::INT64:
+                cursor = std::to_chars(cursor, last, value.i).ptr;
+                break;
+            case FieldType::UINT32:
+            case FieldType::UINT64:
+                cursor = std::to_chars(cursor, last, value.u).ptr;
+                break;
+            default:
+                // JSON has no NaN or infinity
+                if (!std::isfinite(value.d)) {
+                    std::memcpy(cursor, "null", 4);
+                    cursor += 4;
+                } else if (field.type == FieldType::FLOAT) {
+                    cursor = std::to_chars(cursor, last, static_cast<float>(value.d)).ptr;
+                } else {
+                    cursor = std::to_chars(cursor, last, value.d).ptr;
+                }
+                break;
+        }
+    }
+    *cursor++ = '}';
+    return cursor - reinterpret_cast<char*>(out);
+}
+
+int Transcoder::findField(uint32_t number, size_t& hint) const {
+    size_t count = schema_->field_count;
+    for (size_t i = 0, index = hint < count ? hint : 0; i < count; ++i, ++index) {
+        if (index == count) {
+            index = 0;
+        }
+        if (schema_->fields[index].number == number) {
+            hint = index + 1;
+            return static_cast<int>(index);
+        }
+    }
+    return -1;
+}
+
+int Transcoder::findField(const char* name, size_t len, size_t& hint) const {
+    size_t count = schema_->field_count;
+    for (size_t i = 0, index = hint < count ? hint : 0; i < count; ++i, ++index) {
+        if (index == count) {
+            index = 0;
+        }
+        const char* field = schema_->fields[index].name;
+        if (std::strncmp(field, name, len) == 0 && field[len] == '\0') {
+            hint = index + 1;
+            return static_cast<int>(index);
+        }
+    }
+    return -1;
+}
+
+} // namespace data_bridge
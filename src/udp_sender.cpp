@@ -0,0 +1,257 @@
+#include "udp_sender.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <sys/socket.h>
+#include <netinet/udp.h>
+#include <linux/errqueue.h>
+
+namespace data_bridge {
+
+namespace {
+
+// Kernel limits for one GSO send (UDP_MAX_SEGMENTS and the IPv4 UDP payload)
+constexpr size_t kMaxSegments = 64;
+constexpr size_t kMaxGsoBytes = 65507;
+
+// Datagrams per sendmmsg call
+constexpr size_t kMaxBatch = 64;
+
+// Outstanding zerocopy sends before falling back to copying
+constexpr size_t kMaxPendingZeroCopy = 256;
+
+} // namespace
+
+UdpSender::UdpSender(int fd, const sockaddr_in& addr, bool connected, bool gso, size_t zerocopy_threshold)
+    : fd_(fd),
+      addr_(addr),
+      name_(connected ? nullptr : &addr_),
+      gso_(gso),
+      zerocopy_threshold_(zerocopy_threshold) {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    if (zerocopy_threshold_ > 0) {
+        int enable = 1;
+        if (setsockopt(fd_, SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)) < 0) {
+            std::cerr << "[UdpSender] MSG_ZEROCOPY not supported: " << strerror(errno) << std::endl;
+            zerocopy_threshold_ = 0;
+        }
+    }
+#else
+    zerocopy_threshold_ = 0;
+#endif
+#ifndef UDP_SEGMENT
+    gso_ = false;
+#endif
+    pending_.reserve(kMaxPendingZeroCopy);
+}
+
+ssize_t UdpSender::send(const uint8_t* data, size_t len, int flags) {
+    ssize_t sent = sendto(fd_, data, len, flags, reinterpret_cast<const sockaddr*>(name_),
+                          name_ ? sizeof(addr_) : 0);
+
+    // A connected socket reports an earlier ICMP port unreachable once, e.g.
+    // while the consumer was restarting; the error is consumed, so retry
+    if (sent < 0 && errno == ECONNREFUSED && !name_) {
+        sent = sendto(fd_, data, len, flags, nullptr, 0);
+    }
+    return sent;
+}
+
+bool UdpSender::sendZeroCopy(const uint8_t* data, size_t len, const PayloadBuffer& owner) {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    if (!wantsZeroCopy(len) || !owner) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(zerocopy_mutex_);
+    reapCompletions();
+
+    if (pending_.size() >= kMaxPendingZeroCopy) {
+        zerocopy_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    iovec iov{const_cast<uint8_t*>(data), len};
+    msghdr msg{};
+    msg.msg_name = name_;
+    msg.msg_namelen = name_ ? sizeof(addr_) : 0;
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+
+    // ENOBUFS when the socket's optmem for notifications is exhausted
+    if (sendmsg(fd_, &msg, MSG_ZEROCOPY) < 0) {
+        zerocopy_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    pending_.push_back({next_zerocopy_id_++, owner});
+    zerocopy_sends_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+#else
+    (void)data;
+    (void)len;
+    (void)owner;
+    return false;
+#endif
+}
+
+void UdpSender::reapCompletions() {
+#if defined(SO_ZEROCOPY) && defined(MSG_ZEROCOPY)
+    while (!pending_.empty()) {
+        char control[128];
+        msghdr msg{};
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        if (recvmsg(fd_, &msg, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) {
+            return;
+        }
+
+        for (cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+            if (cmsg->cmsg_level != SOL_IP || cmsg->cmsg_type != IP_RECVERR) {
+                continue;
+            }
+
+            sock_extended_err err;
+            memcpy(&err, CMSG_DATA(cmsg), sizeof(err));
+            if (err.ee_origin != SO_EE_ORIGIN_ZEROCOPY || err.ee_errno != 0) {
+                continue;
+            }
+
+            // Notifications cover the inclusive id range [ee_info, ee_data]
+            uint32_t first = err.ee_info;
+            uint32_t span = err.ee_data - first;
+            if (err.ee_code & SO_EE_CODE_ZEROCOPY_COPIED) {
+                zerocopy_copied_.fetch_add(span + 1, std::memory_order_relaxed);
+            }
+
+            pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                          [first, span](const PendingZeroCopy& pending) {
+                                              return pending.id - first <= span;
+                                          }),
+                           pending_.end());
+        }
+    }
+#endif
+}
+
+size_t UdpSender::sendBatch(const ByteView* items, size_t count, int flags) {
+    size_t sent = 0;
+    size_t i = 0;
+
+    while (i < count) {
+        // Length of the equal-size run starting at i
+        size_t run = 1;
+        if (gso_ && items[i].size > 0) {
+            while (i + run < count && run < kMaxSegments &&
+                   items[i + run].size == items[i].size &&
+                   (run + 1) * items[i].size <= kMaxGsoBytes) {
+                run++;
+            }
+        }
+
+        if (run >= 2) {
+            size_t done = sendSegments(items + i, run, flags);
+            if (done == 0 && !gso_) {
+                continue;       // GSO just turned out unsupported, resend the run below
+            }
+            sent += done;
+            i += run;
+            continue;
+        }
+
+        // Collect datagrams up to the next equal-size run
+        size_t end = i + 1;
+        while (end < count && end - i < kMaxBatch &&
+               !(gso_ && end + 1 < count && items[end].size > 0 && items[end].size == items[end + 1].size)) {
+            end++;
+        }
+        sent += sendMultiple(items + i, end - i, flags);
+        i = end;
+    }
+
+    return sent;
+}
+
+size_t UdpSender::sendSegments(const ByteView* items, size_t count, int flags) {
+#ifdef UDP_SEGMENT
+    iovec iovs[kMaxSegments];
+    for (size_t i = 0; i < count; ++i) {
+        iovs[i].iov_base = const_cast<uint8_t*>(items[i].data);
+        iovs[i].iov_len = items[i].size;
+    }
+
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(uint16_t))] = {};
+    msghdr msg{};
+    msg.msg_name = name_;
+    msg.msg_namelen = name_ ? sizeof(addr_) : 0;
+    msg.msg_iov = iovs;
+    msg.msg_iovlen = count;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+    uint16_t segment_size = static_cast<uint16_t>(items[0].size);
+    memcpy(CMSG_DATA(cmsg), &segment_size, sizeof(segment_size));
+
+    if (sendmsg(fd_, &msg, flags) < 0) {
+        // Kernels or devices without UDP GSO reject the control message
+        if (errno == EINVAL || errno == EIO || errno == EOPNOTSUPP || errno == ENOPROTOOPT) {
+            std::cerr << "[UdpSender] UDP GSO not supported (" << strerror(errno)
+                      << "), using sendmmsg" << std::endl;
+            gso_ = false;
+        }
+        return 0;
+    }
+
+    gso_batches_.fetch_add(1, std::memory_order_relaxed);
+    gso_datagrams_.fetch_add(count, std::memory_order_relaxed);
+    return count;
+#else
+    (void)items;
+    (void)count;
+    (void)flags;
+    return 0;
+#endif
+}
+
+size_t UdpSender::sendMultiple(const ByteView* items, size_t count, int flags) {
+    mmsghdr msgs[kMaxBatch];
+    iovec iovs[kMaxBatch];
+    count = std::min(count, kMaxBatch);
+
+    for (size_t i = 0; i < count; ++i) {
+        iovs[i].iov_base = const_cast<uint8_t*>(items[i].data);
+        iovs[i].iov_len = items[i].size;
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name = name_;
+        msgs[i].msg_hdr.msg_namelen = name_ ? sizeof(addr_) : 0;
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    size_t sent = 0;
+    while (sent < count) {
+        int ret = sendmmsg(fd_, msgs + sent, static_cast<unsigned>(count - sent), flags);
+        if (ret <= 0) {
+            break;
+        }
+        sent += ret;
+    }
+    return sent;
+}
+
+UdpSenderStats UdpSender::getStats() const {
+    UdpSenderStats stats;
+    stats.gso_batches = gso_batches_.load(std::memory_order_relaxed);
+    stats.gso_datagrams = gso_datagrams_.load(std::memory_order_relaxed);
+    stats.zerocopy_sends = zerocopy_sends_.load(std::memory_order_relaxed);
+    stats.zerocopy_copied = zerocopy_copied_.load(std::memory_order_relaxed);
+    stats.zerocopy_fallbacks = zerocopy_fallbacks_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace data_bridge
@@ -0,0 +1,557 @@
+#include "uring_egress.h"
+#include "thread_placement.h"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#ifdef DATA_BRIDGE_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#endif
+
+namespace data_bridge {
+
+namespace {
+
+// user_data of the eventfd read that wakes the submission thread
+constexpr uint64_t kWakeupTag = ~0ULL;
+
+size_t roundUpPowerOfTwo(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+#ifdef DATA_BRIDGE_HAVE_IO_URING
+
+int ioUringSetup(unsigned entries, io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+int ioUringEnter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0));
+}
+
+int ioUringRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+// Opcodes the running kernel implements, empty if it cannot tell (before 5.6, which also lacks READ)
+std::vector<bool> probeOpcodes(int ring_fd) {
+    std::vector<uint8_t> buffer(sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op));
+    auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+    if (ioUringRegister(ring_fd, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) < 0) {
+        return {};
+    }
+    std::vector<bool> supported(IORING_OP_LAST, false);
+    for (unsigned op = 0; op <= probe->last_op && op < IORING_OP_LAST; ++op) {
+        supported[op] = (probe->ops[op].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+    return supported;
+}
+
+#endif
+
+} // namespace
+
+#ifdef DATA_BRIDGE_HAVE_IO_URING
+
+struct UringEgress::Ring {
+    int fd = -1;
+
+    void* sq_map = nullptr;
+    size_t sq_map_size = 0;
+    void* cq_map = nullptr;
+    size_t cq_map_size = 0;
+    io_uring_sqe* sqes = nullptr;
+    size_t sqes_size = 0;
+
+    std::atomic<uint32_t>* sq_head = nullptr;
+    std::atomic<uint32_t>* sq_tail = nullptr;
+    uint32_t sq_mask = 0;
+    uint32_t sq_entries = 0;
+    uint32_t* sq_array = nullptr;
+    uint32_t sq_local_tail = 0;
+
+    std::atomic<uint32_t>* cq_head = nullptr;
+    std::atomic<uint32_t>* cq_tail = nullptr;
+    uint32_t cq_mask = 0;
+    io_uring_cqe* cqes = nullptr;
+
+    ~Ring() {
+        if (sqes) {
+            munmap(sqes, sqes_size);
+        }
+        if (cq_map && cq_map != sq_map) {
+            munmap(cq_map, cq_map_size);
+        }
+        if (sq_map) {
+            munmap(sq_map, sq_map_size);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    bool open(unsigned entries, unsigned cq_entries) {
+        io_uring_params params{};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = cq_entries;
+
+        fd = ioUringSetup(entries, &params);
+        if (fd < 0) {
+            return false;
+        }
+
+        sq_map_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        cq_map_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool single_map = params.features & IORING_FEAT_SINGLE_MMAP;
+        if (single_map) {
+            sq_map_size = cq_map_size = std::max(sq_map_size, cq_map_size);
+        }
+
+        sq_map = mmap(nullptr, sq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      fd, IORING_OFF_SQ_RING);
+        if (sq_map == MAP_FAILED) {
+            sq_map = nullptr;
+            return false;
+        }
+
+        if (single_map) {
+            cq_map = sq_map;
+        } else {
+            cq_map = mmap(nullptr, cq_map_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          fd, IORING_OFF_CQ_RING);
+            if (cq_map == MAP_FAILED) {
+                cq_map = nullptr;
+                return false;
+            }
+        }
+
+        sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes_map = mmap(nullptr, sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                              fd, IORING_OFF_SQES);
+        if (sqes_map == MAP_FAILED) {
+            return false;
+        }
+        sqes = static_cast<io_uring_sqe*>(sqes_map);
+
+        auto* sq = static_cast<uint8_t*>(sq_map);
+        sq_head = reinterpret_cast<std::atomic<uint32_t>*>(sq + params.sq_off.head);
+        sq_tail = reinterpret_cast<std::atomic<uint32_t>*>(sq + params.sq_off.tail);
+        sq_mask = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_mask);
+        sq_entries = *reinterpret_cast<uint32_t*>(sq + params.sq_off.ring_entries);
+        sq_array = reinterpret_cast<uint32_t*>(sq + params.sq_off.array);
+        sq_local_tail = sq_tail->load(std::memory_order_relaxed);
+
+        auto* cq = static_cast<uint8_t*>(cq_map);
+        cq_head = reinterpret_cast<std::atomic<uint32_t>*>(cq + params.cq_off.head);
+        cq_tail = reinterpret_cast<std::atomic<uint32_t>*>(cq + params.cq_off.tail);
+        cq_mask = *reinterpret_cast<uint32_t*>(cq + params.cq_off.ring_mask);
+        cqes = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return true;
+    }
+
+    // Next free SQE, nullptr if the submission queue is full
+    io_uring_sqe* nextSqe() {
+        uint32_t head = sq_head->load(std::memory_order_acquire);
+        if (sq_local_tail - head >= sq_entries) {
+            return nullptr;
+        }
+        uint32_t index = sq_local_tail & sq_mask;
+        sq_array[index] = index;
+        sq_local_tail++;
+
+        io_uring_sqe* sqe = &sqes[index];
+        memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    // Make prepared SQEs visible to the kernel
+    void publish() {
+        sq_tail->store(sq_local_tail, std::memory_order_release);
+    }
+
+    // Published SQEs the kernel has not consumed yet
+    unsigned unsubmitted() const {
+        return sq_local_tail - sq_head->load(std::memory_order_acquire);
+    }
+};
+
+#else
+
+struct UringEgress::Ring {
+};
+
+#endif
+
+UringEgress::UringEgress(size_t queue_depth, size_t buffer_size, size_t zerocopy_threshold)
+    : buffer_size_(buffer_size),
+      zerocopy_threshold_(zerocopy_threshold),
+      slots_(roundUpPowerOfTwo(std::max<size_t>(queue_depth, 2))),
+      slot_mask_(slots_.size() - 1) {
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+UringEgress::~UringEgress() {
+    stop();
+}
+
+bool UringEgress::isAvailable() {
+#ifdef DATA_BRIDGE_HAVE_IO_URING
+    Ring probe;
+    return probe.open(2, 4);
+#else
+    return false;
+#endif
+}
+
+int UringEgress::registerSocket(int fd) {
+    if (running_) {
+        std::cerr << "[UringEgress] Sockets must be registered before start" << std::endl;
+        return -1;
+    }
+    sockets_.push_back(fd);
+    return static_cast<int>(sockets_.size() - 1);
+}
+
+bool UringEgress::start() {
+#ifdef DATA_BRIDGE_HAVE_IO_URING
+    if (running_) {
+        std::cerr << "[UringEgress] Already running" << std::endl;
+        return false;
+    }
+    if (sockets_.empty()) {
+        std::cerr << "[UringEgress] No sockets registered" << std::endl;
+        return false;
+    }
+
+    // One request per slot plus the wakeup read, zero-copy sends complete twice
+    ring_ = std::make_unique<Ring>();
+    if (!ring_->open(static_cast<unsigned>(slots_.size() + 1),
+                     static_cast<unsigned>(slots_.size() * 2 + 2))) {
+        std::cerr << "[UringEgress] Failed to create io_uring: " << strerror(errno) << std::endl;
+        ring_.reset();
+        return false;
+    }
+
+    // Without SENDMSG or the eventfd READ the group stays on sendto, without SEND_ZC sends are copied
+    auto supported = probeOpcodes(ring_->fd);
+    if (supported.empty() || !supported[IORING_OP_SENDMSG] || !supported[IORING_OP_READ]) {
+        std::cerr << "[UringEgress] Kernel lacks the io_uring operations needed for sends" << std::endl;
+        ring_.reset();
+        return false;
+    }
+    send_zc_ = zerocopy_threshold_ > 0 && supported[IORING_OP_SEND_ZC];
+    if (zerocopy_threshold_ > 0 && !send_zc_) {
+        std::cout << "[UringEgress] SEND_ZC not supported by this kernel, sending copies" << std::endl;
+    }
+
+    if (ioUringRegister(ring_->fd, IORING_REGISTER_FILES, sockets_.data(),
+                        static_cast<unsigned>(sockets_.size())) < 0) {
+        std::cerr << "[UringEgress] Failed to register sockets: " << strerror(errno) << std::endl;
+        ring_.reset();
+        return false;
+    }
+
+    buffer_region_size_ = slots_.size() * buffer_size_;
+    void* region = mmap(nullptr, buffer_region_size_, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+    if (region == MAP_FAILED) {
+        std::cerr << "[UringEgress] Failed to allocate buffers: " << strerror(errno) << std::endl;
+        ring_.reset();
+        return false;
+    }
+    buffer_region_ = static_cast<uint8_t*>(region);
+
+    // Registered buffers count against RLIMIT_MEMLOCK, sends still work without them
+    iovec region_iov{buffer_region_, buffer_region_size_};
+    fixed_buffers_ = ioUringRegister(ring_->fd, IORING_REGISTER_BUFFERS, &region_iov, 1) == 0;
+    if (!fixed_buffers_) {
+        std::cout << "[UringEgress] Buffer registration failed (" << strerror(errno)
+                  << "), raise RLIMIT_MEMLOCK to enable fixed buffers" << std::endl;
+    }
+
+    for (size_t i = 0; i < slots_.size(); ++i) {
+        Slot& slot = slots_[i];
+        slot.buffer = buffer_region_ + i * buffer_size_;
+        slot.iov.iov_base = slot.buffer;
+        slot.msg.msg_name = &slot.addr;
+        slot.msg.msg_namelen = sizeof(slot.addr);
+        slot.msg.msg_iov = &slot.iov;
+        slot.msg.msg_iovlen = 1;
+    }
+
+    wakeup_fd_ = eventfd(0, EFD_CLOEXEC);
+    if (wakeup_fd_ < 0) {
+        std::cerr << "[UringEgress] Failed to create eventfd: " << strerror(errno) << std::endl;
+        munmap(buffer_region_, buffer_region_size_);
+        buffer_region_ = nullptr;
+        ring_.reset();
+        return false;
+    }
+
+    wakeup_armed_ = false;
+    running_ = true;
+    submit_thread_ = std::thread(&UringEgress::submitLoop, this);
+
+    std::cout << "[UringEgress] Started: " << slots_.size() << " slots x " << buffer_size_ << " bytes, "
+              << sockets_.size() << " socket(s)"
+              << (fixed_buffers_ ? ", fixed buffers" : "") << (send_zc_ ? ", SEND_ZC" : "") << std::endl;
+    return true;
+#else
+    std::cerr << "[UringEgress] io_uring support not compiled in" << std::endl;
+    return false;
+#endif
+}
+
+void UringEgress::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    // Wake the submission thread, it drains queued and in-flight sends before exiting
+    uint64_t one = 1;
+    if (write(wakeup_fd_, &one, sizeof(one)) < 0) {
+        std::cerr << "[UringEgress] Failed to wake submission thread: " << strerror(errno) << std::endl;
+    }
+
+    if (submit_thread_.joinable()) {
+        submit_thread_.join();
+    }
+
+    // Closing the ring cancels the outstanding wakeup read
+    ring_.reset();
+    close(wakeup_fd_);
+    wakeup_fd_ = -1;
+    munmap(buffer_region_, buffer_region_size_);
+    buffer_region_ = nullptr;
+}
+
+bool UringEgress::send(int handle, const sockaddr_in& addr, const uint8_t* data, size_t len) {
+    if (!running_ || len > buffer_size_ || handle < 0 ||
+        static_cast<size_t>(handle) >= sockets_.size()) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Claim a slot, a slot still in flight counts as full
+    Slot* slot;
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    for (;;) {
+        slot = &slots_[pos & slot_mask_];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            rejected_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    memcpy(slot->buffer, data, len);
+    slot->handle = handle;
+    slot->size = len;
+    slot->addr = addr;
+    slot->iov.iov_len = len;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    submitted_.fetch_add(1, std::memory_order_relaxed);
+
+    // One eventfd write per batch: the flag stays set until the thread wakes
+    if (!wakeup_pending_.exchange(true, std::memory_order_acq_rel)) {
+        uint64_t one = 1;
+        if (write(wakeup_fd_, &one, sizeof(one)) < 0) {
+            std::cerr << "[UringEgress] Failed to wake submission thread: " << strerror(errno) << std::endl;
+        }
+    }
+    return true;
+}
+
+EgressStats UringEgress::getStats() const {
+    EgressStats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.completed = completed_.load(std::memory_order_relaxed);
+    stats.failed = failed_.load(std::memory_order_relaxed);
+    stats.zerocopy = zerocopy_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.batches = batches_.load(std::memory_order_relaxed);
+    stats.last_error = last_error_.load(std::memory_order_relaxed);
+    return stats;
+}
+
+#ifdef DATA_BRIDGE_HAVE_IO_URING
+
+void UringEgress::submitLoop() {
+    ThreadRegistration registration("uring-egress");
+
+    for (;;) {
+        // Before queueing sends, so they cannot take the last submission entry
+        if (running_ && !wakeup_armed_) {
+            wakeup_armed_ = armWakeup();
+        }
+
+        bool stopping = !running_;
+        unsigned queued = queuePending();
+        if (stopping && queued == 0 && inflight_ == 0) {
+            break;
+        }
+        unsigned to_submit = ring_->unsubmitted();
+
+        // Sleep until a send completes or a producer writes the eventfd
+        int ret = ioUringEnter(ring_->fd, to_submit, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+            std::cerr << "[UringEgress] io_uring_enter failed: " << strerror(errno) << std::endl;
+            break;
+        }
+        if (queued > 0) {
+            batches_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        reapCompletions();
+    }
+}
+
+unsigned UringEgress::queuePending() {
+    unsigned count = 0;
+
+    for (;;) {
+        Slot& slot = slots_[dequeue_pos_ & slot_mask_];
+        if (slot.sequence.load(std::memory_order_acquire) != dequeue_pos_ + 1) {
+            break;
+        }
+
+        io_uring_sqe* sqe = ring_->nextSqe();
+        if (!sqe) {
+            break;
+        }
+
+        slot.position = dequeue_pos_;
+        sqe->fd = slot.handle;
+        sqe->flags = IOSQE_FIXED_FILE;
+        sqe->user_data = dequeue_pos_ & slot_mask_;
+
+        if (send_zc_ && slot.size >= zerocopy_threshold_) {
+            sqe->opcode = IORING_OP_SEND_ZC;
+            sqe->addr = reinterpret_cast<uint64_t>(slot.buffer);
+            sqe->len = static_cast<uint32_t>(slot.size);
+            sqe->addr2 = reinterpret_cast<uint64_t>(&slot.addr);
+            sqe->addr_len = sizeof(slot.addr);
+            if (fixed_buffers_) {
+                sqe->ioprio = IORING_RECVSEND_FIXED_BUF;
+                sqe->buf_index = 0;
+            }
+            zerocopy_.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            sqe->opcode = IORING_OP_SENDMSG;
+            sqe->addr = reinterpret_cast<uint64_t>(&slot.msg);
+            sqe->len = 1;
+        }
+
+        dequeue_pos_++;
+        inflight_++;
+        count++;
+    }
+
+    if (count > 0) {
+        ring_->publish();
+    }
+    return count;
+}
+
+void UringEgress::reapCompletions() {
+    uint32_t head = ring_->cq_head->load(std::memory_order_relaxed);
+    uint32_t tail = ring_->cq_tail->load(std::memory_order_acquire);
+
+    for (; head != tail; ++head) {
+        const io_uring_cqe& cqe = ring_->cqes[head & ring_->cq_mask];
+
+        if (cqe.user_data == kWakeupTag) {
+            // Reset before the next drain so a concurrent producer writes again, the loop re-arms the read
+            wakeup_pending_.exchange(false, std::memory_order_acq_rel);
+            wakeup_armed_ = false;
+            continue;
+        }
+
+        Slot& slot = slots_[cqe.user_data & slot_mask_];
+
+        // Zero-copy sends post a second notification once the buffer is free
+        if (cqe.flags & IORING_CQE_F_NOTIF) {
+            release(slot);
+            continue;
+        }
+
+        if (cqe.res < 0) {
+            failed_.fetch_add(1, std::memory_order_relaxed);
+            last_error_.store(-cqe.res, std::memory_order_relaxed);
+        } else {
+            completed_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (!(cqe.flags & IORING_CQE_F_MORE)) {
+            release(slot);
+        }
+    }
+
+    ring_->cq_head->store(head, std::memory_order_release);
+}
+
+bool UringEgress::armWakeup() {
+    io_uring_sqe* sqe = ring_->nextSqe();
+    if (!sqe) {
+        // Full of sends not yet submitted: hand them to the kernel to make room
+        if (ioUringEnter(ring_->fd, ring_->unsubmitted(), 0, 0) < 0 && errno != EINTR && errno != EAGAIN &&
+            errno != EBUSY) {
+            std::cerr << "[UringEgress] io_uring_enter failed: " << strerror(errno) << std::endl;
+        }
+        sqe = ring_->nextSqe();
+        if (!sqe) {
+            return false;
+        }
+    }
+    sqe->opcode = IORING_OP_READ;
+    sqe->fd = wakeup_fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(&wakeup_value_);
+    sqe->len = sizeof(wakeup_value_);
+    sqe->user_data = kWakeupTag;
+    ring_->publish();
+    return true;
+}
+
+void UringEgress::release(Slot& slot) {
+    inflight_--;
+    slot.sequence.store(slot.position + slots_.size(), std::memory_order_release);
+}
+
+#else
+
+void UringEgress::submitLoop() {
+}
+
+unsigned UringEgress::queuePending() {
+    return 0;
+}
+
+void UringEgress::reapCompletions() {
+}
+
+bool UringEgress::armWakeup() {
+    return false;
+}
+
+void UringEgress::release(Slot&) {
+}
+
+#endif
+
+} // namespace data_bridge
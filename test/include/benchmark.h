@@ -6,6 +6,8 @@
 #include <chrono>
 #include <vector>
 #include <mutex>
+#include "common.h"
+#include "sequence_tracker.h"
 
 namespace benchmark {
 
@@ -14,6 +16,11 @@ struct Statistics {
     std::atomic<uint64_t> total_messages{0};
     std::atomic<uint64_t> total_bytes{0};
     std::atomic<uint64_t> dropped_messages{0};
+    std::atomic<uint64_t> skipped_messages{0};  // Not produced while no subscriber matched
+    std::atomic<uint64_t> wire_bytes{0};        // Bytes after compression (0 if disabled)
+    std::atomic<uint64_t> codec_time_ns{0};     // CPU time spent compressing
+    std::atomic<uint64_t> publish_time_ns{0};   // Time spent in put (publisher only)
+    data_bridge::SequenceStats sequence;        // Loss seen by the receiver, set when it stops
     std::chrono::steady_clock::time_point start_time;
     mutable std::chrono::steady_clock::time_point end_time;
     
@@ -23,11 +30,14 @@ struct Statistics {
     
     void reset();
     void recordMessage(size_t bytes, double latency_ms = 0.0);
+    void recordCodec(size_t wire_size, uint64_t elapsed_ns);
+    void recordPublish(uint64_t elapsed_ns);
     void printReport() const;
     double getMessagesPerSecond() const;
     double getMegabytesPerSecond() const;
     double getAverageLatencyMs() const;
     double getP99LatencyMs() const;
+    double getLatencyPercentileMs(double percentile) const;
 };
 
 // Benchmark configuration
@@ -39,6 +49,24 @@ struct BenchmarkConfig {
     size_t num_publishers = 1;            // number of concurrent publishers
     bool measure_latency = true;          // measure end-to-end latency
     bool verbose = false;                 // print detailed stats
+    
+    // Payload compression (same codec as the bridge)
+    data_bridge::CompressionType compression = data_bridge::CompressionType::NONE;
+    size_t compression_min_size = 256;    // smaller payloads are sent raw
+    int compression_level = 1;            // LZ4 acceleration / zstd level
+    std::string zstd_dictionary;          // trained zstd dictionary file
+    
+    std::string payload_capture;          // replay payloads from a capture segment instead of synthetic data
+    
+    // Checksum trailer in the last bytes of every payload (checked by streams with the same integrity)
+    data_bridge::IntegrityCheck integrity = data_bridge::IntegrityCheck::NONE;
+    
+    // Advanced publisher: cache for subscriber recovery, heartbeats for last-sample miss detection
+    bool recoverable = false;
+    size_t recovery_cache = 1000;         // samples kept for retransmission
+    uint64_t heartbeat_ms = 100;          // 0 disables heartbeats
+    
+    bool matched_only = false;            // produce nothing while no subscriber matches
 };
 
 // High-throughput data publisher for benchmarking
@@ -62,6 +90,7 @@ public:
 private:
     void publishLoop(int publisher_id);
     std::vector<uint8_t> generateTestData(size_t size);
+    std::vector<std::vector<uint8_t>> loadCapturedPayloads(const std::string& path);
     
 private:
     BenchmarkConfig config_;
@@ -91,6 +120,7 @@ private:
     int socket_{-1};
     std::atomic<bool> running_{false};
     Statistics stats_;
+    data_bridge::SequenceTracker sequence_;
     std::thread receive_thread_;
 };
 
@@ -1,8 +1,13 @@
 #include "benchmark.h"
+#include "payload_codec.h"
+#include "capture.h"
+#include "matching_gate.h"
+#include "integrity.h"
 #include <zenoh.hxx>
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
+#include <optional>
 #include <cstring>
 #include <unistd.h>
 #include <sys/socket.h>
@@ -11,11 +16,39 @@
 
 namespace benchmark {
 
+namespace {
+
+// Stamped payload layout: the bridge's SequenceHeader first, so a stream with sequence_source
+// payload_header counts benchmark traffic, then magic, flags and the send timestamp.
+// The receiver reads nothing from payloads without the magic (replayed or foreign data).
+constexpr uint32_t kStampMagic = 0x48434e42;    // "BNCH"
+constexpr uint32_t kStampTimestamp = 1;
+constexpr uint32_t kStampSequence = 2;
+constexpr size_t kMagicOffset = 16;
+constexpr size_t kFlagsOffset = 20;
+constexpr size_t kTimestampOffset = 24;
+constexpr size_t kStampedSize = 32;
+
+// Per-message copy in a pooled buffer, returned to the pool when Zenoh drops it
+zenoh::Bytes pooledBytes(const uint8_t* data, size_t size) {
+    auto buffer = data_bridge::PayloadBuffer::allocate(size);
+    std::memcpy(buffer.data(), data, size);
+    uint8_t* bytes = buffer.data();
+    return zenoh::Bytes(bytes, size, [buffer = std::move(buffer)](uint8_t*) mutable { buffer.reset(); });
+}
+
+} // namespace
+
 // Statistics implementation
 void Statistics::reset() {
     total_messages = 0;
     total_bytes = 0;
     dropped_messages = 0;
+    skipped_messages = 0;
+    wire_bytes = 0;
+    codec_time_ns = 0;
+    publish_time_ns = 0;
+    sequence = data_bridge::SequenceStats();
     start_time = std::chrono::steady_clock::now();
     
     std::lock_guard<std::mutex> lock(latency_mutex);
@@ -32,6 +65,15 @@ void Statistics::recordMessage(size_t bytes, double latency_ms) {
     }
 }
 
+void Statistics::recordCodec(size_t wire_size, uint64_t elapsed_ns) {
+    wire_bytes += wire_size;
+    codec_time_ns += elapsed_ns;
+}
+
+void Statistics::recordPublish(uint64_t elapsed_ns) {
+    publish_time_ns += elapsed_ns;
+}
+
 void Statistics::printReport() const {
     end_time = std::chrono::steady_clock::now();
     
@@ -44,13 +86,40 @@ void Statistics::printReport() const {
     std::cout << "Total Messages:    " << total_messages.load() << std::endl;
     std::cout << "Total Bytes:       " << total_bytes.load() / (1024.0 * 1024.0) << " MB" << std::endl;
     std::cout << "Dropped Messages:  " << dropped_messages.load() << std::endl;
+    if (skipped_messages.load() > 0) {
+        std::cout << "Skipped Messages:  " << skipped_messages.load() << " (no subscribers)" << std::endl;
+    }
     std::cout << "Messages/sec:      " << getMessagesPerSecond() << std::endl;
     std::cout << "Throughput:        " << getMegabytesPerSecond() << " MB/s" << std::endl;
     
+    if (wire_bytes.load() > 0) {
+        std::cout << "\nCompression:" << std::endl;
+        std::cout << "  Wire Bytes:      " << wire_bytes.load() / (1024.0 * 1024.0) << " MB" << std::endl;
+        std::cout << "  Ratio:           " << static_cast<double>(total_bytes.load()) / wire_bytes.load() << "x" << std::endl;
+        std::cout << "  CPU per Message: " << (total_messages.load() > 0
+            ? codec_time_ns.load() / 1000.0 / total_messages.load() : 0.0) << " us" << std::endl;
+    }
+    
+    if (publish_time_ns.load() > 0) {
+        std::cout << "Put per Message:   " << (total_messages.load() > 0
+            ? publish_time_ns.load() / 1000.0 / total_messages.load() : 0.0) << " us" << std::endl;
+    }
+    
+    if (sequence.received > 0) {
+        std::cout << "\nSequence:" << std::endl;
+        std::cout << "  Publishers:      " << sequence.publishers << std::endl;
+        std::cout << "  Lost:            " << sequence.lost << " (" << sequence.lossRate() * 100.0 << "%)" << std::endl;
+        std::cout << "  Reordered:       " << sequence.reordered << std::endl;
+        std::cout << "  Duplicates:      " << sequence.duplicates << std::endl;
+        std::cout << "  Stale:           " << sequence.stale << std::endl;
+    }
+    
     if (!latencies_ms.empty()) {
         std::cout << "\nLatency Statistics:" << std::endl;
         std::cout << "  Average:         " << getAverageLatencyMs() << " ms" << std::endl;
         std::cout << "  P99:             " << getP99LatencyMs() << " ms" << std::endl;
+        std::cout << "  P99.9:           " << getLatencyPercentileMs(0.999) << " ms" << std::endl;
+        std::cout << "  Max:             " << getLatencyPercentileMs(1.0) << " ms" << std::endl;
     }
     std::cout << "========================================\n" << std::endl;
 }
@@ -79,14 +148,18 @@ double Statistics::getAverageLatencyMs() const {
 }
 
 double Statistics::getP99LatencyMs() const {
+    return getLatencyPercentileMs(0.99);
+}
+
+double Statistics::getLatencyPercentileMs(double percentile) const {
     std::lock_guard<std::mutex> lock(latency_mutex);
     if (latencies_ms.empty()) return 0.0;
     
     auto sorted = latencies_ms;
     std::sort(sorted.begin(), sorted.end());
     
-    size_t p99_index = static_cast<size_t>(sorted.size() * 0.99);
-    return sorted[std::min(p99_index, sorted.size() - 1)];
+    size_t index = static_cast<size_t>(sorted.size() * percentile);
+    return sorted[std::min(index, sorted.size() - 1)];
 }
 
 // BenchmarkPublisher implementation
@@ -104,12 +177,43 @@ bool BenchmarkPublisher::start() {
         return false;
     }
     
+    // Each publisher paces itself with a whole number of nanoseconds between messages
+    size_t messages_per_publisher = config_.num_publishers > 0 ? config_.messages_per_second / config_.num_publishers : 0;
+    if (messages_per_publisher == 0 || messages_per_publisher > 1000000000) {
+        std::cerr << "[Benchmark] Rate must be 1 to 1000000000 msg/s per publisher, got "
+                  << config_.messages_per_second << " msg/s for " << config_.num_publishers << " publisher(s)"
+                  << std::endl;
+        return false;
+    }
+    
     std::cout << "[Benchmark] Starting benchmark publisher..." << std::endl;
     std::cout << "  Topic: " << config_.zenoh_topic << std::endl;
-    std::cout << "  Message Size: " << config_.message_size << " bytes" << std::endl;
+    if (config_.payload_capture.empty()) {
+        std::cout << "  Message Size: " << config_.message_size << " bytes" << std::endl;
+    } else {
+        std::cout << "  Payloads: " << config_.payload_capture << std::endl;
+    }
     std::cout << "  Target Rate: " << config_.messages_per_second << " msg/s" << std::endl;
     std::cout << "  Publishers: " << config_.num_publishers << std::endl;
     std::cout << "  Duration: " << config_.duration_seconds << " seconds" << std::endl;
+    if (config_.compression != data_bridge::CompressionType::NONE) {
+        std::cout << "  Compression: " << (config_.compression == data_bridge::CompressionType::LZ4 ? "lz4" : "zstd")
+                  << " (min " << config_.compression_min_size << " bytes)" << std::endl;
+    }
+    if (config_.integrity != data_bridge::IntegrityCheck::NONE) {
+        std::cout << "  Integrity: " << data_bridge::Integrity::describe(config_.integrity) << " trailer" << std::endl;
+    }
+    if (!config_.payload_capture.empty() &&
+        (config_.measure_latency || config_.integrity != data_bridge::IntegrityCheck::NONE)) {
+        std::cout << "  Replayed payloads are sent unmodified: no latency, sequence or integrity stamps" << std::endl;
+    }
+    if (config_.matched_only) {
+        std::cout << "  Produce: only while a subscriber matches" << std::endl;
+    }
+    if (config_.recoverable) {
+        std::cout << "  Recovery: cache " << config_.recovery_cache << " samples, heartbeat "
+                  << config_.heartbeat_ms << " ms" << std::endl;
+    }
     
     stats_.reset();
     running_ = true;
@@ -144,16 +248,80 @@ void BenchmarkPublisher::publishLoop(int publisher_id) {
         // Open Zenoh session
         zenoh::Config zenoh_config = zenoh::Config::create_default();
         auto session = zenoh::Session::open(std::move(zenoh_config));
-        auto publisher = session.declare_publisher(config_.zenoh_topic);
+        
+        // Recoverable publishers keep a cache that advanced subscribers query for lost samples
+        std::optional<zenoh::Publisher> publisher;
+        std::optional<zenoh::ext::AdvancedPublisher> advanced_publisher;
+        if (config_.recoverable) {
+            zenoh::ext::SessionExt::AdvancedPublisherOptions options;
+            options.cache.emplace();
+            options.cache->max_samples = config_.recovery_cache;
+            options.sample_miss_detection.emplace();
+            if (config_.heartbeat_ms > 0) {
+                options.sample_miss_detection->heartbeat =
+                    zenoh::ext::SessionExt::AdvancedPublisherOptions::SampleMissDetectionOptions::HeartbeatPeriodic{
+                        config_.heartbeat_ms};
+            }
+            options.publisher_detection = true;
+            advanced_publisher.emplace(session.ext().declare_advanced_publisher(config_.zenoh_topic, std::move(options)));
+        } else {
+            publisher.emplace(session.declare_publisher(config_.zenoh_topic));
+        }
+        auto put = [&](zenoh::Bytes&& payload, zenoh::Publisher::PutOptions&& put_options) {
+            auto put_start = std::chrono::steady_clock::now();
+            if (advanced_publisher) {
+                zenoh::ext::AdvancedPublisher::PutOptions options;
+                options.put_options = std::move(put_options);
+                advanced_publisher->put(std::move(payload), std::move(options));
+            } else {
+                publisher->put(std::move(payload), std::move(put_options));
+            }
+            stats_.recordPublish(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - put_start).count());
+        };
+        
+        // Declared after the publisher, so its listener is undeclared first
+        data_bridge::MatchingGate gate;
+        if (config_.matched_only) {
+            bool attached = advanced_publisher ? gate.attach(*advanced_publisher) : gate.attach(*publisher);
+            if (!attached) {
+                std::cerr << "[Publisher " << publisher_id << "] Matching status unavailable, always producing"
+                          << std::endl;
+            }
+        }
+        data_bridge::SequenceHeader sequence;
+        sequence.publisher = (static_cast<uint64_t>(getpid()) << 16) | static_cast<uint64_t>(publisher_id);
+        
+        // Compression codec, configured like a bridge stream
+        data_bridge::StreamConfig codec_config;
+        codec_config.compression = config_.compression;
+        codec_config.compression_min_size = config_.compression_min_size;
+        codec_config.compression_level = config_.compression_level;
+        codec_config.zstd_dictionary = config_.zstd_dictionary;
+        data_bridge::PayloadCodec codec(codec_config);
+        if (!codec.init()) {
+            std::cerr << "[Publisher " << publisher_id << "] Failed to initialize codec" << std::endl;
+            return;
+        }
         
         std::cout << "[Publisher " << publisher_id << "] Started" << std::endl;
         
         // Calculate delay between messages for this publisher
         size_t messages_per_publisher = config_.messages_per_second / config_.num_publishers;
-        auto delay = std::chrono::microseconds(1000000 / messages_per_publisher);
+        auto delay = std::chrono::nanoseconds(1000000000 / messages_per_publisher);
         
-        // Generate test data
-        auto test_data = generateTestData(config_.message_size);
+        // Generate test data, or cycle through captured payloads
+        std::vector<std::vector<uint8_t>> payloads;
+        if (!config_.payload_capture.empty()) {
+            payloads = loadCapturedPayloads(config_.payload_capture);
+            if (payloads.empty()) {
+                std::cerr << "[Publisher " << publisher_id << "] No payloads in capture" << std::endl;
+                return;
+            }
+        } else {
+            payloads.push_back(generateTestData(config_.message_size));
+        }
+        bool stamp = config_.payload_capture.empty();
         
         auto start_time = std::chrono::steady_clock::now();
         auto next_send_time = start_time;
@@ -169,17 +337,55 @@ void BenchmarkPublisher::publishLoop(int publisher_id) {
                 break;
             }
             
+            // Nothing is stamped, compressed or put while nobody listens, resume on the first match
+            if (!gate.matched()) {
+                gate.wait(std::chrono::milliseconds(100));
+                auto resumed = std::chrono::steady_clock::now();
+                if (resumed > next_send_time) {
+                    stats_.skipped_messages += static_cast<uint64_t>((resumed - next_send_time) / delay) + 1;
+                    next_send_time = resumed;
+                }
+                continue;
+            }
+            
             // Time-based rate limiting
             if (now >= next_send_time) {
-                // Add timestamp if measuring latency
-                if (config_.measure_latency) {
+                auto& test_data = payloads[msg_count % payloads.size()];
+                
+                // Add timestamp and sequence number if measuring latency, generated payloads only
+                if (stamp && config_.measure_latency && test_data.size() >= kStampedSize) {
+                    uint32_t flags = kStampTimestamp | kStampSequence;
                     auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
                         now.time_since_epoch()).count();
-                    std::memcpy(test_data.data(), &timestamp, sizeof(timestamp));
+                    sequence.sequence = msg_count;
+                    data_bridge::SequenceTracker::writeHeader(sequence, test_data.data(), test_data.size());
+                    std::memcpy(test_data.data() + kMagicOffset, &kStampMagic, sizeof(kStampMagic));
+                    std::memcpy(test_data.data() + kFlagsOffset, &flags, sizeof(flags));
+                    std::memcpy(test_data.data() + kTimestampOffset, &timestamp, sizeof(timestamp));
+                }
+                
+                // Checksum last, over the stamped payload
+                if (stamp && config_.integrity != data_bridge::IntegrityCheck::NONE) {
+                    data_bridge::Integrity::writeTrailer(config_.integrity, test_data.data(), test_data.size());
                 }
                 
                 // Publish message
-                publisher.put(test_data);
+                if (config_.compression != data_bridge::CompressionType::NONE) {
+                    auto codec_start = std::chrono::steady_clock::now();
+                    data_bridge::ByteView wire;
+                    zenoh::Publisher::PutOptions options;
+                    if (!codec.compress({test_data.data(), test_data.size()}, wire, options.encoding)) {
+                        stats_.dropped_messages++;
+                        next_send_time += delay;
+                        continue;
+                    }
+                    stats_.recordCodec(wire.size, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - codec_start).count());
+                    
+                    put(pooledBytes(wire.data, wire.size), std::move(options));
+                } else {
+                    put(pooledBytes(test_data.data(), test_data.size()), zenoh::Publisher::PutOptions());
+                }
                 stats_.recordMessage(test_data.size());
                 
                 msg_count++;
@@ -205,8 +411,8 @@ void BenchmarkPublisher::publishLoop(int publisher_id) {
 std::vector<uint8_t> BenchmarkPublisher::generateTestData(size_t size) {
     std::vector<uint8_t> data(size);
     
-    // Fill with pattern (reserve first 8 bytes for timestamp if needed)
-    size_t start = config_.measure_latency ? sizeof(uint64_t) : 0;
+    // Fill with pattern (reserve the timestamp and sequence header if needed)
+    size_t start = config_.measure_latency ? std::min(size, kStampedSize) : 0;
     for (size_t i = start; i < size; ++i) {
         data[i] = static_cast<uint8_t>(i & 0xFF);
     }
@@ -214,6 +420,23 @@ std::vector<uint8_t> BenchmarkPublisher::generateTestData(size_t size) {
     return data;
 }
 
+std::vector<std::vector<uint8_t>> BenchmarkPublisher::loadCapturedPayloads(const std::string& path) {
+    // Bounded so a long capture does not exhaust memory
+    constexpr size_t kMaxPayloads = 100000;
+    std::vector<std::vector<uint8_t>> payloads;
+    
+    data_bridge::CaptureReader reader;
+    if (!reader.open(path)) {
+        return payloads;
+    }
+    reader.forEach([&](const data_bridge::CaptureRecord& record) {
+        payloads.emplace_back(record.payload, record.payload + record.payload_size);
+        return payloads.size() < kMaxPayloads;
+    });
+    
+    return payloads;
+}
+
 void BenchmarkPublisher::printReport() const {
     stats_.printReport();
 }
@@ -287,6 +510,7 @@ void BenchmarkReceiver::stop() {
     }
     
     stats_.end_time = std::chrono::steady_clock::now();
+    stats_.sequence = sequence_.getStats();
 }
 
 void BenchmarkReceiver::receiveLoop() {
@@ -308,11 +532,21 @@ void BenchmarkReceiver::receiveLoop() {
         
         auto now = std::chrono::steady_clock::now();
         
-        // Extract timestamp if present (first 8 bytes)
+        // Only payloads stamped by benchmark_pub carry a timestamp and sequence number
+        uint32_t magic = 0;
+        uint32_t flags = 0;
+        if (received >= static_cast<ssize_t>(kStampedSize)) {
+            std::memcpy(&magic, buffer.data() + kMagicOffset, sizeof(magic));
+            std::memcpy(&flags, buffer.data() + kFlagsOffset, sizeof(flags));
+        }
+        if (magic != kStampMagic) {
+            flags = 0;
+        }
+        
         double latency_ms = 0.0;
-        if (received >= static_cast<ssize_t>(sizeof(uint64_t))) {
+        if (flags & kStampTimestamp) {
             uint64_t send_timestamp;
-            std::memcpy(&send_timestamp, buffer.data(), sizeof(send_timestamp));
+            std::memcpy(&send_timestamp, buffer.data() + kTimestampOffset, sizeof(send_timestamp));
             
             auto recv_timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
                 now.time_since_epoch()).count();
@@ -320,6 +554,11 @@ void BenchmarkReceiver::receiveLoop() {
             latency_ms = (recv_timestamp - send_timestamp) / 1000.0;
         }
         
+        data_bridge::SequenceHeader header;
+        if ((flags & kStampSequence) && data_bridge::SequenceTracker::readHeader(buffer.data(), static_cast<size_t>(received), header)) {
+            sequence_.observe(header.publisher, header.sequence);
+        }
+        
         stats_.recordMessage(received, latency_ms);
     }
 }
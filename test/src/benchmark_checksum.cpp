@@ -0,0 +1,144 @@
+/**
+ * @file benchmark_checksum.cpp
+ * @brief Measures the payload integrity checksums of the bridge
+ *
+ * Hashes payloads of several sizes with every checksum the bridge can
+ * verify (CRC32C and XXH3, with the instructions picked at startup and
+ * with the portable fallback) plus XXH64 used for duplicate detection, and
+ * reports the throughput per core and the cost per message.
+ */
+
+#include "hash.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct ChecksumBenchConfig {
+    std::vector<size_t> sizes = {64, 1024, 16384, 65536, 1048576};
+    size_t bytes = 1ull << 30;            // Hashed per (checksum, size) run
+};
+
+struct Checksum {
+    const char* name;
+    uint64_t (*hash)(const uint8_t* data, size_t len);
+};
+
+// Keeps the hashes from being optimized away
+volatile uint64_t g_sink = 0;
+
+const Checksum kChecksums[] = {
+    {"crc32c", [](const uint8_t* data, size_t len) -> uint64_t { return data_bridge::crc32c(data, len); }},
+    {"crc32c (portable)",
+     [](const uint8_t* data, size_t len) -> uint64_t { return data_bridge::crc32cPortable(data, len); }},
+    {"xxh3", [](const uint8_t* data, size_t len) { return data_bridge::xxh3_64(data, len); }},
+    {"xxh3 (portable)", [](const uint8_t* data, size_t len) { return data_bridge::xxh3_64Portable(data, len); }},
+    {"xxh64", [](const uint8_t* data, size_t len) { return data_bridge::xxhash64(data, len); }},
+};
+
+// Hashes config.bytes worth of payloads of one size and prints one result line
+void runChecksum(const ChecksumBenchConfig& config, const Checksum& checksum, const std::vector<uint8_t>& buffer,
+                 size_t size) {
+    // Consecutive payloads at different offsets, as received samples would be
+    size_t slots = buffer.size() / size;
+    size_t count = std::max<size_t>(config.bytes / size, 1);
+    uint64_t sink = 0;
+
+    for (size_t i = 0; i < slots; ++i) {
+        sink += checksum.hash(buffer.data() + i * size, size);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        sink += checksum.hash(buffer.data() + (i % slots) * size, size);
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    g_sink = sink;
+
+    std::cout << std::left << std::setw(20) << checksum.name
+              << std::right << std::setw(9) << size << " B"
+              << std::setw(10) << std::fixed << std::setprecision(2)
+              << (elapsed > 0 ? count * size / elapsed / 1e9 : 0.0) << " GB/s"
+              << std::setw(12) << std::setprecision(1) << (count > 0 ? elapsed * 1e9 / count : 0.0) << " ns/msg"
+              << std::endl;
+}
+
+} // namespace
+
+void printUsage(const char* prog_name) {
+    std::cout << "Usage: " << prog_name << " [options]" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --sizes <a,b,...>         Payload sizes in bytes (default: 64,1024,16384,65536,1048576)" << std::endl;
+    std::cout << "  --mb <num>                MiB hashed per checksum and size (default: 1024)" << std::endl;
+    std::cout << "  -h, --help                Show this help message" << std::endl;
+    std::cout << "\nExamples:" << std::endl;
+    std::cout << "  # Every checksum at the default sizes" << std::endl;
+    std::cout << "  " << prog_name << std::endl;
+    std::cout << "\n  # Large camera frames only" << std::endl;
+    std::cout << "  " << prog_name << " --sizes 1048576,4194304" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    ChecksumBenchConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--sizes" && i + 1 < argc) {
+            std::string list = argv[++i];
+            config.sizes.clear();
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t comma = list.find(',', start);
+                if (comma == std::string::npos) {
+                    comma = list.size();
+                }
+                if (comma > start) {
+                    config.sizes.push_back(std::max<size_t>(std::stoul(list.substr(start, comma - start)), 1));
+                }
+                start = comma + 1;
+            }
+        } else if (arg == "--mb" && i + 1 < argc) {
+            config.bytes = std::stoul(argv[++i]) << 20;
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.sizes.empty()) {
+        std::cerr << "No payload sizes given" << std::endl;
+        return 1;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Checksum Benchmark" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "CRC32C:  " << data_bridge::crc32cImplementation() << std::endl;
+    std::cout << "XXH3:    " << data_bridge::xxh3Implementation() << " (inputs above 240 bytes)" << std::endl;
+    std::cout << "Hashed:  " << (config.bytes >> 20) << " MiB per run\n" << std::endl;
+
+    // Random bytes, several payloads of the largest size so runs do not hash one cached buffer
+    size_t largest = *std::max_element(config.sizes.begin(), config.sizes.end());
+    std::vector<uint8_t> buffer(std::max<size_t>(largest * 4, 8 << 20));
+    std::mt19937_64 rng(42);
+    for (auto& byte : buffer) {
+        byte = static_cast<uint8_t>(rng());
+    }
+
+    for (const auto& checksum : kChecksums) {
+        for (size_t size : config.sizes) {
+            runChecksum(config, checksum, buffer, size);
+        }
+        std::cout << std::endl;
+    }
+    return 0;
+}
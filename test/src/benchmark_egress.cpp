@@ -0,0 +1,413 @@
+/**
+ * @file benchmark_egress.cpp
+ * @brief Compares the UDP egress paths of the bridge on loopback
+ *
+ * Sends the same datagrams to a local sink with sendto (the default
+ * forwarder), sendmmsg batches, UDP GSO batches, MSG_ZEROCOPY and the
+ * io_uring engine, and reports rate and sender CPU time per message.
+ */
+
+#include "uring_egress.h"
+#include "udp_sender.h"
+#include <csignal>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace {
+
+struct EgressBenchConfig {
+    size_t message_size = 1024;
+    size_t message_count = 1000000;
+    size_t batch_size = 32;               // sendmmsg / GSO batch
+    size_t threads = 1;                   // concurrent senders
+    int port = 9900;
+    size_t queue_depth = 256;
+    size_t zerocopy_threshold = 16384;
+};
+
+struct EgressResult {
+    double elapsed_sec = 0.0;
+    double sender_cpu_sec = 0.0;
+    uint64_t sent = 0;
+    uint64_t received = 0;
+};
+
+double processCpuSeconds() {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+}
+
+double threadCpuSeconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Counts datagrams arriving on the benchmark port
+class LoopbackSink {
+public:
+    explicit LoopbackSink(int port) : port_(port) {}
+
+    ~LoopbackSink() {
+        stop();
+    }
+
+    bool start() {
+        socket_ = socket(AF_INET, SOCK_DGRAM, 0);
+        if (socket_ < 0) {
+            std::cerr << "Failed to create sink socket: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        int rcvbuf = 64 * 1024 * 1024;
+        setsockopt(socket_, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+        timeval timeout{0, 100000};
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(port_);
+        if (bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            std::cerr << "Failed to bind sink port " << port_ << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        running_ = true;
+        thread_ = std::thread(&LoopbackSink::receiveLoop, this);
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+        if (socket_ >= 0) {
+            close(socket_);
+            socket_ = -1;
+        }
+    }
+
+    uint64_t received() const { return received_.load(); }
+    double cpuSeconds() const { return cpu_seconds_.load(); }
+
+    void reset() {
+        received_ = 0;
+    }
+
+private:
+    void receiveLoop() {
+        constexpr size_t kBatch = 64;
+        std::vector<uint8_t> buffer(kBatch * 65536);
+        mmsghdr msgs[kBatch];
+        iovec iovs[kBatch];
+        for (size_t i = 0; i < kBatch; ++i) {
+            iovs[i] = {buffer.data() + i * 65536, 65536};
+            memset(&msgs[i], 0, sizeof(msgs[i]));
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+
+        while (running_) {
+            int count = recvmmsg(socket_, msgs, kBatch, 0, nullptr);
+            if (count > 0) {
+                received_ += count;
+            }
+            cpu_seconds_ = threadCpuSeconds();
+        }
+    }
+
+private:
+    int port_;
+    int socket_{-1};
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> received_{0};
+    std::atomic<double> cpu_seconds_{0.0};
+    std::thread thread_;
+};
+
+// Splits message_count across threads and runs send_range on each
+template <typename SendRange>
+EgressResult runSenders(const EgressBenchConfig& config, LoopbackSink& sink, SendRange send_range) {
+    EgressResult result;
+    std::atomic<uint64_t> sent{0};
+    std::vector<std::thread> threads;
+
+    sink.reset();
+    double sink_cpu_before = sink.cpuSeconds();
+    double cpu_before = processCpuSeconds();
+    auto start = std::chrono::steady_clock::now();
+
+    size_t per_thread = config.message_count / config.threads;
+    for (size_t t = 0; t < config.threads; ++t) {
+        threads.emplace_back([&, t]() {
+            sent += send_range(t, per_thread);
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    result.elapsed_sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Let the sink catch up before reading its counter
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    double sink_cpu = sink.cpuSeconds() - sink_cpu_before;
+    result.sender_cpu_sec = processCpuSeconds() - cpu_before - sink_cpu;
+    result.sent = sent;
+    result.received = sink.received();
+    return result;
+}
+
+void printResult(const std::string& name, const EgressResult& result) {
+    double rate = result.sent / result.elapsed_sec;
+    double cpu_us = result.sent > 0 ? result.sender_cpu_sec * 1e6 / result.sent : 0.0;
+    double delivered = result.sent > 0 ? 100.0 * result.received / result.sent : 0.0;
+
+    std::cout << std::left << std::setw(10) << name
+              << std::right << std::setw(14) << std::fixed << std::setprecision(0) << rate << " msg/s"
+              << std::setw(12) << std::setprecision(3) << cpu_us << " us/msg CPU"
+              << std::setw(10) << std::setprecision(1) << delivered << "% delivered" << std::endl;
+}
+
+} // namespace
+
+void printUsage(const char* prog_name) {
+    std::cout << "Usage: " << prog_name << " [options]" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  -s, --size <bytes>        Datagram size (default: 1024)" << std::endl;
+    std::cout << "  -n, --count <num>         Datagrams per backend (default: 1000000)" << std::endl;
+    std::cout << "  -b, --batch <num>         sendmmsg / GSO batch size (default: 32)" << std::endl;
+    std::cout << "  -t, --threads <num>       Concurrent sender threads (default: 1)" << std::endl;
+    std::cout << "  -p, --port <port>         Loopback sink port (default: 9900)" << std::endl;
+    std::cout << "  --backend <name>          sendto, sendmmsg, gso, zerocopy, io_uring or all (default: all)" << std::endl;
+    std::cout << "  --queue-depth <num>       io_uring slots (default: 256)" << std::endl;
+    std::cout << "  --zc-threshold <bytes>    SEND_ZC / MSG_ZEROCOPY threshold, 0 disables (default: 16384)" << std::endl;
+    std::cout << "  -h, --help                Show this help message" << std::endl;
+    std::cout << "\nExamples:" << std::endl;
+    std::cout << "  # Compare all backends with 1KB datagrams" << std::endl;
+    std::cout << "  " << prog_name << " -s 1024 -n 1000000" << std::endl;
+    std::cout << "\n  # Four forwarding threads sharing one io_uring engine" << std::endl;
+    std::cout << "  " << prog_name << " --backend io_uring -t 4" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    signal(SIGPIPE, SIG_IGN);
+
+    EgressBenchConfig config;
+    std::string backend = "all";
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if ((arg == "-s" || arg == "--size") && i + 1 < argc) {
+            config.message_size = std::stoul(argv[++i]);
+        } else if ((arg == "-n" || arg == "--count") && i + 1 < argc) {
+            config.message_count = std::stoul(argv[++i]);
+        } else if ((arg == "-b" || arg == "--batch") && i + 1 < argc) {
+            config.batch_size = std::max<size_t>(std::stoul(argv[++i]), 1);
+        } else if ((arg == "-t" || arg == "--threads") && i + 1 < argc) {
+            config.threads = std::max<size_t>(std::stoul(argv[++i]), 1);
+        } else if ((arg == "-p" || arg == "--port") && i + 1 < argc) {
+            config.port = std::stoi(argv[++i]);
+        } else if (arg == "--backend" && i + 1 < argc) {
+            backend = argv[++i];
+        } else if (arg == "--queue-depth" && i + 1 < argc) {
+            config.queue_depth = std::stoul(argv[++i]);
+        } else if (arg == "--zc-threshold" && i + 1 < argc) {
+            config.zerocopy_threshold = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  UDP Egress Benchmark (loopback)" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Message size: " << config.message_size << " bytes" << std::endl;
+    std::cout << "Messages:     " << config.message_count << std::endl;
+    std::cout << "Threads:      " << config.threads << std::endl;
+    std::cout << "io_uring:     " << (data_bridge::UringEgress::isAvailable() ? "available" : "not available")
+              << "\n" << std::endl;
+
+    LoopbackSink sink(config.port);
+    if (!sink.start()) {
+        return 1;
+    }
+
+    sockaddr_in dest{};
+    dest.sin_family = AF_INET;
+    dest.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    dest.sin_port = htons(config.port);
+
+    std::vector<uint8_t> payload(config.message_size, 0xAB);
+    std::vector<int> sockets;
+    for (size_t t = 0; t < config.threads; ++t) {
+        int fd = socket(AF_INET, SOCK_DGRAM, 0);
+        if (fd < 0) {
+            std::cerr << "Failed to create socket: " << strerror(errno) << std::endl;
+            return 1;
+        }
+        int sndbuf = 4 * 1024 * 1024;
+        setsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndbuf, sizeof(sndbuf));
+        sockets.push_back(fd);
+    }
+
+    if (backend == "all" || backend == "sendto") {
+        auto result = runSenders(config, sink, [&](size_t t, size_t count) {
+            uint64_t sent = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (sendto(sockets[t], payload.data(), payload.size(), 0,
+                           reinterpret_cast<const sockaddr*>(&dest), sizeof(dest)) >= 0) {
+                    sent++;
+                }
+            }
+            return sent;
+        });
+        printResult("sendto", result);
+    }
+
+    if (backend == "all" || backend == "sendmmsg") {
+        auto result = runSenders(config, sink, [&](size_t t, size_t count) {
+            std::vector<mmsghdr> msgs(config.batch_size);
+            iovec iov{payload.data(), payload.size()};
+            for (auto& msg : msgs) {
+                memset(&msg, 0, sizeof(msg));
+                msg.msg_hdr.msg_name = &dest;
+                msg.msg_hdr.msg_namelen = sizeof(dest);
+                msg.msg_hdr.msg_iov = &iov;
+                msg.msg_hdr.msg_iovlen = 1;
+            }
+
+            uint64_t sent = 0;
+            for (size_t i = 0; i < count; i += config.batch_size) {
+                unsigned batch = static_cast<unsigned>(std::min(config.batch_size, count - i));
+                int ret = sendmmsg(sockets[t], msgs.data(), batch, 0);
+                if (ret > 0) {
+                    sent += ret;
+                }
+            }
+            return sent;
+        });
+        printResult("sendmmsg", result);
+    }
+
+    if (backend == "all" || backend == "gso") {
+        std::vector<std::unique_ptr<data_bridge::UdpSender>> senders;
+        for (int fd : sockets) {
+            senders.push_back(std::make_unique<data_bridge::UdpSender>(fd, dest, false, true, 0));
+        }
+
+        auto result = runSenders(config, sink, [&](size_t t, size_t count) {
+            std::vector<data_bridge::ByteView> items(config.batch_size, {payload.data(), payload.size()});
+            uint64_t sent = 0;
+            for (size_t i = 0; i < count; i += config.batch_size) {
+                sent += senders[t]->sendBatch(items.data(), std::min(config.batch_size, count - i));
+            }
+            return sent;
+        });
+        printResult("gso", result);
+
+        data_bridge::UdpSenderStats total;
+        for (const auto& sender : senders) {
+            auto stats = sender->getStats();
+            total.gso_batches += stats.gso_batches;
+            total.gso_datagrams += stats.gso_datagrams;
+        }
+        std::cout << "          GSO sends: " << total.gso_batches << " carrying " << total.gso_datagrams
+                  << " datagrams (rest via sendmmsg)" << std::endl;
+    }
+
+    if (backend == "all" || backend == "zerocopy") {
+        std::vector<std::unique_ptr<data_bridge::UdpSender>> senders;
+        for (int fd : sockets) {
+            senders.push_back(std::make_unique<data_bridge::UdpSender>(
+                fd, dest, false, false, std::max<size_t>(config.zerocopy_threshold, 1)));
+        }
+
+        // One pooled copy of the payload, referenced by every in-flight send
+        auto owner = data_bridge::PayloadBuffer::allocate(payload.size());
+        std::memcpy(owner.data(), payload.data(), payload.size());
+
+        auto result = runSenders(config, sink, [&](size_t t, size_t count) {
+            uint64_t sent = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (senders[t]->sendZeroCopy(owner.data(), owner.size(), owner) ||
+                    sendto(sockets[t], payload.data(), payload.size(), 0,
+                           reinterpret_cast<const sockaddr*>(&dest), sizeof(dest)) >= 0) {
+                    sent++;
+                }
+            }
+            return sent;
+        });
+        printResult("zerocopy", result);
+
+        data_bridge::UdpSenderStats total;
+        for (const auto& sender : senders) {
+            auto stats = sender->getStats();
+            total.zerocopy_sends += stats.zerocopy_sends;
+            total.zerocopy_copied += stats.zerocopy_copied;
+            total.zerocopy_fallbacks += stats.zerocopy_fallbacks;
+        }
+        std::cout << "          zero-copy: " << total.zerocopy_sends << ", copied by kernel: "
+                  << total.zerocopy_copied << ", fallback: " << total.zerocopy_fallbacks
+                  << " (loopback always copies)" << std::endl;
+    }
+
+    if (backend == "all" || backend == "io_uring") {
+        data_bridge::UringEgress egress(config.queue_depth, std::max<size_t>(config.message_size, 1),
+                                        config.zerocopy_threshold);
+        std::vector<int> handles;
+        for (int fd : sockets) {
+            handles.push_back(egress.registerSocket(fd));
+        }
+
+        if (egress.start()) {
+            auto result = runSenders(config, sink, [&](size_t t, size_t count) {
+                uint64_t sent = 0;
+                for (size_t i = 0; i < count; ++i) {
+                    // The ring is full while the kernel catches up, retry like a blocking send
+                    while (!egress.send(handles[t], dest, payload.data(), payload.size())) {
+                        std::this_thread::yield();
+                    }
+                    sent++;
+                }
+                return sent;
+            });
+            egress.stop();
+            printResult("io_uring", result);
+
+            auto stats = egress.getStats();
+            std::cout << "          completed: " << stats.completed << ", failed: " << stats.failed
+                      << ", zero-copy: " << stats.zerocopy << ", ring full: " << stats.rejected
+                      << ", batches: " << stats.batches;
+            if (stats.batches > 0) {
+                std::cout << " (" << std::setprecision(1)
+                          << static_cast<double>(stats.submitted) / stats.batches << " msg/batch)";
+            }
+            std::cout << std::endl;
+        } else {
+            std::cout << "io_uring  skipped" << std::endl;
+        }
+    }
+
+    sink.stop();
+    for (int fd : sockets) {
+        close(fd);
+    }
+    return 0;
+}
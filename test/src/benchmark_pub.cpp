@@ -1,4 +1,6 @@
 #include "benchmark.h"
+#include "payload_codec.h"
+#include "integrity.h"
 #include <iostream>
 #include <csignal>
 #include <thread>
@@ -18,6 +20,16 @@ void printUsage(const char* prog_name) {
     std::cout << "  -r <rate>         Messages per second (default: 1000)" << std::endl;
     std::cout << "  -d <duration>     Benchmark duration in seconds (default: 10)" << std::endl;
     std::cout << "  -p <publishers>   Number of concurrent publishers (default: 1)" << std::endl;
+    std::cout << "  --compress <codec>      Compress payloads: lz4, zstd (default: none)" << std::endl;
+    std::cout << "  --compress-min <size>   Minimum payload size to compress (default: 256)" << std::endl;
+    std::cout << "  --compress-level <n>    LZ4 acceleration / zstd level (default: 1)" << std::endl;
+    std::cout << "  --dict <file>           Trained zstd dictionary" << std::endl;
+    std::cout << "  --payload-from <file>   Cycle through payloads of a capture segment (.zcap)" << std::endl;
+    std::cout << "  --integrity <check>     Checksum in the last payload bytes: crc32c, xxh3 (default: none)" << std::endl;
+    std::cout << "  --recoverable           Advanced publisher, lost samples are recovered from its cache" << std::endl;
+    std::cout << "  --cache <n>             Samples cached for recovery (default: 1000)" << std::endl;
+    std::cout << "  --heartbeat <ms>        Heartbeat period for last-sample miss detection, 0 disables (default: 100)" << std::endl;
+    std::cout << "  --matched-only          Produce nothing while no subscriber matches the topic" << std::endl;
     std::cout << "  -v                Verbose output" << std::endl;
     std::cout << "  -h                Show this help message" << std::endl;
     std::cout << "\nExamples:" << std::endl;
@@ -27,6 +39,10 @@ void printUsage(const char* prog_name) {
     std::cout << "  " << prog_name << " -s 10240 -r 10000 -p 4 -d 30" << std::endl;
     std::cout << "\n  # Low latency test: small messages at high rate" << std::endl;
     std::cout << "  " << prog_name << " -s 64 -r 50000 -d 10" << std::endl;
+    std::cout << "\n  # Bandwidth test: LZ4 compressed 10KB messages" << std::endl;
+    std::cout << "  " << prog_name << " -s 10240 -r 1000 --compress lz4" << std::endl;
+    std::cout << "\n  # Recovery test: cache covers 500 ms at 2000 msg/s" << std::endl;
+    std::cout << "  " << prog_name << " -s 256 -r 2000 --recoverable --cache 1000 --heartbeat 50" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
@@ -52,6 +68,36 @@ int main(int argc, char* argv[]) {
             config.duration_seconds = std::stoul(argv[++i]);
         } else if (arg == "-p" && i + 1 < argc) {
             config.num_publishers = std::stoul(argv[++i]);
+        } else if (arg == "--compress" && i + 1 < argc) {
+            if (!data_bridge::PayloadCodec::parseType(argv[++i], config.compression)) {
+                std::cerr << "Unknown codec: " << argv[i] << std::endl;
+                return 1;
+            }
+            if (!data_bridge::PayloadCodec::isAvailable(config.compression)) {
+                std::cerr << "Codec not compiled in: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--compress-min" && i + 1 < argc) {
+            config.compression_min_size = std::stoul(argv[++i]);
+        } else if (arg == "--compress-level" && i + 1 < argc) {
+            config.compression_level = std::stoi(argv[++i]);
+        } else if (arg == "--dict" && i + 1 < argc) {
+            config.zstd_dictionary = argv[++i];
+        } else if (arg == "--payload-from" && i + 1 < argc) {
+            config.payload_capture = argv[++i];
+        } else if (arg == "--integrity" && i + 1 < argc) {
+            if (!data_bridge::Integrity::parseCheck(argv[++i], config.integrity)) {
+                std::cerr << "Unknown integrity check: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "--recoverable") {
+            config.recoverable = true;
+        } else if (arg == "--cache" && i + 1 < argc) {
+            config.recovery_cache = std::stoul(argv[++i]);
+        } else if (arg == "--heartbeat" && i + 1 < argc) {
+            config.heartbeat_ms = std::stoul(argv[++i]);
+        } else if (arg == "--matched-only") {
+            config.matched_only = true;
         } else if (arg == "-v") {
             config.verbose = true;
         } else {
@@ -0,0 +1,361 @@
+/**
+ * @file benchmark_query.cpp
+ * @brief Round-trip benchmark of the query bridge
+ *
+ * Three roles: an echo service the bridge forwards queries to, a Zenoh
+ * querier that measures the full round trip through the bridge, and a
+ * direct client that talks to the echo service without Zenoh as a baseline.
+ * Each of the -c lanes keeps one request outstanding.
+ */
+
+#include "benchmark.h"
+#include "service_client.h"
+#include <zenoh.hxx>
+#include <csignal>
+#include <cstring>
+#include <future>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+namespace {
+
+std::atomic<bool> g_running{true};
+
+void signalHandler(int) {
+    g_running = false;
+}
+
+struct QueryBenchConfig {
+    std::string zenoh_key = "benchmark/service";
+    size_t message_size = 256;
+    size_t lanes = 1;                     // concurrent outstanding requests
+    size_t duration_seconds = 10;
+    uint64_t timeout_ms = 1000;
+    data_bridge::ServiceConfig service;   // echo / direct endpoint
+};
+
+bool parseTransport(const std::string& name, data_bridge::ServiceTransport& transport) {
+    if (name == "udp") {
+        transport = data_bridge::ServiceTransport::UDP;
+    } else if (name == "tcp") {
+        transport = data_bridge::ServiceTransport::TCP;
+    } else if (name == "unix") {
+        transport = data_bridge::ServiceTransport::UNIX;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Sends every request back unchanged, which is a valid response in the bridge's framing
+class EchoService {
+public:
+    explicit EchoService(const data_bridge::ServiceConfig& config) : config_(config) {}
+
+    ~EchoService() {
+        stop();
+    }
+
+    bool start() {
+        bool unix_socket = config_.transport == data_bridge::ServiceTransport::UNIX;
+        bool datagram = config_.transport == data_bridge::ServiceTransport::UDP;
+        socket_ = socket(unix_socket ? AF_UNIX : AF_INET, datagram ? SOCK_DGRAM : SOCK_STREAM, 0);
+        if (socket_ < 0) {
+            std::cerr << "Failed to create echo socket: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        int result = -1;
+        if (unix_socket) {
+            sockaddr_un addr{};
+            addr.sun_family = AF_UNIX;
+            strncpy(addr.sun_path, config_.unix_path.c_str(), sizeof(addr.sun_path) - 1);
+            unlink(config_.unix_path.c_str());
+            result = bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        } else {
+            int reuse = 1;
+            setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+            sockaddr_in addr{};
+            addr.sin_family = AF_INET;
+            addr.sin_port = htons(static_cast<uint16_t>(config_.port));
+            inet_pton(AF_INET, config_.host.c_str(), &addr.sin_addr);
+            result = bind(socket_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        }
+        if (result < 0 || (!datagram && listen(socket_, 16) < 0)) {
+            std::cerr << "Failed to bind echo service: " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        timeval timeout{0, 100000};
+        setsockopt(socket_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+        running_ = true;
+        threads_.emplace_back(datagram ? &EchoService::datagramLoop : &EchoService::acceptLoop, this);
+        return true;
+    }
+
+    void stop() {
+        running_ = false;
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+        threads_.clear();
+        if (socket_ >= 0) {
+            close(socket_);
+            socket_ = -1;
+        }
+    }
+
+    uint64_t echoed() const { return echoed_.load(); }
+
+private:
+    void datagramLoop() {
+        std::vector<uint8_t> buffer(65536);
+        while (running_) {
+            sockaddr_storage from{};
+            socklen_t from_len = sizeof(from);
+            ssize_t received = recvfrom(socket_, buffer.data(), buffer.size(), 0,
+                                        reinterpret_cast<sockaddr*>(&from), &from_len);
+            if (received > 0 && sendto(socket_, buffer.data(), received, 0,
+                                       reinterpret_cast<sockaddr*>(&from), from_len) == received) {
+                echoed_++;
+            }
+        }
+    }
+
+    void acceptLoop() {
+        std::vector<std::thread> connections;
+        while (running_) {
+            int connection = accept(socket_, nullptr, nullptr);
+            if (connection < 0) {
+                continue;
+            }
+            int nodelay = 1;
+            setsockopt(connection, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+            timeval timeout{0, 100000};
+            setsockopt(connection, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+            connections.emplace_back(&EchoService::streamLoop, this, connection);
+        }
+        for (auto& thread : connections) {
+            thread.join();
+        }
+    }
+
+    void streamLoop(int connection) {
+        std::vector<uint8_t> buffer(65536);
+        while (running_) {
+            ssize_t received = recv(connection, buffer.data(), buffer.size(), 0);
+            if (received == 0) {
+                break;
+            }
+            if (received < 0) {
+                continue;
+            }
+            if (send(connection, buffer.data(), received, MSG_NOSIGNAL) != received) {
+                break;
+            }
+            echoed_ += static_cast<uint64_t>(received);
+        }
+        close(connection);
+    }
+
+private:
+    data_bridge::ServiceConfig config_;
+    int socket_{-1};
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> echoed_{0};     // datagrams (UDP) or bytes (streams)
+    std::vector<std::thread> threads_;
+};
+
+// Runs lanes that each keep one request outstanding, request(lane, payload) returns true on a good reply
+template <typename Request>
+void runLanes(const QueryBenchConfig& config, benchmark::Statistics& stats, Request request) {
+    stats.reset();
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(config.duration_seconds);
+
+    std::vector<std::thread> lanes;
+    for (size_t lane = 0; lane < config.lanes; ++lane) {
+        lanes.emplace_back([&, lane]() {
+            std::vector<uint8_t> payload(config.message_size, static_cast<uint8_t>('a' + lane % 26));
+            while (g_running && std::chrono::steady_clock::now() < deadline) {
+                auto start = std::chrono::steady_clock::now();
+                bool ok = request(lane, payload);
+                double rtt_ms = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - start).count();
+                if (ok) {
+                    stats.recordMessage(payload.size(), rtt_ms);
+                } else {
+                    stats.dropped_messages++;
+                }
+            }
+        });
+    }
+    for (auto& lane : lanes) {
+        lane.join();
+    }
+}
+
+} // namespace
+
+void printUsage(const char* prog_name) {
+    std::cout << "Usage: " << prog_name << " [options]" << std::endl;
+    std::cout << "\nRoles:" << std::endl;
+    std::cout << "  (default)                 Query <key> through Zenoh and the bridge" << std::endl;
+    std::cout << "  --echo <udp|tcp|unix>     Run the echo service the bridge forwards to" << std::endl;
+    std::cout << "  --direct <udp|tcp|unix>   Query the echo service directly, without Zenoh" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  -k <key>                  Zenoh key of the bridged service (default: benchmark/service)" << std::endl;
+    std::cout << "  -s <size>                 Request size in bytes (default: 256)" << std::endl;
+    std::cout << "  -c <lanes>                Concurrent outstanding requests (default: 1)" << std::endl;
+    std::cout << "  -d <duration>             Test duration in seconds (default: 10)" << std::endl;
+    std::cout << "  --timeout <ms>            Per-request timeout (default: 1000)" << std::endl;
+    std::cout << "  --host <addr>             Echo service address (default: 127.0.0.1)" << std::endl;
+    std::cout << "  -p <port>                 Echo service port (default: 7400)" << std::endl;
+    std::cout << "  --path <file>             Echo service Unix socket (default: /tmp/bridge_echo.sock)" << std::endl;
+    std::cout << "  --window <n>              Direct client in-flight window (default: lanes)" << std::endl;
+    std::cout << "  -h, --help                Show this help message" << std::endl;
+    std::cout << "\nExamples:" << std::endl;
+    std::cout << "  # Echo service behind the bridge (services: udp 127.0.0.1:7400)" << std::endl;
+    std::cout << "  " << prog_name << " --echo udp -p 7400" << std::endl;
+    std::cout << "\n  # RTT through Zenoh and the bridge with 8 queries in flight" << std::endl;
+    std::cout << "  " << prog_name << " -k benchmark/service -c 8 -s 256" << std::endl;
+    std::cout << "\n  # Same echo service without Zenoh" << std::endl;
+    std::cout << "  " << prog_name << " --direct udp -p 7400 -c 8 -s 256" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    signal(SIGINT, signalHandler);
+    signal(SIGTERM, signalHandler);
+    signal(SIGPIPE, SIG_IGN);
+
+    QueryBenchConfig config;
+    config.service.port = 7400;
+    config.service.unix_path = "/tmp/bridge_echo.sock";
+    std::string role = "query";
+    size_t window = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if ((arg == "--echo" || arg == "--direct") && i + 1 < argc) {
+            role = arg.substr(2);
+            if (!parseTransport(argv[++i], config.service.transport)) {
+                std::cerr << "Unknown transport: " << argv[i] << std::endl;
+                return 1;
+            }
+        } else if (arg == "-k" && i + 1 < argc) {
+            config.zenoh_key = argv[++i];
+        } else if (arg == "-s" && i + 1 < argc) {
+            config.message_size = std::stoul(argv[++i]);
+        } else if (arg == "-c" && i + 1 < argc) {
+            config.lanes = std::max<size_t>(std::stoul(argv[++i]), 1);
+        } else if (arg == "-d" && i + 1 < argc) {
+            config.duration_seconds = std::stoul(argv[++i]);
+        } else if (arg == "--timeout" && i + 1 < argc) {
+            config.timeout_ms = std::stoul(argv[++i]);
+        } else if (arg == "--host" && i + 1 < argc) {
+            config.service.host = argv[++i];
+        } else if (arg == "-p" && i + 1 < argc) {
+            config.service.port = std::stoi(argv[++i]);
+        } else if (arg == "--path" && i + 1 < argc) {
+            config.service.unix_path = argv[++i];
+        } else if (arg == "--window" && i + 1 < argc) {
+            window = std::stoul(argv[++i]);
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (role == "echo") {
+        EchoService echo(config.service);
+        if (!echo.start()) {
+            return 1;
+        }
+        std::cout << "Echo service on " << data_bridge::ServiceClient(config.service).describe()
+                  << ". Press Ctrl+C to stop..." << std::endl;
+        while (g_running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+        echo.stop();
+        std::cout << "Echoed: " << echo.echoed() << std::endl;
+        return 0;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Query Round-Trip Benchmark" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Request size: " << config.message_size << " bytes" << std::endl;
+    std::cout << "Lanes:        " << config.lanes << std::endl;
+    std::cout << "Duration:     " << config.duration_seconds << " seconds\n" << std::endl;
+
+    benchmark::Statistics stats;
+
+    if (role == "direct") {
+        config.service.timeout_ms = static_cast<int>(config.timeout_ms);
+        config.service.window = window > 0 ? window : config.lanes;
+        config.service.max_outstanding = config.lanes;
+        data_bridge::ServiceClient client(config.service);
+        if (!client.start()) {
+            return 1;
+        }
+
+        runLanes(config, stats, [&](size_t, const std::vector<uint8_t>& payload) {
+            std::promise<bool> done;
+            auto result = done.get_future();
+            bool queued = client.submit(payload.data(), payload.size(),
+                [&done, &payload](data_bridge::ServiceResult status, const uint8_t* data, size_t len) {
+                    done.set_value(status == data_bridge::ServiceResult::OK && len == payload.size() &&
+                                   std::memcmp(data, payload.data(), len) == 0);
+                });
+            return queued && result.get();
+        });
+        stats.printReport();
+
+        auto client_stats = client.getStats();
+        std::cout << "Client: timeouts " << client_stats.timeouts << ", disconnected " << client_stats.disconnected
+                  << ", late " << client_stats.late << std::endl;
+        client.stop();
+        return 0;
+    }
+
+    try {
+        zenoh::Config zenoh_config = zenoh::Config::create_default();
+        auto session = zenoh::Session::open(std::move(zenoh_config));
+        zenoh::KeyExpr key(config.zenoh_key);
+
+        runLanes(config, stats, [&](size_t, const std::vector<uint8_t>& payload) {
+            auto ok = std::make_shared<bool>(false);
+            auto done = std::make_shared<std::promise<void>>();
+            auto finished = done->get_future();
+
+            zenoh::Session::GetOptions options;
+            options.payload = zenoh::Bytes(payload);
+            options.timeout_ms = config.timeout_ms;
+            session.get(key, "",
+                [ok, &payload](const zenoh::Reply& reply) {
+                    if (reply.is_ok()) {
+                        *ok = reply.get_ok().get_payload().size() == payload.size();
+                    }
+                },
+                [done]() { done->set_value(); },
+                std::move(options));
+            finished.wait();
+            return *ok;
+        });
+        stats.printReport();
+    } catch (const std::exception& e) {
+        std::cerr << "Zenoh error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
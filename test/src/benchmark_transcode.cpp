@@ -0,0 +1,241 @@
+/**
+ * @file benchmark_transcode.cpp
+ * @brief Measures every transform of the bridge's transcoding stage
+ *
+ * Converts the same samples of a compiled schema between packed struct,
+ * protobuf, CDR and JSON, one run per (from, to) pair, optionally with a
+ * field projection, and reports the cost per message and the payload sizes
+ * on both sides.
+ */
+
+#include "transcoder.h"
+#include "bridge_schemas.h"
+#include <cstring>
+#include <iomanip>
+#include <random>
+
+namespace {
+
+using data_bridge::PayloadFormat;
+
+struct TranscodeBenchConfig {
+    std::string schema = "pose";
+    size_t message_count = 1000000;
+    size_t samples = 256;                 // Distinct samples cycled through
+    std::vector<std::string> fields;      // Projection, empty keeps every field
+};
+
+const PayloadFormat kFormats[] = {
+    PayloadFormat::STRUCT, PayloadFormat::PROTOBUF, PayloadFormat::CDR, PayloadFormat::JSON
+};
+
+// Packed structs with random but plausible field values
+std::vector<std::vector<uint8_t>> generateStructs(const data_bridge::SchemaDescriptor& schema, size_t count) {
+    std::mt19937_64 rng(42);
+    std::uniform_real_distribution<double> real(-100.0, 100.0);
+    std::vector<std::vector<uint8_t>> structs;
+    for (size_t n = 0; n < count; ++n) {
+        std::vector<uint8_t> bytes(schema.struct_size);
+        for (size_t i = 0; i < schema.field_count; ++i) {
+            const auto& field = schema.fields[i];
+            uint8_t* out = bytes.data() + field.offset;
+            switch (field.type) {
+                case data_bridge::FieldType::BOOL: out[0] = rng() & 1; break;
+                case data_bridge::FieldType::INT32: {
+                    int32_t v = static_cast<int32_t>(rng() % 2000) - 1000;
+                    std::memcpy(out, &v, sizeof(v));
+                    break;
+                }
+                case data_bridge::FieldType::UINT32: {
+                    uint32_t v = static_cast<uint32_t>(rng() % 100000);
+                    std::memcpy(out, &v, sizeof(v));
+                    break;
+                }
+                case data_bridge::FieldType::FLOAT: {
+                    float v = static_cast<float>(real(rng));
+                    std::memcpy(out, &v, sizeof(v));
+                    break;
+                }
+                case data_bridge::FieldType::DOUBLE: {
+                    double v = real(rng);
+                    std::memcpy(out, &v, sizeof(v));
+                    break;
+                }
+                default: {
+                    // Nanosecond timestamps
+                    uint64_t v = 1700000000000000000ull + rng() % 1000000000000ull;
+                    std::memcpy(out, &v, sizeof(v));
+                    break;
+                }
+            }
+        }
+        structs.push_back(std::move(bytes));
+    }
+    return structs;
+}
+
+std::unique_ptr<data_bridge::Transcoder> makeTranscoder(const TranscodeBenchConfig& config, PayloadFormat from,
+                                                        PayloadFormat to, bool project) {
+    data_bridge::StreamConfig stream{};
+    stream.transcode_schema = config.schema;
+    stream.transcode_from = from;
+    stream.transcode_to = to;
+    if (project) {
+        stream.transcode_fields = config.fields;
+    }
+    auto transcoder = std::make_unique<data_bridge::Transcoder>(stream);
+    if (!transcoder->init()) {
+        return nullptr;
+    }
+    return transcoder;
+}
+
+// Converts message_count samples and prints one result line
+bool runTransform(const TranscodeBenchConfig& config, data_bridge::Transcoder& transcoder,
+                  const std::vector<data_bridge::PayloadBuffer>& inputs, const std::string& name) {
+    size_t input_bytes = 0;
+    size_t output_bytes = 0;
+    uint64_t failures = 0;
+    data_bridge::PayloadBuffer out;
+
+    // Warm the buffer pool and caches
+    for (const auto& input : inputs) {
+        transcoder.transcode(input.view(), out);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < config.message_count; ++i) {
+        const auto& input = inputs[i % inputs.size()];
+        if (!transcoder.transcode(input.view(), out)) {
+            failures++;
+            continue;
+        }
+        input_bytes += input.size();
+        output_bytes += out.size();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t converted = config.message_count - failures;
+    double ns_per_msg = config.message_count > 0 ? elapsed * 1e9 / config.message_count : 0.0;
+    std::cout << std::left << std::setw(22) << name
+              << std::right << std::setw(10) << std::fixed << std::setprecision(1) << ns_per_msg << " ns/msg"
+              << std::setw(14) << std::setprecision(0) << (elapsed > 0 ? config.message_count / elapsed : 0.0)
+              << " msg/s"
+              << std::setw(8) << (converted > 0 ? input_bytes / converted : 0) << " B ->"
+              << std::setw(5) << (converted > 0 ? output_bytes / converted : 0) << " B";
+    if (failures > 0) {
+        std::cout << "  (" << failures << " failed)";
+    }
+    std::cout << std::endl;
+    return failures == 0;
+}
+
+} // namespace
+
+void printUsage(const char* prog_name) {
+    std::cout << "Usage: " << prog_name << " [options]" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --schema <name>           Compiled schema (default: pose, available: "
+              << data_bridge::schemaNames() << ")" << std::endl;
+    std::cout << "  -n, --count <num>         Messages per transform (default: 1000000)" << std::endl;
+    std::cout << "  --samples <num>           Distinct samples cycled through (default: 256)" << std::endl;
+    std::cout << "  --fields <a,b,...>        Also run every transform projected to these fields" << std::endl;
+    std::cout << "  -h, --help                Show this help message" << std::endl;
+    std::cout << "\nExamples:" << std::endl;
+    std::cout << "  # All transforms of the pose schema" << std::endl;
+    std::cout << "  " << prog_name << " --schema pose" << std::endl;
+    std::cout << "\n  # Same, plus projection to the position" << std::endl;
+    std::cout << "  " << prog_name << " --schema pose --fields stamp_ns,x,y,z" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    TranscodeBenchConfig config;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else if (arg == "--schema" && i + 1 < argc) {
+            config.schema = argv[++i];
+        } else if ((arg == "-n" || arg == "--count") && i + 1 < argc) {
+            config.message_count = std::stoul(argv[++i]);
+        } else if (arg == "--samples" && i + 1 < argc) {
+            config.samples = std::max<size_t>(std::stoul(argv[++i]), 1);
+        } else if (arg == "--fields" && i + 1 < argc) {
+            std::string list = argv[++i];
+            size_t start = 0;
+            while (start <= list.size()) {
+                size_t comma = list.find(',', start);
+                if (comma == std::string::npos) {
+                    comma = list.size();
+                }
+                if (comma > start) {
+                    config.fields.push_back(list.substr(start, comma - start));
+                }
+                start = comma + 1;
+            }
+        } else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    const auto* schema = data_bridge::findSchema(config.schema);
+    if (!schema) {
+        std::cerr << "Unknown schema '" << config.schema << "', available: " << data_bridge::schemaNames() << std::endl;
+        return 1;
+    }
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Transcoding Benchmark" << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << "Schema:   " << schema->name << " (" << schema->field_count << " fields, "
+              << schema->struct_size << " byte struct)" << std::endl;
+    std::cout << "Messages: " << config.message_count << " per transform" << std::endl;
+    std::cout << "Samples:  " << config.samples << "\n" << std::endl;
+
+    // The same samples in every format, encoded by the transcoder itself
+    auto structs = generateStructs(*schema, config.samples);
+    std::vector<std::vector<data_bridge::PayloadBuffer>> inputs(std::size(kFormats));
+    for (size_t f = 0; f < std::size(kFormats); ++f) {
+        std::unique_ptr<data_bridge::Transcoder> encoder;
+        if (kFormats[f] != PayloadFormat::STRUCT) {
+            encoder = makeTranscoder(config, PayloadFormat::STRUCT, kFormats[f], false);
+        }
+        for (const auto& bytes : structs) {
+            data_bridge::PayloadBuffer input;
+            if (encoder) {
+                encoder->transcode({bytes.data(), bytes.size()}, input);
+            } else {
+                input = data_bridge::PayloadBuffer::allocate(bytes.size());
+                std::memcpy(input.data(), bytes.data(), bytes.size());
+            }
+            inputs[f].push_back(std::move(input));
+        }
+    }
+
+    bool ok = true;
+    for (int project = 0; project <= (config.fields.empty() ? 0 : 1); ++project) {
+        if (project) {
+            std::cout << "\nProjected to " << config.fields.size() << " field(s):" << std::endl;
+        }
+        for (size_t f = 0; f < std::size(kFormats); ++f) {
+            for (size_t t = 0; t < std::size(kFormats); ++t) {
+                if (f == t && !project) {
+                    continue;
+                }
+                auto transcoder = makeTranscoder(config, kFormats[f], kFormats[t], project);
+                if (!transcoder) {
+                    return 1;
+                }
+                std::string name = std::string(data_bridge::Transcoder::formatName(kFormats[f])) + " -> " +
+                                   data_bridge::Transcoder::formatName(kFormats[t]);
+                ok = runTransform(config, *transcoder, inputs[f], name) && ok;
+            }
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file test_handoff.cpp
+ * @brief Restart handoff of UDP destination sockets, with and without MSG_ZEROCOPY
+ *
+ * Runs a predecessor and a successor bridge's destination registries in one
+ * process, hands the sockets over through a Handoff on a temporary Unix
+ * socket, and sends through both sides to a loopback receiver. Zerocopy
+ * destinations must not be taken over: the successor's sends would never
+ * match the kernel's completion ids and fall back to copying for good.
+ */
+
+#include "handoff.h"
+#include "destination_registry.h"
+#include "buffer_pool.h"
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+namespace {
+
+using data_bridge::BridgeConfig;
+using data_bridge::DestinationRegistry;
+using data_bridge::Handoff;
+using data_bridge::HandoffOffer;
+
+constexpr size_t kPayloadSize = 4096;
+constexpr size_t kMessages = 1000;      // Per side, well above the 256 outstanding zerocopy sends
+
+int g_failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        g_failures++;
+    }
+}
+
+int localPort(int fd) {
+    sockaddr_in addr{};
+    socklen_t len = sizeof(addr);
+    getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    return ntohs(addr.sin_port);
+}
+
+struct Receiver {
+    int fd = -1;
+    int port = 0;
+    size_t received = 0;
+    size_t corrupted = 0;
+
+    bool open() {
+        fd = socket(AF_INET, SOCK_DGRAM, 0);
+        int buffer = 8 << 20;
+        setsockopt(fd, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            return false;
+        }
+        port = localPort(fd);
+        return true;
+    }
+
+    // Every datagram is its index followed by the index's low byte
+    void drain() {
+        uint8_t buffer[kPayloadSize];
+        ssize_t len;
+        while ((len = recv(fd, buffer, sizeof(buffer), MSG_DONTWAIT)) > 0) {
+            received++;
+            uint32_t index;
+            std::memcpy(&index, buffer, sizeof(index));
+            bool intact = static_cast<size_t>(len) == kPayloadSize;
+            for (size_t i = sizeof(index); intact && i < kPayloadSize; ++i) {
+                intact = buffer[i] == static_cast<uint8_t>(index);
+            }
+            corrupted += intact ? 0 : 1;
+        }
+    }
+
+    ~Receiver() {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+};
+
+BridgeConfig makeConfig(int port, size_t zerocopy_threshold) {
+    BridgeConfig config;
+    config.udp_zerocopy_threshold = zerocopy_threshold;
+    config.udp_gso = false;
+    data_bridge::DestinationConfig destination;
+    destination.host = "127.0.0.1";
+    destination.port = port;
+    destination.shards = 2;
+    config.destinations.push_back(destination);
+    return config;
+}
+
+// Send kMessages pooled payloads through a destination, zerocopy when it wants to
+void sendAll(data_bridge::UdpDestination& destination, Receiver& receiver, uint32_t first_index) {
+    for (uint32_t i = 0; i < kMessages; ++i) {
+        uint32_t index = first_index + i;
+        auto payload = data_bridge::PayloadBuffer::allocate(kPayloadSize);
+        std::memcpy(payload.data(), &index, sizeof(index));
+        std::memset(payload.data() + sizeof(index), static_cast<uint8_t>(index), kPayloadSize - sizeof(index));
+
+        auto& sender = destination.sender();
+        if (!sender.sendZeroCopy(payload.data(), payload.size(), payload)) {
+            sender.send(payload.data(), payload.size());
+        }
+        if (i % 64 == 63) {
+            receiver.drain();
+        }
+    }
+    usleep(20000);
+    receiver.drain();
+}
+
+// Predecessor offers its registry's sockets, successor opens its own registry with what it received
+std::shared_ptr<data_bridge::UdpDestination> handOver(const std::string& path, DestinationRegistry& old_registry,
+                                                      DestinationRegistry& new_registry, int port,
+                                                      size_t& offered) {
+    bool released = false;
+    Handoff old_side(path);
+    old_side.listen([&]() {
+        HandoffOffer offer;
+        offer.sockets = old_registry.handoffSockets();
+        return offer;
+    }, [&]() { released = true; });
+
+    Handoff new_side(path);
+    check(new_side.receive() && new_side.tookOver(), "successor receives the offer");
+    std::string name = "udp:127.0.0.1:" + std::to_string(port);
+    auto inherited = new_side.takeSockets(name);
+    offered = inherited.size();
+    auto destination = new_registry.acquire("127.0.0.1", port, std::move(inherited));
+    check(new_side.complete(2000) && released, "predecessor releases");
+    new_side.stop();
+    old_side.stop();
+    return destination;
+}
+
+void testPlainHandoff(const std::string& path) {
+    Receiver receiver;
+    check(receiver.open(), "receiver binds");
+    DestinationRegistry old_registry(makeConfig(receiver.port, 0));
+    DestinationRegistry new_registry(makeConfig(receiver.port, 0));
+    auto old_destination = old_registry.acquire("127.0.0.1", receiver.port);
+    check(old_destination != nullptr, "predecessor opens its destination");
+
+    size_t offered = 0;
+    auto new_destination = handOver(path, old_registry, new_registry, receiver.port, offered);
+    check(offered == 2, "both shards are offered");
+    check(new_destination && localPort(new_destination->sockets()[0]) == localPort(old_destination->sockets()[0]) &&
+          localPort(new_destination->sockets()[1]) == localPort(old_destination->sockets()[1]),
+          "successor sends from the same source ports");
+
+    sendAll(*old_destination, receiver, 0);
+    sendAll(*new_destination, receiver, kMessages);
+    check(receiver.received == 2 * kMessages && receiver.corrupted == 0, "plain sends arrive intact on both sides");
+}
+
+void testZeroCopyHandoff(const std::string& path) {
+    Receiver receiver;
+    check(receiver.open(), "receiver binds");
+    DestinationRegistry old_registry(makeConfig(receiver.port, 1024));
+    DestinationRegistry new_registry(makeConfig(receiver.port, 1024));
+    auto old_destination = old_registry.acquire("127.0.0.1", receiver.port);
+    check(old_destination != nullptr, "predecessor opens its destination");
+
+    // The predecessor's sockets carry completion ids 0..kMessages-1 by now
+    sendAll(*old_destination, receiver, 0);
+    if (old_destination->getStats().zerocopy_sends == 0) {
+        std::cout << "MSG_ZEROCOPY not available, zerocopy handoff skipped" << std::endl;
+        return;
+    }
+
+    size_t offered = 0;
+    auto new_destination = handOver(path, old_registry, new_registry, receiver.port, offered);
+    check(offered == 0, "zerocopy sockets are not offered");
+    check(new_destination && localPort(new_destination->sockets()[0]) != localPort(old_destination->sockets()[0]),
+          "successor opens its own zerocopy sockets");
+
+    // Both bridges keep sending for the overlap, each reaps only its own completions
+    sendAll(*new_destination, receiver, kMessages);
+    sendAll(*old_destination, receiver, 2 * kMessages);
+    auto stats = new_destination->getStats();
+    check(stats.zerocopy_sends == kMessages && stats.zerocopy_fallbacks == 0,
+          "successor's completions match its sends (" + std::to_string(stats.zerocopy_fallbacks) + " fallbacks)");
+    check(old_destination->getStats().zerocopy_fallbacks == 0, "predecessor's completions still match");
+    check(receiver.received == 3 * kMessages && receiver.corrupted == 0, "zerocopy sends arrive intact");
+
+    // Sockets handed to a zerocopy destination anyway are not used
+    DestinationRegistry forced_registry(makeConfig(receiver.port, 1024));
+    int stale = dup(old_destination->sockets()[0]);
+    auto forced = forced_registry.acquire("127.0.0.1", receiver.port, {stale});
+    check(forced && localPort(forced->sockets()[0]) != localPort(old_destination->sockets()[0]),
+          "inherited sockets are closed for a zerocopy destination");
+}
+
+} // namespace
+
+int main() {
+    std::string path = "/tmp/data_bridge_test_handoff." + std::to_string(getpid()) + ".sock";
+    testPlainHandoff(path);
+    testZeroCopyHandoff(path);
+    unlink(path.c_str());
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Handoff tests passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,148 @@
+/**
+ * @file test_hash.cpp
+ * @brief Payload integrity checksums against the reference values
+ *
+ * Compares CRC32C and XXH3 with the instructions picked at startup against
+ * the portable implementations and against values from the reference
+ * implementations, over lengths on both sides of the XXH3 size classes
+ * (16, 128 and 240 bytes), several 1024-byte blocks and unaligned starts.
+ * A publisher and a bridge on different CPUs or build flags must agree.
+ */
+
+#include "hash.h"
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using data_bridge::crc32c;
+using data_bridge::crc32cPortable;
+using data_bridge::xxh3_64;
+using data_bridge::xxh3_64Portable;
+
+constexpr size_t kMaxLen = 5000;
+constexpr size_t kOffsets[] = {0, 1, 3, 7};
+
+// Reference values (crc32c as in RFC 3720, XXH3_64bits from xxHash) of pattern(len)
+struct Reference {
+    size_t len;
+    uint32_t crc32c;
+    uint64_t xxh3;
+};
+
+const Reference kReferences[] = {
+    {0, 0x00000000U, 0x2D06800538D394C2ULL},
+    {1, 0x86B737BAU, 0x4C5CCA45D0F4811FULL},
+    {16, 0xCF7845A4U, 0x7E484C18D74895D0ULL},
+    {17, 0x10C70233U, 0x208BDE5EE2BED407ULL},
+    {128, 0xAE5B4C7AU, 0xF92B70EAA21A6288ULL},
+    {129, 0x1E952BBBU, 0xF8F76713F2BB60FAULL},
+    {240, 0xB3F70C9FU, 0xCCC7375172C41F03ULL},
+    {241, 0x5AE1C7EAU, 0x0B3B630948CE4A00ULL},
+    {1024, 0xA5E5B4B5U, 0x23BC880EBF0D29C6ULL},
+    {1025, 0x01F6B4DBU, 0xC09FDFBC398C7D82ULL},
+    {3000, 0x9BCE8C4CU, 0x6EB4B5BFE14D9786ULL},
+    {4200, 0xED938625U, 0x196A4F6C0A8A8F9EULL},
+};
+
+int g_failures = 0;
+
+void check(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        g_failures++;
+    }
+}
+
+std::string hex(uint64_t value) {
+    std::ostringstream out;
+    out << "0x" << std::hex << std::setw(16) << std::setfill('0') << value;
+    return out.str();
+}
+
+std::string where(size_t len, size_t offset) {
+    return "len " + std::to_string(len) + " offset " + std::to_string(offset);
+}
+
+// pattern(len) placed at the given offset from a 64-byte aligned start
+const uint8_t* pattern(std::vector<uint8_t>& storage, size_t offset) {
+    auto base = reinterpret_cast<uintptr_t>(storage.data());
+    uint8_t* start = storage.data() + ((64 - base % 64) % 64) + offset;
+    for (size_t i = 0; i < kMaxLen; ++i) {
+        start[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    return start;
+}
+
+void testKnownValues() {
+    const char* digits = "123456789";
+    check(crc32c(digits, 9) == 0xE3069283U, "crc32c check value");
+    check(xxh3_64(digits, 9) == 0x72DCB18B67A17DFFULL, "xxh3 of \"123456789\"");
+
+    std::vector<uint8_t> storage(kMaxLen + 128);
+    for (size_t offset : kOffsets) {
+        const uint8_t* data = pattern(storage, offset);
+        for (const Reference& reference : kReferences) {
+            uint64_t xxh3 = xxh3_64(data, reference.len);
+            check(xxh3 == reference.xxh3,
+                  "xxh3 " + where(reference.len, offset) + ": " + hex(xxh3) + ", expected " + hex(reference.xxh3));
+            check(xxh3_64Portable(data, reference.len) == reference.xxh3,
+                  "xxh3 portable " + where(reference.len, offset));
+            check(crc32c(data, reference.len) == reference.crc32c, "crc32c " + where(reference.len, offset));
+            check(crc32cPortable(data, reference.len) == reference.crc32c,
+                  "crc32c portable " + where(reference.len, offset));
+        }
+    }
+}
+
+// Every length up to a few blocks, dispatched against portable, on data that is not a simple pattern
+void testDispatchMatchesPortable() {
+    std::vector<uint8_t> storage(kMaxLen + 128);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (uint8_t& byte : storage) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        byte = static_cast<uint8_t>(state >> 56);
+    }
+
+    for (size_t offset : kOffsets) {
+        const uint8_t* data = storage.data() + offset;
+        size_t mismatches = 0;
+        for (size_t len = 0; len < kMaxLen; ++len) {
+            if (xxh3_64(data, len) != xxh3_64Portable(data, len)) {
+                if (mismatches++ == 0) {
+                    check(false, "xxh3 dispatched vs portable, first at " + where(len, offset));
+                }
+            }
+            if (crc32c(data, len) != crc32cPortable(data, len)) {
+                if (mismatches++ == 0) {
+                    check(false, "crc32c dispatched vs portable, first at " + where(len, offset));
+                }
+            }
+        }
+        if (mismatches > 0) {
+            std::cerr << "  " << mismatches << " mismatch(es) at offset " << offset << std::endl;
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    std::cout << "CRC32C: " << data_bridge::crc32cImplementation()
+              << ", XXH3: " << data_bridge::xxh3Implementation() << std::endl;
+
+    testKnownValues();
+    testDispatchMatchesPortable();
+
+    if (g_failures > 0) {
+        std::cerr << g_failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Hash tests passed" << std::endl;
+    return 0;
+}